@@ -150,12 +150,14 @@ static void compress_help_display(void)
 	fprintf(stdout, "\n");
 	fprintf(stdout, "[-a|-out_dir] <output directory>\n");
 	fprintf(stdout, "    Output directory where compressed files are stored.\n");
-	fprintf(stdout, "[-A|-rate_control_algorithm] <0|1>\n");
+	fprintf(stdout, "[-A|-rate_control_algorithm] <0|1|2>\n");
 	fprintf(stdout, "    Select algorithm used for rate control\n");
 	fprintf(stdout, "    0: Bisection search for optimal threshold using all code passes in code "
 					"blocks. (default) (slightly higher PSRN than algorithm 1)\n");
 	fprintf(stdout, "    1: Bisection search for optimal threshold using only feasible truncation "
 					"points, on convex hull.\n");
+	fprintf(stdout, "    2: As 1, but with one threshold per layer for all tiles, so that bytes "
+					"are allocated across the whole image rather than per tile.\n");
 	fprintf(stdout, "[-b|-code_block_dims] <cblk width>,<cblk height>\n");
 	fprintf(stdout, "    Code-block dimensions. The dimensions must respect the constraint \n");
 	fprintf(stdout, "    defined in the JPEG 2000 standard: no dimension smaller than 4 \n");
@@ -801,7 +803,7 @@ int GrkCompress::parseCommandLine(int argc, char** argv, CompressInitParams* ini
 		if(rateControlAlgoArg.isSet())
 		{
 			uint32_t algo = rateControlAlgoArg.getValue();
-			if(algo > GRK_RATE_CONTROL_PCRD_OPT)
+			if(algo > GRK_RATE_CONTROL_PCRD_OPT_IMAGE)
 				spdlog::warn("Rate control algorithm %u is not valid. Using default");
 			else
 				parameters->rateControlAlgorithm =
@@ -163,6 +163,10 @@ static void decompress_help_display(void)
 					"    Set the maximum number of quality layers to decompress. If there are\n"
 					"    fewer quality layers than the specified number, all the quality layers\n"
 					"    are decompressed.\n");
+	fprintf(stdout, "  [-B | -band_height] <band height>\n"
+					"    Decompress a single-tile image in horizontal bands of this height,\n"
+					"    to bound memory usage. Only applies to single component TIF and PGM\n"
+					"    output.\n");
 	fprintf(stdout, "  [-p | -precision] <comp 0 precision>[C|S][,<comp 1 precision>[C|S][,...]]\n"
 					"    OPTIONAL\n"
 					"    Force the precision (bit depth) of components.\n");
@@ -394,6 +398,8 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 
 		TCLAP::ValueArg<std::string> outDirArg("a", "out_dir", "Output Directory", false, "",
 											   "string", cmd);
+		TCLAP::ValueArg<uint32_t> bandHeightArg("B", "band_height", "Streaming band height", false,
+												0, "unsigned integer", cmd);
 		TCLAP::ValueArg<std::string> compressionArg("c", "compression", "compression Type", false,
 													"", "string", cmd);
 		TCLAP::ValueArg<std::string> decodeRegionArg("d", "region", "Decompress Region", false, "",
@@ -417,6 +423,9 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 												  "Toggle support for random access"
 												  " into code stream",
 												  false, 0, "unsigned integer", cmd);
+		TCLAP::ValueArg<uint32_t> memoryFlagsArg("M", "memory_flags",
+												 "Huge page and NUMA flags for large buffers",
+												 false, 0, "unsigned integer", cmd);
 		// Kernel build flags:
 		// 1 indicates build binary, otherwise load binary
 		// 2 indicates generate binaries
@@ -645,6 +654,8 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 			parameters->core.layers_to_decompress_ = layerArg.getValue();
 		if(randomAccessArg.isSet())
 			parameters->core.randomAccessFlags_ = randomAccessArg.getValue();
+		if(bandHeightArg.isSet())
+			parameters->core.streamingBandHeight = bandHeightArg.getValue();
 		parameters->singleTileDecompress = tileArg.isSet();
 		if(tileArg.isSet())
 			parameters->tileIndex = (uint16_t)tileArg.getValue();
@@ -652,6 +663,8 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 			return 1;
 		if(numThreadsArg.isSet())
 			parameters->numThreads = numThreadsArg.getValue();
+		if(memoryFlagsArg.isSet())
+			parameters->memoryFlags = memoryFlagsArg.getValue();
 		if(decodeRegionArg.isSet())
 		{
 			size_t size_optarg = (size_t)strlen(decodeRegionArg.getValue().c_str()) + 1U;
@@ -815,6 +828,7 @@ int GrkDecompress::pluginMain(int argc, char** argv, DecompressInitParams* initP
 	// loads plugin but does not actually create codec
 	grk_initialize(initParams->pluginPath, initParams->parameters.numThreads,
 				   initParams->parameters.verbose_);
+	grk_set_memory_flags(initParams->parameters.memoryFlags);
 
 	// create codec
 	grk_plugin_init_info initInfo;
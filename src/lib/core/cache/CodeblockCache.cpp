@@ -0,0 +1,147 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <grk_includes.h>
+
+namespace grk
+{
+CodeblockCacheEntry::CodeblockCacheEntry(uint64_t tag, uint32_t width, uint32_t height)
+	: tag_(tag), data_(new int32_t[(size_t)width * height]), width_(width), height_(height)
+{}
+CodeblockCacheEntry::~CodeblockCacheEntry()
+{
+	delete[] data_;
+}
+uint64_t CodeblockCacheEntry::bytes(void) const
+{
+	return (uint64_t)width_ * height_ * sizeof(int32_t) + state_.size();
+}
+CodeblockCache::CodeblockCache() : maxBytes_(0), bytes_(0) {}
+CodeblockCache::~CodeblockCache()
+{
+	clear();
+}
+void CodeblockCache::init(uint64_t maxBytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	maxBytes_ = maxBytes;
+	while(bytes_ > maxBytes_)
+		evict();
+}
+bool CodeblockCache::enabled(void) const
+{
+	return maxBytes_ != 0;
+}
+void CodeblockCache::clear(void)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	for(const auto& entry : cache_)
+		delete entry.second;
+	cache_.clear();
+	lru_.clear();
+	bytes_ = 0;
+}
+bool CodeblockCache::get(const CodeblockCacheKey& key, uint64_t tag, int32_t* dest,
+						 uint32_t width, uint32_t height, uint32_t stride)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto iter = cache_.find(key);
+	if(iter == cache_.end())
+		return false;
+	auto entry = iter->second;
+	if(entry->tag_ != tag || entry->width_ != width || entry->height_ != height)
+		return false;
+	if(stride == width)
+	{
+		memcpy(dest, entry->data_, (size_t)width * height * sizeof(int32_t));
+	}
+	else
+	{
+		for(uint32_t j = 0; j < height; ++j)
+			memcpy(dest + (size_t)j * stride, entry->data_ + (size_t)j * width,
+				   width * sizeof(int32_t));
+	}
+	lru_.splice(lru_.begin(), lru_, entry->lruPosition_);
+
+	return true;
+}
+bool CodeblockCache::getResumable(const CodeblockCacheKey& key, int32_t* dest, uint32_t width,
+								  uint32_t height, uint32_t stride, std::vector<uint8_t>& state)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto iter = cache_.find(key);
+	if(iter == cache_.end())
+		return false;
+	auto entry = iter->second;
+	if(entry->state_.empty() || entry->width_ != width || entry->height_ != height)
+		return false;
+	for(uint32_t j = 0; j < height; ++j)
+		memcpy(dest + (size_t)j * stride, entry->data_ + (size_t)j * width,
+			   width * sizeof(int32_t));
+	state = entry->state_;
+	lru_.splice(lru_.begin(), lru_, entry->lruPosition_);
+
+	return true;
+}
+void CodeblockCache::put(const CodeblockCacheKey& key, uint64_t tag, const int32_t* src,
+						 uint32_t width, uint32_t height, uint32_t stride,
+						 std::vector<uint8_t>* state)
+{
+	uint64_t stateBytes = state ? state->size() : 0;
+	if((uint64_t)width * height * sizeof(int32_t) + stateBytes > maxBytes_)
+		return;
+	auto entry = new CodeblockCacheEntry(tag, width, height);
+	if(state)
+		entry->state_.swap(*state);
+	if(stride == width)
+	{
+		memcpy(entry->data_, src, (size_t)width * height * sizeof(int32_t));
+	}
+	else
+	{
+		for(uint32_t j = 0; j < height; ++j)
+			memcpy(entry->data_ + (size_t)j * width, src + (size_t)j * stride,
+				   width * sizeof(int32_t));
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto iter = cache_.find(key);
+	if(iter != cache_.end())
+	{
+		lru_.erase(iter->second->lruPosition_);
+		bytes_ -= iter->second->bytes();
+		delete iter->second;
+		cache_.erase(iter);
+	}
+	lru_.push_front(key);
+	entry->lruPosition_ = lru_.begin();
+	cache_[key] = entry;
+	bytes_ += entry->bytes();
+	while(bytes_ > maxBytes_)
+		evict();
+}
+void CodeblockCache::evict(void)
+{
+	assert(!lru_.empty());
+	auto iter = cache_.find(lru_.back());
+	assert(iter != cache_.end());
+	bytes_ -= iter->second->bytes();
+	delete iter->second;
+	cache_.erase(iter);
+	lru_.pop_back();
+}
+
+} // namespace grk
@@ -0,0 +1,163 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <tuple>
+
+namespace grk
+{
+/**
+ * Identifies a code block within the code stream.
+ * Code block origin is in band canvas coordinates, which do not depend on
+ * the decompress window.
+ */
+struct CodeblockCacheKey
+{
+	/**
+	 * Key for a reconstructed (inverse transformed) tile component resolution
+	 *
+	 * @param tileIndex tile index
+	 * @param compno component number
+	 * @param resno resolution number
+	 */
+	static CodeblockCacheKey resolution(uint16_t tileIndex, uint16_t compno, uint8_t resno)
+	{
+		return CodeblockCacheKey(tileIndex, compno, resno, resolutionOrientation, 0, 0);
+	}
+	static constexpr uint8_t resolutionOrientation = 0xFF;
+
+	CodeblockCacheKey(uint16_t tileIndex, uint16_t compno, uint8_t resno, uint8_t orientation,
+					  uint32_t x0, uint32_t y0)
+		: tileIndex_(tileIndex), compno_(compno), resno_(resno), orientation_(orientation), x0_(x0),
+		  y0_(y0)
+	{}
+	bool operator<(const CodeblockCacheKey& rhs) const
+	{
+		return std::tie(tileIndex_, compno_, resno_, orientation_, y0_, x0_) <
+			   std::tie(rhs.tileIndex_, rhs.compno_, rhs.resno_, rhs.orientation_, rhs.y0_,
+						rhs.x0_);
+	}
+	uint16_t tileIndex_;
+	uint16_t compno_;
+	uint8_t resno_;
+	uint8_t orientation_;
+	uint32_t x0_;
+	uint32_t y0_;
+};
+
+struct CodeblockCacheEntry
+{
+	CodeblockCacheEntry(uint64_t tag, uint32_t width, uint32_t height);
+	~CodeblockCacheEntry();
+	uint64_t bytes(void) const;
+
+	// identifies the compressed data that the coefficients were decoded from
+	uint64_t tag_;
+	int32_t* data_;
+	uint32_t width_;
+	uint32_t height_;
+	// optional T1 decoder state after the final decoded coding pass
+	std::vector<uint8_t> state_;
+	// position in LRU list (most recently used at front)
+	std::list<CodeblockCacheKey>::iterator lruPosition_;
+};
+
+/**
+ * Byte-budgeted cache of T1-decoded code block coefficients, taken before
+ * dequantization and ROI shift. Successive decompress windows on the same codec
+ * only need to run T1 on code blocks that were not decoded for a previous window.
+ *
+ * The cache also holds reconstructed tile component resolutions, so that
+ * decompressing at a lower resolution reduction only needs to decode
+ * the new resolutions and run the remaining inverse wavelet levels.
+ *
+ * Each entry is tagged with the amount of compressed data it was decoded from,
+ * so that entries become stale when more quality layers are decompressed.
+ * Entries may also hold the T1 decoder state, so that decompression of more layers
+ * only needs to decode the new coding passes.
+ */
+class CodeblockCache
+{
+  public:
+	CodeblockCache(void);
+	virtual ~CodeblockCache();
+
+	/**
+	 * Set byte budget. A budget of zero disables the cache.
+	 *
+	 * @param maxBytes maximum number of bytes of cached coefficients
+	 */
+	void init(uint64_t maxBytes);
+	bool enabled(void) const;
+	void clear(void);
+	/**
+	 * Copy cached coefficients to destination, and mark code block as most recently used
+	 *
+	 * @param key code block key
+	 * @param tag tag of current compressed data
+	 * @param dest destination buffer
+	 * @param width code block width
+	 * @param height code block height
+	 * @param stride destination stride
+	 *
+	 * @return true if code block was found in cache, with matching tag
+	 */
+	bool get(const CodeblockCacheKey& key, uint64_t tag, int32_t* dest, uint32_t width,
+			 uint32_t height, uint32_t stride);
+	/**
+	 * Copy cached coefficients and decoder state to destination, regardless of tag,
+	 * and mark code block as most recently used
+	 *
+	 * @param key code block key
+	 * @param dest destination buffer
+	 * @param width code block width
+	 * @param height code block height
+	 * @param stride destination stride
+	 * @param state destination decoder state
+	 *
+	 * @return true if code block was found in cache, with decoder state
+	 */
+	bool getResumable(const CodeblockCacheKey& key, int32_t* dest, uint32_t width,
+					  uint32_t height, uint32_t stride, std::vector<uint8_t>& state);
+	/**
+	 * Cache coefficients, evicting least recently used code blocks
+	 * if cache exceeds its byte budget
+	 *
+	 * @param key code block key
+	 * @param tag tag of compressed data
+	 * @param src source buffer
+	 * @param width code block width
+	 * @param height code block height
+	 * @param stride source stride
+	 * @param state optional decoder state
+	 */
+	void put(const CodeblockCacheKey& key, uint64_t tag, const int32_t* src, uint32_t width,
+			 uint32_t height, uint32_t stride, std::vector<uint8_t>* state = nullptr);
+
+  private:
+	void evict(void);
+	std::map<CodeblockCacheKey, CodeblockCacheEntry*> cache_;
+	std::list<CodeblockCacheKey> lru_;
+	uint64_t maxBytes_;
+	uint64_t bytes_;
+	std::mutex mutex_;
+};
+
+} // namespace grk
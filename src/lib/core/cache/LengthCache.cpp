@@ -102,7 +102,11 @@ bool TileInfo::update(uint16_t tileIndex, uint8_t currentTilePart, uint8_t numTi
 			allocatedTileParts *= 2;
 		}
 	}
-	tilePartInfo[currentTilePart] = TilePartInfo(tileIndex, currentTilePart, numTileParts);
+	// tile part positions are filled in as the tile part is parsed
+	tilePartInfo[currentTilePart] = TilePartInfo();
+	this->currentTilePart = currentTilePart;
+	if(numTileParts)
+		this->numTileParts = numTileParts;
 
 	return true;
 }
@@ -212,8 +216,12 @@ bool CodeStreamInfo::seekFirstTilePart(uint16_t tileIndex)
 	if(!hasVeryFirstTilePartInfo)
 		return true;
 
+	// start of tile is not known yet, so parse forward from current position
+	// (a tile part can never start at position zero, which holds the SOC marker)
 	auto tileInfoForTile = getTileInfo(tileIndex);
-	assert(tileInfoForTile && tileInfoForTile->numTileParts);
+	if(!tileInfoForTile || !tileInfoForTile->hasTilePartInfo() ||
+	   !tileInfoForTile->getTilePartInfo(0)->startPosition)
+		return true;
 	// move just past SOT marker of first tile part for this tile
 	if(!(stream->seek(tileInfoForTile->getTilePartInfo(0)->startPosition + MARKER_BYTES)))
 	{
@@ -229,8 +237,8 @@ TilePartLengthInfo::TilePartLengthInfo(uint16_t tileno, uint32_t len)
 {}
 TileLengthMarkers::TileLengthMarkers(uint16_t numSignalledTiles)
 	: markers_(new TL_MAP()), markerIt_(markers_->end()), markerTilePartIndex_(0),
-	  curr_vec_(nullptr), stream_(nullptr), streamStart(0), valid_(true), hasTileIndices_(false),
-	  tileCount_(0), numSignalledTiles_(numSignalledTiles)
+	  curr_vec_(nullptr), stream_(nullptr), streamStart(0), valid_(true), prefetched_(false),
+	  hasTileIndices_(false), tileCount_(0), numSignalledTiles_(numSignalledTiles)
 {}
 TileLengthMarkers::TileLengthMarkers(BufferedStream* stream) : TileLengthMarkers(USHRT_MAX)
 {
@@ -376,6 +384,7 @@ void TileLengthMarkers::push(uint8_t i_TLM, TilePartLengthInfo info)
 }
 void TileLengthMarkers::rewind(void)
 {
+	prefetched_ = false;
 	markerTilePartIndex_ = 0;
 	curr_vec_ = nullptr;
 	if(markers_)
@@ -470,6 +479,47 @@ void TileLengthMarkers::seek(TileSet* tilesToDecompress, CodingParams* cp, Buffe
 		throw CorruptTLMException();
 }
 
+void TileLengthMarkers::prefetch(TileSet* tilesToDecompress, BufferedStream* stream)
+{
+	assert(stream);
+	if(prefetched_ || !valid_ || !stream->hasPrefetch() || stream->tell() < MARKER_BYTES)
+		return;
+	prefetched_ = true;
+	auto markerIt = markerIt_;
+	auto markerTilePartIndex = markerTilePartIndex_;
+	auto currVec = curr_vec_;
+	uint64_t position = stream->tell() - MARKER_BYTES;
+	uint64_t rangeStart = position;
+	uint64_t rangeLength = 0;
+	try
+	{
+		for(auto tilePart = next(false); tilePart && tilePart->length_; tilePart = next(false))
+		{
+			if(tilesToDecompress->isScheduled(tilePart->tileIndex_))
+			{
+				if(!rangeLength)
+					rangeStart = position;
+				rangeLength += tilePart->length_;
+			}
+			else if(rangeLength)
+			{
+				stream->prefetch(rangeStart, rangeLength);
+				rangeLength = 0;
+			}
+			position += tilePart->length_;
+		}
+	}
+	catch([[maybe_unused]] const CorruptTLMException& cte)
+	{
+		// corruption is reported when tile parts are actually read
+	}
+	if(rangeLength)
+		stream->prefetch(rangeStart, rangeLength);
+	markerIt_ = markerIt;
+	markerTilePartIndex_ = markerTilePartIndex;
+	curr_vec_ = currVec;
+}
+
 bool TileLengthMarkers::writeBegin(uint16_t numTilePartsTotal)
 {
 	streamStart = stream_->tell();
@@ -116,6 +116,16 @@ struct TileLengthMarkers
 	void invalidate(void);
 	bool valid(void);
 	void seek(TileSet* tilesToDecompress, CodingParams* cp, BufferedStream* stream);
+	/**
+	 * Issue read-ahead for all remaining tile parts of scheduled tiles, once per rewind,
+	 * so that I/O for later tile parts overlaps with parsing and decompression of earlier ones.
+	 * Adjacent tile parts are coalesced into a single request.
+	 * Current TLM entry and stream position are not changed.
+	 *
+	 * @param tilesToDecompress scheduled tiles
+	 * @param stream stream positioned at current TLM entry's tile part, after SOT marker
+	 */
+	void prefetch(TileSet* tilesToDecompress, BufferedStream* stream);
 	bool writeBegin(uint16_t numTilePartsTotal);
 	void push(uint16_t tileIndex, uint32_t tile_part_size);
 	bool writeEnd(void);
@@ -139,6 +149,8 @@ struct TileLengthMarkers
 	BufferedStream* stream_;
 	uint64_t streamStart;
 	bool valid_;
+	// read-ahead has been issued since last rewind
+	bool prefetched_;
 	bool hasTileIndices_;
 	// used to track tile index when there are no tile indices
 	// stored in markers
@@ -24,6 +24,16 @@
 #ifdef _WIN32
 #include <malloc.h>
 #endif
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+#endif
+#include <atomic>
 
 #ifndef SIZE_MAX
 #define SIZE_MAX ((size_t)-1)
@@ -73,8 +83,50 @@ void* grk_calloc(size_t num, size_t size)
 
 	return calloc(num, size);
 }
+static std::atomic<uint32_t> grk_allocation_flags(0);
+// allocations at least this large are eligible for huge pages and NUMA interleaving
+const size_t grk_huge_page_size = 2 * 1024 * 1024;
+void grk_set_allocation_flags(uint32_t flags)
+{
+	grk_allocation_flags.store(flags, std::memory_order_relaxed);
+}
+#ifdef __linux__
+static void* grk_aligned_alloc_large(size_t size, uint32_t flags)
+{
+	// whole huge pages are allocated, so that policies apply to the full length
+	size = ((size + grk_huge_page_size - 1) / grk_huge_page_size) * grk_huge_page_size;
+	auto ptr = grk_aligned_alloc_N(grk_huge_page_size, size);
+	if(!ptr)
+		return nullptr;
+	// policies only apply to pages that have not yet been touched
+	// warn once per policy, as the same failure would repeat for every buffer
+	static std::atomic<bool> hugePageWarning(false);
+	static std::atomic<bool> interleaveWarning(false);
+	if((flags & GRK_MEMORY_HUGE_PAGES) && madvise(ptr, size, MADV_HUGEPAGE) != 0 &&
+	   !hugePageWarning.exchange(true))
+		Logger::logger_.warn("Unable to enable huge pages for %zu byte buffer: %s", size,
+							 strerror(errno));
+	if(flags & GRK_MEMORY_NUMA_INTERLEAVE)
+	{
+		// kernel restricts the mask to nodes with memory
+		unsigned long nodeMask[16];
+		memset(nodeMask, 0xFF, sizeof(nodeMask));
+		if(syscall(SYS_mbind, ptr, size, MPOL_INTERLEAVE, nodeMask, sizeof(nodeMask) * 8, 0) != 0 &&
+		   !interleaveWarning.exchange(true))
+			Logger::logger_.warn("Unable to interleave %zu byte buffer across NUMA nodes: %s",
+								 size, strerror(errno));
+	}
+
+	return ptr;
+}
+#endif
 void* grk_aligned_malloc(size_t size)
 {
+#ifdef __linux__
+	auto flags = grk_allocation_flags.load(std::memory_order_relaxed);
+	if(flags && size >= grk_huge_page_size)
+		return grk_aligned_alloc_large(size, flags);
+#endif
 	return grk_aligned_alloc_N(grk_buffer_alignment, size);
 }
 void grk_aligned_free(void* ptr)
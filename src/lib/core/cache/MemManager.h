@@ -46,6 +46,11 @@ void* grk_calloc(size_t numOfElements, size_t sizeOfElements);
  @return a void pointer to the allocated space, or nullptr if there is insufficient memory available
  */
 void* grk_aligned_malloc(size_t size);
+/**
+ Set flags for large aligned allocations
+ @param flags combination of GRK_MEMORY_* flags
+ */
+void grk_set_allocation_flags(uint32_t flags);
 void grk_aligned_free(void* ptr);
 /**
  Reallocate memory blocks.
@@ -18,7 +18,7 @@
 
 namespace grk
 {
-PLCache::PLCache(CodingParams* cp) : pltMarkers(nullptr), cp_(cp) {}
+PLCache::PLCache(CodingParams* cp) : pltMarkers(nullptr), recording_(false), cp_(cp) {}
 PLCache::~PLCache()
 {
 	delete pltMarkers;
@@ -41,6 +41,8 @@ void PLCache::deleteMarkers(void)
 {
 	delete pltMarkers;
 	pltMarkers = nullptr;
+	recording_ = false;
+	recorded_.clear();
 }
 
 bool PLCache::next(PacketInfo** p)
@@ -81,4 +83,58 @@ void PLCache::rewind(void)
 		pltMarkers->rewind();
 }
 
+void PLCache::beginRecording(void)
+{
+	recording_ = !pltMarkers && !cp_->plm_markers;
+	recorded_.clear();
+}
+
+bool PLCache::isRecording(void)
+{
+	return recording_;
+}
+
+void PLCache::record(uint32_t packetLength)
+{
+	if(!recording_)
+		return;
+	// comma code, as in PLT marker
+	uint8_t temp[5];
+	int32_t counter = 4;
+	temp[counter--] = (uint8_t)(packetLength & 0x7F);
+	packetLength >>= 7;
+	while(packetLength)
+	{
+		temp[counter--] = (uint8_t)((packetLength & 0x7F) | 0x80);
+		packetLength >>= 7;
+	}
+	recorded_.insert(recorded_.end(), temp + counter + 1, temp + 5);
+}
+
+void PLCache::endRecording(bool complete)
+{
+	if(!recording_)
+		return;
+	recording_ = false;
+	bool rc = true;
+	if(complete && !recorded_.empty())
+	{
+		// store recorded lengths as a sequence of PLT marker segments
+		const size_t maxSegmentLength = USHRT_MAX - 4;
+		std::vector<uint8_t> segment(maxSegmentLength + 1);
+		auto markers = createMarkers(nullptr);
+		for(size_t i = 0, offset = 0; offset < recorded_.size() && rc; ++i)
+		{
+			auto len = std::min<size_t>(maxSegmentLength, recorded_.size() - offset);
+			segment[0] = (uint8_t)(i & 0xFF);
+			memcpy(segment.data() + 1, recorded_.data() + offset, len);
+			rc = markers->readPLT(segment.data(), (uint16_t)(len + 1));
+			offset += len;
+		}
+		if(!rc)
+			deleteMarkers();
+	}
+	recorded_ = std::vector<uint8_t>();
+}
+
 } // namespace grk
@@ -33,8 +33,24 @@ class PLCache
 	bool next(PacketInfo** p);
 	void rewind(void);
 
+	/**
+	 * Records packet lengths parsed by the next T2 pass, if the tile has no
+	 * PLT markers. Later passes then skip packets without parsing their headers.
+	 */
+	void beginRecording(void);
+	void record(uint32_t packetLength);
+	bool isRecording(void);
+	/**
+	 * Ends recording : recorded lengths are only used if all packets were parsed
+	 *
+	 * @param complete true if T2 parsed all packets of the tile
+	 */
+	void endRecording(bool complete);
+
   private:
 	PLMarkerMgr* pltMarkers;
+	bool recording_;
+	std::vector<uint8_t> recorded_;
 #ifdef ENABLE_PACKET_CACHE
 	SequentialPtrCache<PacketInfo> packetInfoCache;
 #endif
@@ -351,8 +351,17 @@ void PLMarkerMgr::rewind(void)
 {
 	if(!rawMarkers_->empty())
 	{
+		// markers may be read more than once, for example when a tile
+		// is decompressed as a sequence of regions
+		for(auto it = rawMarkers_->begin(); it != rawMarkers_->end(); ++it)
+		{
+			for(auto b : *it->second)
+				b->offset = 0;
+		}
 		currMarkerIter_ = rawMarkers_->begin();
+		currMarkerBufIndex_ = 0;
 		currMarkerBuf_ = currMarkerIter_->second->front();
+		packetLen_ = 0;
 	}
 }
 
@@ -1,4 +1,5 @@
 #include "grk_includes.h"
+#include <bit>
 
 const bool grokNewIO = false;
 
@@ -13,6 +14,86 @@ static bool grkReclaimCallback(uint32_t threadId, grk_io_buf buffer, void* io_us
 	return true;
 }
 
+BufPool::BufPool(void) : returned_(nullptr)
+{
+	for(auto& f : free_)
+		f = nullptr;
+}
+BufPool::~BufPool(void)
+{
+	drainReturned();
+	for(auto& f : free_)
+	{
+		while(f)
+		{
+			auto next = f->next;
+			grk_aligned_free(f);
+			f = next;
+		}
+	}
+}
+uint8_t BufPool::sizeClass(size_t len)
+{
+	if(len <= minClassSize)
+		return 0;
+	// 2^e <= len - 1 < 2^(e+1), with e >= 6
+	auto e = (uint32_t)std::bit_width(len - 1) - 1;
+	// classes (5,6,7,8) * 2^(e-2) cover (2^e, 2^(e+1)]
+	auto sub = (uint32_t)((len - 1) >> (e - 2)) - 4;
+
+	return (uint8_t)(4 * (e - 6) + sub + 1);
+}
+size_t BufPool::classSize(uint8_t sizeClass)
+{
+	return (size_t)(4 + (sizeClass & 3)) << ((sizeClass >> 2) + 4);
+}
+void BufPool::drainReturned(void)
+{
+	auto node = returned_.exchange(nullptr, std::memory_order_acquire);
+	while(node)
+	{
+		auto next = node->next;
+		auto c = sizeClass(node->allocLen);
+		assert(classSize(c) == node->allocLen);
+		node->next = free_[c];
+		free_[c] = node;
+		node = next;
+	}
+}
+GrkIOBuf BufPool::get(size_t len)
+{
+	drainReturned();
+	if(len > classSize(numSizeClasses - 1))
+	{
+		Logger::logger_.error("Unable to allocate interleave buffer of %" PRIu64 " bytes",
+							  (uint64_t)len);
+		return GrkIOBuf();
+	}
+	auto c = sizeClass(len);
+	auto allocLen = classSize(c);
+	auto node = free_[c];
+	if(node)
+	{
+		free_[c] = node->next;
+		return GrkIOBuf((uint8_t*)node, 0, len, allocLen, false, 0);
+	}
+	GrkIOBuf rc;
+	if(rc.alloc(allocLen))
+		rc.len_ = len;
+
+	return rc;
+}
+void BufPool::put(GrkIOBuf b)
+{
+	assert(b.data_);
+	assert(b.allocLen_ >= sizeof(FreeNode));
+	auto node = (FreeNode*)b.data_;
+	node->allocLen = b.allocLen_;
+	node->next = returned_.load(std::memory_order_relaxed);
+	while(!returned_.compare_exchange_weak(node->next, node, std::memory_order_release,
+										   std::memory_order_relaxed))
+		;
+}
 Strip::Strip(GrkImage* outputImage, uint16_t index, uint32_t nominalHeight, uint8_t reduce)
 	: stripImg(new GrkImage()), tileCounter(0), reduce_(reduce), allocatedInterleaved_(false)
 {
@@ -21,7 +102,7 @@ Strip::Strip(GrkImage* outputImage, uint16_t index, uint32_t nominalHeight, uint
 	stripImg->y0 = outputImage->y0 + index * nominalHeight;
 	stripImg->y1 = std::min<uint32_t>(outputImage->y1, stripImg->y0 + nominalHeight);
 	stripImg->comps->y0 = reduceDim(stripImg->y0);
-	stripImg->comps->h = reduceDim(stripImg->y1 - stripImg->y0);
+	stripImg->comps->h = reduceDim(stripImg->y1) - stripImg->comps->y0;
 }
 Strip::~Strip(void)
 {
@@ -43,16 +124,10 @@ bool Strip::allocInterleavedLocked(uint64_t len, BufPool* pool)
 
 	return stripImg->interleavedData.data_;
 }
-bool Strip::allocInterleaved(uint64_t len, BufPool* pool)
-{
-	stripImg->interleavedData = pool->get(len);
-
-	return stripImg->interleavedData.data_;
-}
 StripCache::StripCache()
 	: strips(nullptr), numTiles_(0), numStrips_(0), nominalStripHeight_(0), imageY0_(0),
-	  packedRowBytes_(0), ioUserData_(nullptr), ioBufferCallback_(nullptr), initialized_(false),
-	  multiTile_(true)
+	  packedRowBytes_(0), reduce_(0), packer_(0), ioUserData_(nullptr), ioBufferCallback_(nullptr),
+	  initialized_(false), multiTile_(true)
 {}
 StripCache::~StripCache()
 {
@@ -73,12 +148,13 @@ bool StripCache::isMultiTile(void)
 void StripCache::init(uint32_t concurrency, uint16_t numTiles, uint32_t numStrips,
 					  uint32_t nominalStripHeight, uint8_t reduce, GrkImage* outputImage,
 					  grk_io_pixels_callback ioBufferCallback, void* ioUserData,
-					  grk_io_register_reclaim_callback registerGrkReclaimCallback)
+					  grk_io_register_reclaim_callback registerGrkReclaimCallback,
+					  bool ingestImages)
 {
 	assert(outputImage);
 	if(!numStrips || !outputImage)
 		return;
-	multiTile_ = outputImage->hasMultipleTiles;
+	multiTile_ = ingestImages;
 	ioBufferCallback_ = ioBufferCallback;
 	ioUserData_ = ioUserData;
 	grk_io_init io_init;
@@ -93,38 +169,93 @@ void StripCache::init(uint32_t concurrency, uint16_t numTiles, uint32_t numStrip
 	imageY0_ = outputImage->y0;
 	nominalStripHeight_ = nominalStripHeight;
 	packedRowBytes_ = outputImage->packedRowBytes;
+	reduce_ = reduce;
+	switch(outputImage->decompressFormat)
+	{
+		case GRK_FMT_TIF:
+			packer_ = outputImage->comps->prec;
+			break;
+		case GRK_FMT_PXM:
+			packer_ = outputImage->comps->prec > 8 ? packer16BitBE : 8;
+			break;
+		default:
+			packer_ = 0;
+			break;
+	}
 	strips = new Strip*[numStrips];
 	for(uint16_t i = 0; i < numStrips_; ++i)
 		strips[i] = new Strip(outputImage, i, nominalStripHeight_, reduce);
 	initialized_ = true;
-	for(uint32_t i = 0; i < concurrency; ++i)
+	// one pool per worker, plus one for the calling thread, which is not a worker
+	for(uint32_t i = 0; i < concurrency + 1; ++i)
 		pools_.push_back(new BufPool());
 }
+BufPool* StripCache::getPool(uint32_t threadId)
+{
+	return pools_[std::min<size_t>(threadId, pools_.size() - 1)];
+}
 bool StripCache::ingestStrip(uint32_t threadId, Tile* src, uint32_t yBegin, uint32_t yEnd)
+{
+	GrkIOBuf buf;
+	if(!getStripBuffer(threadId, yBegin, yEnd, buf))
+		return false;
+	auto dest = strips[buf.index_]->stripImg;
+	dest->interleavedData = buf;
+	bool rc = dest->compositeInterleaved(src, yBegin, yEnd);
+	dest->interleavedData.data_ = nullptr;
+	if(!rc)
+	{
+		getPool(threadId)->put(buf);
+		return false;
+	}
+
+	return ingestStrip(threadId, buf);
+}
+bool StripCache::getStripBuffer(uint32_t threadId, uint32_t yBegin, uint32_t yEnd, GrkIOBuf& buf)
 {
 	if(!initialized_)
 		return false;
 
-	uint16_t stripId = (uint16_t)((yBegin + nominalStripHeight_ - 1) / nominalStripHeight_);
+	// nominal strip height is in reference grid rows, while yBegin is in reduced rows
+	uint16_t stripId = (uint16_t)(yBegin / (nominalStripHeight_ >> reduce_));
 	assert(stripId < numStrips_);
-	auto strip = strips[stripId];
-	auto dest = strip->stripImg;
 	// use height of first component, because no subsampling
 	uint64_t dataLen = packedRowBytes_ * (yEnd - yBegin);
-	uint64_t dataOffset = packedRowBytes_ * yBegin;
-	if(!strip->allocInterleaved(dataLen, pools_[threadId]))
+	buf = getPool(threadId)->get(dataLen);
+	if(!buf.data_)
 		return false;
-	if(!dest->compositeInterleaved(src, yBegin, yEnd))
-		return false;
-
-	auto buf = GrkIOBuf(dest->interleavedData);
 	buf.index_ = stripId;
-	buf.offset_ = dataOffset;
+	buf.offset_ = packedRowBytes_ * yBegin;
 	buf.len_ = dataLen;
-	dest->interleavedData.data_ = nullptr;
 
+	return true;
+}
+bool StripCache::ingestStrip(uint32_t threadId, GrkIOBuf buf)
+{
 	return serialize(threadId, buf);
 }
+uint8_t StripCache::getInterleavePacker(uint16_t numcomps, uint32_t width)
+{
+	if(!initialized_ || multiTile_)
+		return 0;
+	uint8_t bits = 0;
+	switch(packer_)
+	{
+		case 8:
+			bits = 8;
+			break;
+		case 16:
+		case packer16BitBE:
+			bits = 16;
+			break;
+		default:
+			return 0;
+	}
+	if(PlanarToInterleaved<int32_t>::getPackedBytes(numcomps, width, bits) != packedRowBytes_)
+		return 0;
+
+	return packer_;
+}
 // single threaded case
 bool StripCache::ingestTile(GrkImage* src)
 {
@@ -143,7 +274,7 @@ bool StripCache::ingestTile(uint32_t threadId, GrkImage* src)
 	// use height of first component, because no subsampling
 	uint64_t dataLen = packedRowBytes_ * dest->comps->h;
 	uint64_t offset = packedRowBytes_ * dest->comps->y0;
-	if(!strip->allocInterleavedLocked(dataLen, pools_[threadId]))
+	if(!strip->allocInterleavedLocked(dataLen, getPool(threadId)))
 		return false;
 	if(!dest->compositeInterleaved(src))
 		return false;
@@ -170,6 +301,7 @@ bool StripCache::serialize(uint32_t threadId, GrkIOBuf buf)
 		return ioBufferCallback_(threadId, buf, ioUserData_);
 
 	std::queue<GrkIOBuf> buffersToSerialize;
+	std::unique_lock<std::mutex> serializeLock(serializeMutex_, std::defer_lock);
 	{
 		std::unique_lock<std::mutex> lk(heapMutex_);
 		// 1. push to heap
@@ -177,20 +309,22 @@ bool StripCache::serialize(uint32_t threadId, GrkIOBuf buf)
 		// 2. get all sequential buffers in heap
 		while(serializeHeap.pop(buf))
 			buffersToSerialize.push(buf);
+		// acquire serialize lock before releasing heap lock, so that
+		// buffers popped later cannot be serialized ahead of these
+		if(!buffersToSerialize.empty())
+			serializeLock.lock();
 	}
 	// 3. serialize buffers
 	if(!buffersToSerialize.empty())
 	{
+		while(!buffersToSerialize.empty())
 		{
-			std::unique_lock<std::mutex> lk(serializeMutex_);
-			while(!buffersToSerialize.empty())
-			{
-				auto b = buffersToSerialize.front();
-				if(!ioBufferCallback_(threadId, b, ioUserData_))
-					break;
-				buffersToSerialize.pop();
-			}
+			auto b = buffersToSerialize.front();
+			if(!ioBufferCallback_(threadId, b, ioUserData_))
+				break;
+			buffersToSerialize.pop();
 		}
+		serializeLock.unlock();
 		// if non empty, then there has been a serialize failure
 		if(!buffersToSerialize.empty())
 		{
@@ -210,7 +344,8 @@ bool StripCache::serialize(uint32_t threadId, GrkIOBuf buf)
 
 void StripCache::returnBufferToPool(uint32_t threadId, GrkIOBuf b)
 {
-	pools_[threadId]->put(b);
+	// reclaim thread ids are not necessarily worker ids
+	pools_[threadId % pools_.size()]->put(b);
 }
 
 } // namespace grk
@@ -55,40 +55,36 @@ struct GrkIOBuf : public grk_io_buf
 	}
 };
 
+/**
+ * Pool of interleave buffers, binned into size classes spaced a quarter
+ * of a power of two apart, so that a small request never takes a large buffer.
+ *
+ * get() is only called by the pool's owning thread, while put() is lock-free
+ * and may be called from any thread, such as an I/O reclaim thread.
+ * Returned buffers are pushed onto a lock-free stack, linked through the
+ * buffers' own memory, and moved to the size class free lists on the next get().
+ */
 class BufPool
 {
   public:
-	~BufPool(void)
-	{
-		for(auto& b : pool)
-			b.second.dealloc();
-	}
-	GrkIOBuf get(size_t len)
-	{
-		for(auto iter = pool.begin(); iter != pool.end(); ++iter)
-		{
-			if(iter->second.allocLen_ >= len)
-			{
-				auto b = iter->second;
-				b.len_ = len;
-				pool.erase(iter);
-				return b;
-			}
-		}
-		GrkIOBuf rc;
-		rc.alloc(len);
-
-		return rc;
-	}
-	void put(GrkIOBuf b)
-	{
-		assert(b.data_);
-		assert(pool.find(b.data_) == pool.end());
-		pool[b.data_] = b;
-	}
+	BufPool(void);
+	~BufPool(void);
+	GrkIOBuf get(size_t len);
+	void put(GrkIOBuf b);
 
   private:
-	std::map<uint8_t*, GrkIOBuf> pool;
+	struct FreeNode
+	{
+		FreeNode* next;
+		size_t allocLen;
+	};
+	static uint8_t sizeClass(size_t len);
+	static size_t classSize(uint8_t sizeClass);
+	void drainReturned(void);
+	static constexpr size_t minClassSize = 64;
+	static constexpr uint8_t numSizeClasses = 4 * (64 - 6);
+	FreeNode* free_[numSizeClasses];
+	std::atomic<FreeNode*> returned_;
 };
 
 struct Strip
@@ -98,7 +94,6 @@ struct Strip
 	uint32_t getIndex(void);
 	uint32_t reduceDim(uint32_t dim);
 	bool allocInterleavedLocked(uint64_t len, BufPool* pool);
-	bool allocInterleaved(uint64_t len, BufPool* pool);
 	GrkImage* stripImg;
 	std::atomic<uint32_t> tileCounter; // count number of tiles added to strip
 	uint8_t reduce_; // resolution reduction
@@ -115,16 +110,32 @@ class StripCache
 	void init(uint32_t concurrency, uint16_t numTiles_, uint32_t numStrips,
 			  uint32_t nominalStripHeight, uint8_t reduce, GrkImage* outputImg,
 			  grk_io_pixels_callback ioBufferCallback, void* ioUserData,
-			  grk_io_register_reclaim_callback grkRegisterReclaimCallback);
+			  grk_io_register_reclaim_callback grkRegisterReclaimCallback, bool ingestImages);
 	bool ingestTile(uint32_t threadId, GrkImage* src);
 	bool ingestTile(GrkImage* src);
 	bool ingestStrip(uint32_t threadId, Tile* src, uint32_t yBegin, uint32_t yEnd);
+	/**
+	 * Get a buffer for rows [yBegin, yEnd) of a single tile image, to be filled
+	 * with packed, interleaved samples and then passed to ingestStrip
+	 */
+	bool getStripBuffer(uint32_t threadId, uint32_t yBegin, uint32_t yEnd, GrkIOBuf& buf);
+	bool ingestStrip(uint32_t threadId, GrkIOBuf buf);
+	/**
+	 * Get packer for interleaving rows of numcomps components of the given width
+	 * directly into strip buffers : either 8, 16 or packer16BitBE,
+	 * or 0 if strips must be composited from the tile
+	 */
+	uint8_t getInterleavePacker(uint16_t numcomps, uint32_t width);
 	void returnBufferToPool(uint32_t threadId, GrkIOBuf b);
 	bool isInitialized(void);
 	bool isMultiTile(void);
 
   private:
 	bool serialize(uint32_t threadId, GrkIOBuf buf);
+	/**
+	 * Get pool owned by worker threadId : threads that are not workers share the last pool
+	 */
+	BufPool* getPool(uint32_t threadId);
 	std::vector<BufPool*> pools_;
 	Strip** strips;
 	uint16_t numTiles_;
@@ -132,12 +143,15 @@ class StripCache
 	uint32_t nominalStripHeight_;
 	uint32_t imageY0_;
 	uint64_t packedRowBytes_;
+	uint8_t reduce_;
+	uint8_t packer_;
 	void* ioUserData_;
 	grk_io_pixels_callback ioBufferCallback_;
 	mutable std::mutex serializeMutex_;
 	MinHeap<GrkIOBuf, uint32_t, MinHeapFakeLocker> serializeHeap;
 	mutable std::mutex heapMutex_;
 	bool initialized_;
+	// strips are composited from tile or band images, rather than from tile rows
 	bool multiTile_;
 };
 
@@ -18,13 +18,23 @@
 
 namespace grk
 {
-TileCacheEntry::TileCacheEntry(TileProcessor* p) : processor(p) {}
+TileCacheKey::TileCacheKey(uint8_t reduceFactor, uint16_t numLayers, grk_rect32 tileRegion)
+	: reduce(reduceFactor), layers(numLayers), region(tileRegion)
+{}
+TileCacheKey::TileCacheKey(void) : TileCacheKey(0, 0, grk_rect32(0, 0, 0, 0)) {}
+bool TileCacheKey::operator==(const TileCacheKey& rhs) const
+{
+	return reduce == rhs.reduce && layers == rhs.layers && region == rhs.region;
+}
+TileCacheEntry::TileCacheEntry(TileProcessor* p) : processor(p), imageBytes(0), inLRU(false) {}
 TileCacheEntry::TileCacheEntry() : TileCacheEntry(nullptr) {}
 TileCacheEntry::~TileCacheEntry()
 {
 	delete processor;
 }
-TileCache::TileCache(GRK_TILE_CACHE_STRATEGY strategy) : tileComposite(nullptr), strategy_(strategy)
+TileCache::TileCache(GRK_TILE_CACHE_STRATEGY strategy)
+	: tileComposite(nullptr), strategy_(strategy), maxBytes_(0), bytes_(0), hits_(0), misses_(0),
+	  evictions_(0)
 {
 	tileComposite = new GrkImage();
 }
@@ -33,15 +43,54 @@ TileCache::~TileCache()
 {
 	for(const auto& proc : cache_)
 		delete proc.second;
+	for(auto proc : recycled_)
+		delete proc;
 	if(tileComposite)
 		grk_object_unref(&tileComposite->obj);
 }
 bool TileCache::empty()
 {
+	std::lock_guard<std::mutex> lock(mutex_);
 	return cache_.empty();
 }
+void TileCache::clear(void)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	for(const auto& entry : cache_)
+		delete entry.second;
+	cache_.clear();
+	lru_.clear();
+	bytes_ = 0;
+}
+void TileCache::restart(uint8_t reduce, uint16_t layers)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	for(auto iter = cache_.begin(); iter != cache_.end();)
+	{
+		auto entry = iter->second;
+		if(entry->inLRU && entry->key.reduce == reduce && entry->key.layers == layers)
+		{
+			entry->processor->restart();
+			++iter;
+			continue;
+		}
+		pin(entry);
+		// code blocks holding all layers can be decompressed again with a different
+		// number of layers, without parsing the tile's packets
+		if(entry->processor && entry->processor->retainsLayers())
+		{
+			entry->processor->release(GRK_TILE_CACHE_NONE);
+			entry->processor->restart();
+			++iter;
+			continue;
+		}
+		delete entry;
+		iter = cache_.erase(iter);
+	}
+}
 TileCacheEntry* TileCache::put(uint16_t tileIndex, TileProcessor* processor)
 {
+	std::lock_guard<std::mutex> lock(mutex_);
 	TileCacheEntry* entry = nullptr;
 	if(cache_.find(tileIndex) != cache_.end())
 	{
@@ -56,12 +105,137 @@ TileCacheEntry* TileCache::put(uint16_t tileIndex, TileProcessor* processor)
 
 	return entry;
 }
-TileCacheEntry* TileCache::get(uint16_t tileIndex)
+TileProcessor* TileCache::acquire(uint16_t tileIndex, bool pinImage)
 {
-	if(cache_.find(tileIndex) != cache_.end())
-		return cache_[tileIndex];
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto entry = find(tileIndex);
+	if(!entry)
+		return nullptr;
+	if(pinImage)
+		pin(entry);
+
+	return entry->processor;
+}
+void TileCache::pin(TileCacheEntry* entry)
+{
+	if(!entry->inLRU)
+		return;
+	lru_.erase(entry->lruPosition);
+	bytes_ -= entry->imageBytes;
+	entry->imageBytes = 0;
+	entry->inLRU = false;
+}
+TileCacheEntry* TileCache::find(uint16_t tileIndex)
+{
+	auto iter = cache_.find(tileIndex);
+
+	return iter != cache_.end() ? iter->second : nullptr;
+}
+GrkImage* TileCache::getImage(uint16_t tileIndex)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto entry = find(tileIndex);
+
+	return (entry && entry->processor) ? entry->processor->getImage() : nullptr;
+}
+GrkImage* TileCache::lookup(uint16_t tileIndex, TileCacheKey key)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto entry = find(tileIndex);
+	auto image = (entry && entry->processor) ? entry->processor->getImage() : nullptr;
+	if(image && !(entry->key == key))
+		image = nullptr;
+	if(!image)
+	{
+		misses_++;
+		return nullptr;
+	}
+	hits_++;
+	if(entry->inLRU)
+		lru_.splice(lru_.begin(), lru_, entry->lruPosition);
 
-	return nullptr;
+	return image;
+}
+void TileCache::retain(uint16_t tileIndex, TileCacheKey key)
+{
+	if(strategy_ == GRK_TILE_CACHE_NONE)
+		return;
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto entry = find(tileIndex);
+	if(!entry || !entry->processor)
+		return;
+	auto image = entry->processor->getImage();
+	if(!image)
+		return;
+	uint64_t imageBytes = 0;
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		if(comp->data)
+			imageBytes += (uint64_t)comp->stride * comp->h * sizeof(int32_t);
+	}
+	if(entry->inLRU)
+	{
+		bytes_ -= entry->imageBytes;
+		lru_.splice(lru_.begin(), lru_, entry->lruPosition);
+	}
+	else
+	{
+		lru_.push_front(tileIndex);
+		entry->lruPosition = lru_.begin();
+		entry->inLRU = true;
+	}
+	entry->key = key;
+	entry->imageBytes = imageBytes;
+	bytes_ += imageBytes;
+	if(strategy_ != GRK_TILE_CACHE_LRU || !maxBytes_)
+		return;
+	while(bytes_ > maxBytes_ && lru_.size() > 1)
+		evict(lru_.back());
+}
+void TileCache::recycle(uint16_t tileIndex)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto entry = find(tileIndex);
+	if(!entry || !entry->processor || entry->inLRU || entry->processor->getImage() ||
+	   entry->processor->retainsLayers())
+		return;
+	recycled_.push_back(entry->processor);
+	entry->processor = nullptr;
+	cache_.erase(tileIndex);
+	delete entry;
+}
+TileProcessor* TileCache::getRecycledProcessor(void)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if(recycled_.empty())
+		return nullptr;
+	auto processor = recycled_.back();
+	recycled_.pop_back();
+
+	return processor;
+}
+void TileCache::evict(uint16_t tileIndex)
+{
+	auto entry = find(tileIndex);
+	assert(entry && entry->inLRU);
+	pin(entry);
+	evictions_++;
+	// only the tile image is released : the processor may still be in use
+	// while the code stream parser skips over this tile's tile parts
+	if(entry->processor)
+	{
+		entry->processor->release(GRK_TILE_CACHE_NONE);
+		entry->processor->releaseLayers();
+	}
+}
+void TileCache::getStats(grk_tile_cache_stats* stats)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	stats->hits = hits_;
+	stats->misses = misses_;
+	stats->evictions = evictions_;
+	stats->bytes = bytes_;
 }
 void TileCache::setStrategy(GRK_TILE_CACHE_STRATEGY strategy)
 {
@@ -71,6 +245,10 @@ GRK_TILE_CACHE_STRATEGY TileCache::getStrategy(void)
 {
 	return strategy_;
 }
+void TileCache::setMaxBytes(uint64_t maxBytes)
+{
+	maxBytes_ = maxBytes;
+}
 GrkImage* TileCache::getComposite()
 {
 	return tileComposite;
@@ -84,6 +262,7 @@ std::vector<GrkImage*> TileCache::getAllImages(void)
 }
 std::vector<GrkImage*> TileCache::getTileImages(void)
 {
+	std::lock_guard<std::mutex> lock(mutex_);
 	std::vector<GrkImage*> rc;
 	for(const auto& entry : cache_)
 	{
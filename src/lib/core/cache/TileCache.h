@@ -17,6 +17,9 @@
 #pragma once
 
 #include <map>
+#include <list>
+#include <mutex>
+#include <vector>
 
 namespace grk
 {
@@ -25,6 +28,21 @@ class GrkImage;
 
 #include "GrkImage.h"
 
+/**
+ * Decompress parameters that determine the contents of a cached tile image
+ */
+struct TileCacheKey
+{
+	TileCacheKey(uint8_t reduce, uint16_t layers, grk_rect32 region);
+	TileCacheKey(void);
+	bool operator==(const TileCacheKey& rhs) const;
+
+	uint8_t reduce;
+	uint16_t layers;
+	// decompressed region of tile, in reference grid coordinates
+	grk_rect32 region;
+};
+
 struct TileCacheEntry
 {
 	explicit TileCacheEntry(TileProcessor* p);
@@ -32,6 +50,14 @@ struct TileCacheEntry
 	~TileCacheEntry();
 
 	TileProcessor* processor;
+	// parameters used to decompress cached tile image
+	TileCacheKey key;
+	// number of bytes held by cached tile image
+	uint64_t imageBytes;
+	// true if tile image is tracked by LRU list
+	bool inLRU;
+	// position in LRU list (most recently used at front)
+	std::list<uint16_t>::iterator lruPosition;
 };
 
 class TileCache
@@ -42,19 +68,98 @@ class TileCache
 	virtual ~TileCache();
 
 	bool empty(void);
+	/**
+	 * Delete all tile processors and cached tile images.
+	 * Composite image, recycled processors and cache statistics are retained.
+	 */
+	void clear(void);
+	/**
+	 * Prepare for tile parts to be parsed again from the start of the code stream.
+	 * Tile images decompressed with the given reduce and layers are retained.
+	 * Tiles whose code blocks hold all layers are retained without their images,
+	 * and all other entries are deleted.
+	 *
+	 * @param reduce number of discarded resolutions for next decompress
+	 * @param layers number of layers for next decompress
+	 */
+	void restart(uint8_t reduce, uint16_t layers);
 	void setStrategy(GRK_TILE_CACHE_STRATEGY strategy);
 	GRK_TILE_CACHE_STRATEGY getStrategy(void);
+	void setMaxBytes(uint64_t maxBytes);
 	TileCacheEntry* put(uint16_t tileIndex, TileProcessor* processor);
-	TileCacheEntry* get(uint16_t tileIndex);
+	/**
+	 * Get processor of cached tile
+	 *
+	 * @param tileIndex tile index
+	 * @param pinImage if true, pin tile image so that it cannot be evicted
+	 * while the tile is being decompressed
+	 *
+	 * @return tile processor, or nullptr if tile is not cached
+	 */
+	TileProcessor* acquire(uint16_t tileIndex, bool pinImage);
+	/**
+	 * Get cached tile image
+	 *
+	 * @param tileIndex tile index
+	 *
+	 * @return cached tile image, or nullptr if tile image is not cached
+	 */
+	GrkImage* getImage(uint16_t tileIndex);
+	/**
+	 * Look up tile image decompressed with given key, record cache hit or miss,
+	 * and mark tile as most recently used
+	 *
+	 * @param tileIndex tile index
+	 * @param key decompress parameters of requested tile image
+	 *
+	 * @return cached tile image, or nullptr if no such tile image is cached
+	 */
+	GrkImage* lookup(uint16_t tileIndex, TileCacheKey key);
+	/**
+	 * Account for decompressed tile image retained by tile processor,
+	 * and evict least recently used tile images if cache exceeds its byte budget.
+	 * Most recently retained tile image is never evicted.
+	 *
+	 * @param tileIndex tile index
+	 * @param key decompress parameters of tile image
+	 */
+	void retain(uint16_t tileIndex, TileCacheKey key);
+	/**
+	 * Move released tile processor to pool of recycled processors,
+	 * unless it holds a cached tile image, or code blocks holding all layers
+	 *
+	 * @param tileIndex tile index
+	 */
+	void recycle(uint16_t tileIndex);
+	/**
+	 * Get processor from pool of recycled processors
+	 *
+	 * @return recycled processor, or nullptr if pool is empty
+	 */
+	TileProcessor* getRecycledProcessor(void);
+	void getStats(grk_tile_cache_stats* stats);
 	GrkImage* getComposite(void);
 	std::vector<GrkImage*> getAllImages(void);
 	std::vector<GrkImage*> getTileImages(void);
 
   private:
+	TileCacheEntry* find(uint16_t tileIndex);
+	void pin(TileCacheEntry* entry);
+	void evict(uint16_t tileIndex);
 	// each component is sub-sampled and resolution-reduced
 	GrkImage* tileComposite;
 	std::map<uint32_t, TileCacheEntry*> cache_;
 	GRK_TILE_CACHE_STRATEGY strategy_;
+	uint64_t maxBytes_;
+	uint64_t bytes_;
+	// tile indices of cached tile images, most recently used at front
+	std::list<uint16_t> lru_;
+	uint64_t hits_;
+	uint64_t misses_;
+	uint64_t evictions_;
+	// released processors, ready to be re-used for another tile
+	std::vector<TileProcessor*> recycled_;
+	mutable std::mutex mutex_;
 };
 
 } // namespace grk
@@ -109,6 +109,7 @@ struct ICodeStreamCompress
 	virtual bool init(grk_cparameters* p_param, GrkImage* p_image) = 0;
 	virtual bool start(void) = 0;
 	virtual uint64_t compress(grk_plugin_tile* tile) = 0;
+	virtual bool pushRows(const int32_t* const* rows, uint32_t stride, uint32_t numRows) = 0;
 };
 
 struct ICodeStreamDecompress
@@ -120,8 +121,11 @@ struct ICodeStreamDecompress
 	virtual GrkImage* getImage(void) = 0;
 	virtual void init(grk_decompress_core_params* p_param) = 0;
 	virtual bool setDecompressRegion(grk_rect_single region) = 0;
+	virtual bool setReduce(uint8_t reduce) = 0;
+	virtual bool setLayers(uint16_t layers) = 0;
 	virtual bool decompress(grk_plugin_tile* tile) = 0;
 	virtual bool decompressTile(uint16_t tileIndex) = 0;
+	virtual void getTileCacheStats(grk_tile_cache_stats* stats) = 0;
 	virtual bool preProcess(void) = 0;
 	virtual bool postProcess(void) = 0;
 	virtual void dump(uint32_t flag, FILE* outputFileStream) = 0;
@@ -54,12 +54,17 @@ static j2k_prog_order j2k_prog_order_list[] = {{GRK_CPRL, "CPRL"}, {GRK_LRCP, "L
 											   {GRK_PCRL, "PCRL"}, {GRK_RLCP, "RLCP"},
 											   {GRK_RPCL, "RPCL"}, {(GRK_PROG_ORDER)-1, ""}};
 
-CodeStreamCompress::CodeStreamCompress(BufferedStream* stream) : CodeStream(stream)
+CodeStreamCompress::CodeStreamCompress(BufferedStream* stream)
+	: CodeStream(stream), pushingRows_(false), nextPushRow_(0)
 {
 	cp_.wholeTileDecompress_ = false;
 }
 
-CodeStreamCompress::~CodeStreamCompress() {}
+CodeStreamCompress::~CodeStreamCompress()
+{
+	for(auto tp : pushTileProcessors_)
+		delete tp;
+}
 char* CodeStreamCompress::convertProgressionOrder(GRK_PROG_ORDER prg_order)
 {
 	j2k_prog_order* po;
@@ -310,6 +315,13 @@ bool CodeStreamCompress::init(grk_cparameters* parameters, GrkImage* image)
 	cp_.coding_params_.enc_.writePLT = parameters->writePLT;
 	cp_.coding_params_.enc_.writeTLM = parameters->writeTLM;
 	cp_.coding_params_.enc_.rateControlAlgorithm = parameters->rateControlAlgorithm;
+	if(parameters->rateControlAlgorithm == GRK_RATE_CONTROL_PCRD_OPT_IMAGE &&
+	   (!parameters->allocationByRateDistoration || parameters->max_comp_size))
+	{
+		Logger::logger_.warn("Image-wide rate control only applies to compression ratios "
+							 "without a maximum component size : using per tile rate control");
+		cp_.coding_params_.enc_.rateControlAlgorithm = GRK_RATE_CONTROL_PCRD_OPT;
+	}
 
 	/* tiles */
 	cp_.t_width = parameters->t_width;
@@ -613,9 +625,121 @@ bool CodeStreamCompress::init(grk_cparameters* parameters, GrkImage* image)
 
 	return true;
 }
+bool CodeStreamCompress::canPushRows(void)
+{
+	for(uint16_t compno = 0; compno < headerImage_->numcomps; ++compno)
+	{
+		auto comp = headerImage_->comps + compno;
+		if(comp->data)
+		{
+			Logger::logger_.error("Rows cannot be pushed to a compressor initialized with "
+								  "image data");
+			return false;
+		}
+		if(comp->dx != 1 || comp->dy != 1)
+		{
+			Logger::logger_.error("Rows cannot be pushed for subsampled component %u", compno);
+			return false;
+		}
+	}
+	uint32_t numTiles = (uint32_t)cp_.t_grid_height * cp_.t_grid_width;
+	for(uint32_t i = 0; i < numTiles; ++i)
+	{
+		if(cp_.tcps[i].mct == 2)
+		{
+			Logger::logger_.error("Rows cannot be pushed with a custom multi-component transform");
+			return false;
+		}
+	}
+
+	return true;
+}
+bool CodeStreamCompress::pushRows(const int32_t* const* rows, uint32_t stride, uint32_t numRows)
+{
+	if(!rows)
+		return false;
+	if(!pushingRows_)
+	{
+		if(!canPushRows())
+			return false;
+		// tiles are written as soon as their row of tiles is complete,
+		// before the following tiles have been compressed
+		auto enc = &cp_.coding_params_.enc_;
+		if(enc->rateControlAlgorithm == GRK_RATE_CONTROL_PCRD_OPT_IMAGE &&
+		   cp_.t_grid_width * cp_.t_grid_height > 1)
+		{
+			Logger::logger_.warn("Image-wide rate control is not supported when pushing rows "
+								 ": using per tile rate control");
+			enc->rateControlAlgorithm = GRK_RATE_CONTROL_PCRD_OPT;
+		}
+		pushingRows_ = true;
+		nextPushRow_ = headerImage_->y0;
+	}
+	if(numRows > headerImage_->y1 - nextPushRow_)
+	{
+		Logger::logger_.error("Pushed %u rows, but only %u rows of the image remain", numRows,
+							  headerImage_->y1 - nextPushRow_);
+		return false;
+	}
+	std::vector<const int32_t*> compRows(rows, rows + headerImage_->numcomps);
+	while(numRows)
+	{
+		// start the next tile row
+		if(pushTileProcessors_.empty())
+		{
+			uint16_t tileRow = (uint16_t)((nextPushRow_ - cp_.ty0) / cp_.t_height);
+			for(uint16_t i = 0; i < cp_.t_grid_width; ++i)
+			{
+				auto tileProcessor =
+					new TileProcessor((uint16_t)(tileRow * cp_.t_grid_width + i), this, stream_,
+									  true, nullptr, nullptr);
+				pushTileProcessors_.push_back(tileProcessor);
+				if(!tileProcessor->preCompressTileRows())
+					return false;
+			}
+		}
+		uint32_t tileRowEnd = pushTileProcessors_.front()->getTile()->y1;
+		uint32_t n = std::min<uint32_t>(numRows, tileRowEnd - nextPushRow_);
+		for(auto tp : pushTileProcessors_)
+		{
+			if(!tp->compressTileRows(compRows.data(), stride, n))
+				return false;
+		}
+		for(auto& r : compRows)
+			r += (size_t)n * stride;
+		nextPushRow_ += n;
+		numRows -= n;
+		// tile row is complete : write its tiles
+		if(nextPushRow_ == tileRowEnd)
+		{
+			bool success = true;
+			for(auto tp : pushTileProcessors_)
+			{
+				if(success)
+					success = tp->postCompressTileRows() && writeTileParts(tp);
+				delete tp;
+			}
+			pushTileProcessors_.clear();
+			if(!success)
+				return false;
+		}
+	}
+
+	return true;
+}
 uint64_t CodeStreamCompress::compress(grk_plugin_tile* tile)
 {
-	MinHeapPtr<TileProcessor, uint16_t, MinHeapLocker> heap;
+	if(pushingRows_)
+	{
+		if(nextPushRow_ != headerImage_->y1)
+		{
+			Logger::logger_.error("Only %u of %u image rows were pushed",
+								  nextPushRow_ - headerImage_->y0,
+								  headerImage_->y1 - headerImage_->y0);
+			return 0;
+		}
+		return end() ? stream_->tell() : 0;
+	}
 	uint32_t numTiles = (uint32_t)cp_.t_grid_height * cp_.t_grid_width;
 	if(numTiles > maxNumTilesJ2K)
 	{
@@ -627,67 +751,281 @@ uint64_t CodeStreamCompress::compress(grk_plugin_tile* tile)
 	auto numRequiredThreads =
 		std::min<uint32_t>((uint32_t)ExecSingleton::get()->num_workers(), numTiles);
 	std::atomic<bool> success(true);
-	if(numRequiredThreads > 1)
-	{
-		tf::Executor exec(numRequiredThreads);
-		tf::Taskflow taskflow;
-		auto node = new tf::Task[numTiles];
-		for(uint64_t i = 0; i < numTiles; i++)
-			node[i] = taskflow.placeholder();
-		for(uint16_t j = 0; j < numTiles; ++j)
+	// per tile rate control of a single tile image is already image-wide
+	if(numTiles > 1 &&
+	   cp_.coding_params_.enc_.rateControlAlgorithm == GRK_RATE_CONTROL_PCRD_OPT_IMAGE)
+	{
+		success = compressImageRateControl(tile);
+	}
+	else if(numRequiredThreads > 1)
+	{
+		// tiles are written in order as soon as all preceding tiles have been written,
+		// so only tiles that complete out of order are held in memory. The number of tiles
+		// that have been submitted but not yet written is bounded, to cap memory usage.
+		MinHeapPtr<TileProcessor, uint16_t, MinHeapFakeLocker> heap;
+		std::mutex heapMutex;
+		std::condition_variable writtenCondition;
+		bool writing = false;
+		uint32_t numWritten = 0;
+		uint32_t maxInFlight = numRequiredThreads * maxTilesInFlightPerThread;
+		auto write = [this, &heap, &heapMutex, &writtenCondition, &writing, &numWritten,
+					  &success](TileProcessor* tp) {
+			std::unique_lock<std::mutex> lk(heapMutex);
+			heap.push(tp);
+			// only one thread writes at a time, so tiles are written in order :
+			// the writing thread also writes tiles pushed while it is writing
+			if(writing)
+				return;
+			writing = true;
+			while((tp = heap.pop()) != nullptr)
+			{
+				lk.unlock();
+				if(success && !writeTileParts(tp))
+					success = false;
+				delete tp;
+				lk.lock();
+				numWritten++;
+				writtenCondition.notify_all();
+			}
+			writing = false;
+		};
+		auto waitForWritten = [&heapMutex, &writtenCondition, &numWritten](uint32_t minTiles) {
+			std::unique_lock<std::mutex> lk(heapMutex);
+			writtenCondition.wait(lk, [&numWritten, minTiles] { return numWritten >= minTiles; });
+		};
+		uint16_t numSubmitted = 0;
+		for(; numSubmitted < numTiles; ++numSubmitted)
 		{
-			uint16_t tileIndex = j;
-			node[j].work([this, tile, tileIndex, &heap, &success] {
+			// block submission until there is room in the in-flight window
+			if(numSubmitted >= maxInFlight)
+				waitForWritten(numSubmitted - maxInFlight + 1);
+			if(!success)
+				break;
+			uint16_t tileIndex = numSubmitted;
+			ExecSingleton::get()->silent_async([this, tile, tileIndex, &write, &success] {
+				auto tileProcessor =
+					new TileProcessor(tileIndex, this, stream_, true, nullptr, nullptr);
 				if(success)
 				{
-					auto tileProcessor = new TileProcessor(tileIndex, this, stream_, true, nullptr);
 					tileProcessor->current_plugin_tile = tile;
 					if(!tileProcessor->preCompressTile() || !tileProcessor->doCompress())
 						success = false;
-					heap.push(tileProcessor);
 				}
+				// failed and skipped tiles are still pushed, to release their successors
+				write(tileProcessor);
 			});
 		}
-		exec.run(taskflow).wait();
-		delete[] node;
+		waitForWritten(numSubmitted);
 	}
 	else
 	{
 		for(uint16_t i = 0; i < numTiles; ++i)
 		{
-			auto tileProcessor = new TileProcessor(i, this, stream_, true, nullptr);
+			auto tileProcessor = new TileProcessor(i, this, stream_, true, nullptr, nullptr);
 			tileProcessor->current_plugin_tile = tile;
 			if(!tileProcessor->preCompressTile() || !tileProcessor->doCompress())
 			{
 				delete tileProcessor;
 				success = false;
-				goto cleanup;
+				break;
 			}
 			bool write_success = writeTileParts(tileProcessor);
 			delete tileProcessor;
 			if(!write_success)
 			{
 				success = false;
-				goto cleanup;
+				break;
 			}
 		}
 	}
-cleanup:
-	auto completeTileProcessor = heap.pop();
-	while(completeTileProcessor)
+	if(success)
+		success = end();
+
+	return success ? stream_->tell() : 0;
+}
+/**
+ * Run op on each tile index, in parallel if there are multiple workers
+ */
+static bool forEachTile(uint16_t numTiles, const std::function<bool(uint16_t)>& op)
+{
+	std::atomic<bool> success(true);
+	if(ExecSingleton::get()->num_workers() > 1)
 	{
-		if(success)
+		tf::Taskflow taskflow;
+		auto node = new tf::Task[numTiles];
+		for(uint16_t i = 0; i < numTiles; i++)
+			node[i] = taskflow.placeholder();
+		for(uint16_t i = 0; i < numTiles; ++i)
 		{
-			if(!writeTileParts(completeTileProcessor))
-				success = false;
+			node[i].work([i, &op, &success] {
+				if(success && !op(i))
+					success = false;
+			});
 		}
-		delete completeTileProcessor;
-		completeTileProcessor = heap.pop();
+		ExecSingleton::run(taskflow);
+		delete[] node;
+	}
+	else
+	{
+		for(uint16_t i = 0; i < numTiles && success; ++i)
+			success = op(i);
 	}
+
+	return success;
+}
+bool CodeStreamCompress::compressImageRateControl(grk_plugin_tile* tile)
+{
+	auto numTiles = (uint16_t)(cp_.t_grid_height * cp_.t_grid_width);
+	std::vector<TileProcessor*> tileProcessors(numTiles, nullptr);
+	std::vector<std::unique_ptr<PacketSizeModel>> models(numTiles);
+	std::vector<uint16_t> minSlopes(numTiles, USHRT_MAX);
+	std::vector<uint64_t> tileBytes(numTiles, 0);
+	uint16_t numLayers = 0;
+	for(uint16_t i = 0; i < numTiles; ++i)
+		numLayers = std::max<uint16_t>(numLayers, cp_.tcps[i].max_layers_);
+
+	// 1. block code all tiles, and calculate their feasible truncation points
+	bool success = forEachTile(numTiles, [this, tile, &tileProcessors, &models,
+										  &minSlopes](uint16_t i) {
+		auto tileProcessor = new TileProcessor(i, this, stream_, true, nullptr, nullptr);
+		tileProcessors[i] = tileProcessor;
+		tileProcessor->current_plugin_tile = tile;
+		if(!tileProcessor->preCompressTile() || !tileProcessor->compressT1())
+			return false;
+		// only compressed code block data is needed from here on
+		tileProcessor->deallocBuffers();
+		minSlopes[i] = tileProcessor->prepareImageRateControl();
+		if(tileProcessor->canModelPacketSize())
+			models[i] = std::make_unique<PacketSizeModel>(tileProcessor);
+
+		return true;
+	});
+
+	// 2. bisect one threshold per layer over all tiles
+	// exact bytes of each tile's layers preceding current layer
+	std::vector<uint64_t> previousBytes(numTiles, 0);
+	bool previousBytesKnown = true;
+	uint32_t upperBound = USHRT_MAX;
+	for(uint16_t layno = 0; success && layno < numLayers; ++layno)
+	{
+		double budget = 0;
+		bool needsRateControl = false;
+		for(uint16_t i = 0; i < numTiles; ++i)
+		{
+			if(layno < tileProcessors[i]->getTileCodingParams()->max_layers_ &&
+			   tileProcessors[i]->layerNeedsRateControl(layno))
+			{
+				budget += cp_.tcps[i].rates[layno];
+				needsRateControl = true;
+			}
+		}
+		auto formLayer = [&tileProcessors, &tileBytes, layno](uint16_t thresh, bool finalAttempt,
+															   bool simulate) {
+			auto bytes = simulate ? tileBytes.data() : nullptr;
+			return forEachTile((uint16_t)tileProcessors.size(), [&, bytes](uint16_t i) {
+				auto tp = tileProcessors[i];
+				if(layno >= tp->getTileCodingParams()->max_layers_)
+					return true;
+				return tp->formLayer(layno, thresh, finalAttempt, bytes ? bytes + i : nullptr);
+			});
+		};
+		if(!needsRateControl)
+		{
+			success = formLayer(0, true, false);
+			previousBytesKnown = false;
+			continue;
+		}
+		uint32_t lowerBound = *std::min_element(minSlopes.begin(), minSlopes.end());
+		bool found = false;
+		if(models[0])
+		{
+			if(!previousBytesKnown)
+			{
+				success = forEachTile(numTiles, [&](uint16_t i) {
+					auto tp = tileProcessors[i];
+					auto layers =
+						std::min<uint16_t>(layno, tp->getTileCodingParams()->max_layers_);
+					return tp->simulateLayers(layers, &previousBytes[i]);
+				});
+			}
+			for(uint16_t i = 0; success && i < numTiles; ++i)
+			{
+				if(layno < tileProcessors[i]->getTileCodingParams()->max_layers_)
+					models[i]->beginLayer(layno, previousBytes[i]);
+			}
+			auto makeLayer = [&formLayer, &success](uint32_t thresh) {
+				success = formLayer((uint16_t)thresh, false, false) && success;
+			};
+			auto estimate = [&]() {
+				forEachTile(numTiles, [&](uint16_t i) {
+					auto tp = tileProcessors[i];
+					tileBytes[i] = layno < tp->getTileCodingParams()->max_layers_
+									   ? models[i]->estimate()
+									   : previousBytes[i];
+					return true;
+				});
+				return std::accumulate(tileBytes.begin(), tileBytes.end(), uint64_t(0));
+			};
+			// keep exact bytes of last threshold that fits budget
+			auto byteBudget = (uint64_t)budget;
+			std::vector<uint64_t> fitBytes;
+			auto simulate = [&](uint64_t* allBytes) {
+				bool rc = forEachTile(numTiles, [&](uint16_t i) {
+					auto tp = tileProcessors[i];
+					auto layers = std::min<uint16_t>((uint16_t)(layno + 1),
+													 tp->getTileCodingParams()->max_layers_);
+					return tp->simulateLayers(layers, &tileBytes[i]);
+				});
+				*allBytes = std::accumulate(tileBytes.begin(), tileBytes.end(), uint64_t(0));
+				if(rc && *allBytes <= byteBudget)
+					fitBytes = tileBytes;
+				return rc;
+			};
+			uint64_t bytes = 0;
+			found = success && PacketSizeModel::bisect(byteBudget, lowerBound, upperBound,
+													   makeLayer, estimate, simulate, &bytes);
+			if(found)
+				previousBytes = fitBytes;
+		}
+		previousBytesKnown = found;
+		uint32_t prevthresh = 0;
+		for(uint32_t iter = 0; iter < 128 && success && !found; ++iter)
+		{
+			uint32_t thresh = (lowerBound + upperBound) >> 1;
+			if(prevthresh != 0 && prevthresh == thresh)
+				break;
+			prevthresh = thresh;
+			success = formLayer((uint16_t)thresh, false, true);
+			double bytes = 0;
+			for(auto b : tileBytes)
+				bytes += (double)b;
+			if(bytes > budget)
+				lowerBound = thresh;
+			else
+				upperBound = thresh;
+		}
+		// choose conservative threshold
+		if(success)
+			success = formLayer((uint16_t)upperBound, true, false);
+		// upper bound for next layer is lower bound for current layer, minus one
+		upperBound = lowerBound - 1;
+	}
+
+	// 3. prepare tile parts, and write tiles in order
 	if(success)
-		success = end();
+	{
+		success = forEachTile(numTiles, [&tileProcessors](uint16_t i) {
+			return tileProcessors[i]->finishImageRateControl();
+		});
+	}
+	for(auto tp : tileProcessors)
+	{
+		if(success && tp && !writeTileParts(tp))
+			success = false;
+		delete tp;
+	}
 
-	return success ? stream_->tell() : 0;
+	return success;
 }
 bool CodeStreamCompress::end(void)
 {
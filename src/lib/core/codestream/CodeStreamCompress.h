@@ -37,13 +37,20 @@ class CodeStreamCompress : public CodeStream, public ICodeStreamCompress
 	bool start(void);
 	bool init(grk_cparameters* p_param, GrkImage* p_image);
 	uint64_t compress(grk_plugin_tile* tile);
+	bool pushRows(const int32_t* const* rows, uint32_t stride, uint32_t numRows);
 
   private:
+	bool canPushRows(void);
 	bool init_header_writing(void);
 	bool cacheEndOfHeader(void);
 	bool end(void);
 	bool writeTilePart(TileProcessor* tileProcessor);
 	bool writeTileParts(TileProcessor* tileProcessor);
+	/**
+	 * Compress all tiles with one slope threshold per layer for the whole image,
+	 * chosen so that the packets of all tiles fit the sum of the tile layer budgets
+	 */
+	bool compressImageRateControl(grk_plugin_tile* tile);
 	bool updateRates(void);
 	bool compressValidation(void);
 	bool mct_validation(void);
@@ -312,6 +319,13 @@ class CodeStreamCompress : public CodeStream, public ICodeStreamCompress
 	bool init_mct_encoding(TileCodingParams* p_tcp, GrkImage* p_image);
 
 	CompressorState compressorState_;
+
+	// true once rows have been pushed with pushRows
+	bool pushingRows_;
+	// next image row expected by pushRows
+	uint32_t nextPushRow_;
+	// tile processors for the tile row currently being pushed
+	std::vector<TileProcessor*> pushTileProcessors_;
 };
 
 } // namespace grk
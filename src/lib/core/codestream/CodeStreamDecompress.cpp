@@ -122,11 +122,16 @@ GrkImage* CodeStreamDecompress::getCompositeImage()
 }
 TileProcessor* CodeStreamDecompress::allocateProcessor(uint16_t tileIndex)
 {
-	auto tileCache = tileCache_->get(tileIndex);
-	auto tileProcessor = tileCache ? tileCache->processor : nullptr;
+	bool scheduled = decompressorState_.tilesToDecompress_.isScheduled(tileIndex);
+	auto tileProcessor = tileCache_->acquire(tileIndex, scheduled);
 	if(!tileProcessor)
 	{
-		tileProcessor = new TileProcessor(tileIndex, this, stream_, false, &stripCache_);
+		tileProcessor = tileCache_->getRecycledProcessor();
+		if(tileProcessor)
+			tileProcessor->recycle(tileIndex);
+		else
+			tileProcessor = new TileProcessor(tileIndex, this, stream_, false, &stripCache_,
+											  &codeblockCache_);
 		tileCache_->put(tileIndex, tileProcessor);
 	}
 	currentTileProcessor_ = tileProcessor;
@@ -152,8 +157,11 @@ DecompressorState* CodeStreamDecompress::getDecompressorState(void)
 }
 GrkImage* CodeStreamDecompress::getImage(uint16_t tileIndex)
 {
-	auto entry = tileCache_->get(tileIndex);
-	return entry ? entry->processor->getImage() : nullptr;
+	return tileCache_->getImage(tileIndex);
+}
+void CodeStreamDecompress::getTileCacheStats(grk_tile_cache_stats* stats)
+{
+	tileCache_->getStats(stats);
 }
 std::vector<GrkImage*> CodeStreamDecompress::getAllImages(void)
 {
@@ -248,11 +256,18 @@ bool CodeStreamDecompress::setDecompressRegion(grk_rect_single region)
 	auto decompressor = &decompressorState_;
 
 	/* Check if we have read the main header */
-	if(decompressor->getState() != DECOMPRESS_STATE_TPH_SOT)
+	if(!headerRead_ || headerError_)
 	{
 		Logger::logger_.error("Need to read the main header before setting decompress region");
 		return false;
 	}
+	// tile parts have already been parsed for a previous window
+	if(stream_->tell() != codeStreamInfo->getMainHeaderEnd() + MARKER_BYTES &&
+	   !restartTileParts())
+	{
+		Logger::logger_.error("Unable to rewind to first tile part");
+		return false;
+	}
 
 	if(region != grk_rect_single(0, 0, 0, 0))
 	{
@@ -358,7 +373,11 @@ void CodeStreamDecompress::init(grk_decompress_core_params* parameters)
 	cp_.coding_params_.dec_.layers_to_decompress_ = parameters->layers_to_decompress_;
 	cp_.coding_params_.dec_.reduce_ = parameters->reduce;
 	cp_.coding_params_.dec_.randomAccessFlags_ = parameters->randomAccessFlags_;
+	cp_.coding_params_.dec_.streamingBandHeight_ = parameters->streamingBandHeight;
 	tileCache_->setStrategy(parameters->tileCacheStrategy);
+	tileCache_->setMaxBytes(parameters->tileCacheMaxBytes);
+	codeblockCache_.clear();
+	codeblockCache_.init(parameters->codeblockCacheMaxBytes);
 
 	ioBufferCallback = parameters->io_buffer_callback;
 	ioUserData = parameters->io_user_data;
@@ -373,12 +392,6 @@ bool CodeStreamDecompress::decompress(grk_plugin_tile* tile)
 }
 bool CodeStreamDecompress::decompressTile(uint16_t tileIndex)
 {
-	// 1. check if tile has already been decompressed
-	auto entry = tileCache_->get(tileIndex);
-	if(entry && entry->processor && entry->processor->getImage())
-		return true;
-
-	// 2. otherwise, decompress tile
 	if(outputImage_)
 	{
 		/* Copy code stream image information to composite image */
@@ -436,12 +449,40 @@ bool CodeStreamDecompress::decompressTile(uint16_t tileIndex)
 		comp->h = reducedCompBounds.height();
 	}
 	compositeImage->postReadHeader(&cp_);
-	decompressorState_.tilesToDecompress_.schedule(tileIndex);
 
-	// reset tile part numbers, in case we are re-using the same codec object
+	// 1. check if tile has already been decompressed
+	if(canReuseTileImages())
+	{
+		auto key = getTileCacheKey(tileIndex, compositeImage);
+		auto cachedImage = tileCache_->lookup(tileIndex, key);
+		if(cachedImage)
+		{
+			compositeImage->all_components_data_free();
+			for(uint16_t compno = 0; compno < compositeImage->numcomps; ++compno)
+			{
+				if(!GrkImage::allocData(compositeImage->comps + compno))
+					return false;
+			}
+			return compositeImage->composite(cachedImage);
+		}
+	}
+
+	// 2. otherwise, decompress tile
+	// output image bounds belong to previously decompressed tile
+	if(outputImage_)
+	{
+		grk_object_unref(&outputImage_->obj);
+		outputImage_ = nullptr;
+	}
+	// rewind to first tile part, in case we are re-using the same codec object
 	// from previous decompress
-	for(uint32_t i = 0; i < numTilesToDecompress; ++i)
-		cp_.tcps[i].tilePartCounter_ = 0;
+	if(codeStreamInfo && stream_->tell() != codeStreamInfo->getMainHeaderEnd() + MARKER_BYTES &&
+	   !rewindTileParts())
+	{
+		Logger::logger_.error("Unable to rewind to first tile part");
+		return false;
+	}
+	decompressorState_.tilesToDecompress_.schedule(tileIndex);
 
 	/* customization of the decoding */
 	procedure_list_.push_back([this] { return decompressTile(); });
@@ -466,38 +507,56 @@ bool CodeStreamDecompress::decompressTiles(void)
 
 	auto numRequiredThreads =
 		std::min<uint32_t>((uint32_t)ExecSingleton::get()->num_workers(), numTilesToDecompress);
-	if(outputImage_->supportsStripCache(&cp_))
+	bool streamBands = canStreamBands(numTilesToDecompress);
+	if(streamBands)
+	{
+		// one strip per band : strips are stored in reference grid rows, as for tiles
+		auto rows = outputImage_->rowsPerStrip;
+		stripCache_.init((uint32_t)ExecSingleton::get()->num_workers(), 1,
+						 ceildiv<uint32_t>(outputImage_->comps->h, rows),
+						 rows << cp_.coding_params_.dec_.reduce_, cp_.coding_params_.dec_.reduce_,
+						 outputImage_, ioBufferCallback, ioUserData, grkRegisterReclaimCallback_,
+						 true);
+	}
+	else if(outputImage_->supportsStripCache(&cp_))
 	{
 		uint32_t numStrips = cp_.t_grid_height;
+		uint32_t stripHeight = cp_.t_height;
 		if(numTilesToDecompress == 1)
 		{
-			numStrips = (outputImage_->height() + outputImage_->rowsPerStrip - 1) /
-						outputImage_->rowsPerStrip;
+			// strip height is stored in reference grid rows, as for tiles
+			auto rows = outputImage_->rowsPerStrip;
+			numStrips = ceildiv<uint32_t>(outputImage_->comps->h, rows);
+			stripHeight = rows << cp_.coding_params_.dec_.reduce_;
 		}
 		stripCache_.init((uint32_t)ExecSingleton::get()->num_workers(), cp_.t_grid_width, numStrips,
-						 numTilesToDecompress > 1 ? cp_.t_height : outputImage_->rowsPerStrip,
-						 cp_.coding_params_.dec_.reduce_, outputImage_, ioBufferCallback,
-						 ioUserData, grkRegisterReclaimCallback_);
+						 stripHeight, cp_.coding_params_.dec_.reduce_, outputImage_,
+						 ioBufferCallback, ioUserData, grkRegisterReclaimCallback_,
+						 outputImage_->hasMultipleTiles);
 	}
 
 	std::atomic<bool> success(true);
 	std::atomic<uint32_t> numTilesDecompressed(0);
 
-	tf::Executor* executor = nullptr;
-	tf::Task* node = nullptr;
-	tf::Taskflow taskflow;
-	if(numRequiredThreads > 1)
-	{
-		executor = new tf::Executor(numRequiredThreads);
-		node = new tf::Task[numTilesToDecompress];
-		for(uint64_t i = 0; i < numTilesToDecompress; i++)
-			node[i] = taskflow.placeholder();
-	}
+	// Tiles are submitted to the shared executor for T2/T1 decompression
+	// as soon as they have been parsed, so that parsing of subsequent tiles overlaps
+	// with decompression. The number of tiles in flight is bounded, to cap memory usage.
+	bool concurrentTiles = numRequiredThreads > 1;
+	std::mutex inFlightMutex;
+	std::condition_variable inFlightCondition;
+	uint32_t numInFlight = 0;
+	uint32_t maxInFlight = numRequiredThreads * maxTilesInFlightPerThread;
+	auto waitForInFlight = [&inFlightMutex, &inFlightCondition, &numInFlight](uint32_t maxTiles) {
+		std::unique_lock<std::mutex> lk(inFlightMutex);
+		inFlightCondition.wait(lk, [&numInFlight, maxTiles] { return numInFlight <= maxTiles; });
+	};
 	bool breakAfterT1 = false;
 	bool canDecompress = true;
-	uint16_t tileCount = 0;
 	while(!endOfCodeStream() && !breakAfterT1)
 	{
+		// stop parsing as soon as a tile has failed
+		if(!success)
+			break;
 		// 1. parse tile
 		try
 		{
@@ -541,11 +600,21 @@ bool CodeStreamDecompress::decompressTiles(void)
 		// 3. T2 + T1 decompress
 		// once we schedule a processor for T1 compression, we will destroy it
 		// regardless of success or not
-		auto exec = [this, executor, processor, numTilesToDecompress, &numTilesDecompressed,
-					 &success] {
+		auto exec = [this, concurrentTiles, streamBands, processor, numTilesToDecompress,
+					 &numTilesDecompressed, &success] {
 			if(success)
 			{
-				if(!processor->decompressT2T1(outputImage_))
+				// re-use tile image cached by a previous decompress with the same parameters
+				auto key = getTileCacheKey(processor->getIndex(), outputImage_);
+				bool cached = !streamBands && canReuseTileImages() &&
+							  tileCache_->lookup(processor->getIndex(), key);
+				if(cached && !processor->isWholeTileDecompress())
+					cp_.wholeTileDecompress_ = false;
+				bool rc = cached ||
+						  (streamBands ? decompressBands(processor)
+									   : processor->decompressT2T1(outputImage_,
+																   canReuseTileImages()));
+				if(!rc)
 				{
 					Logger::logger_.error("Failed to decompress tile %u/%u", processor->getIndex(),
 										  numTilesToDecompress);
@@ -559,12 +628,9 @@ bool CodeStreamDecompress::decompressTiles(void)
 					{
 						if(outputImage_->supportsStripCache(&cp_))
 						{
-							if(executor)
+							if(concurrentTiles)
 							{
-								uint32_t threadId = executor->num_workers() > 1
-														? (uint32_t)executor->this_worker_id()
-														: 0;
-								if(!stripCache_.ingestTile(threadId, img))
+								if(!stripCache_.ingestTile(ExecSingleton::threadId(), img))
 									success = false;
 							}
 							else
@@ -580,12 +646,33 @@ bool CodeStreamDecompress::decompressTiles(void)
 						}
 					}
 					processor->release(success ? tileCache_->getStrategy() : GRK_TILE_CACHE_NONE);
+					if(success)
+						tileCache_->retain(processor->getIndex(), key);
+					tileCache_->recycle(processor->getIndex());
 				}
 			}
 			return 0;
 		};
-		if(node)
-			node[tileCount++].work(exec);
+		if(concurrentTiles)
+		{
+			// block parsing until there is room in the in-flight window
+			waitForInFlight(maxInFlight - 1);
+			if(!success)
+				break;
+			{
+				std::lock_guard<std::mutex> lk(inFlightMutex);
+				numInFlight++;
+			}
+			ExecSingleton::get()->silent_async(
+				[exec, &inFlightMutex, &inFlightCondition, &numInFlight] {
+					exec();
+					{
+						std::lock_guard<std::mutex> lk(inFlightMutex);
+						numInFlight--;
+					}
+					inFlightCondition.notify_all();
+				});
+		}
 		else
 		{
 			exec();
@@ -607,14 +694,8 @@ bool CodeStreamDecompress::decompressTiles(void)
 			break;
 		}
 	}
-	if(executor)
-	{
-		executor->run(taskflow).wait();
-		delete executor;
-		executor = nullptr;
-		delete[] node;
-		node = nullptr;
-	}
+	if(concurrentTiles)
+		waitForInFlight(0);
 
 	if(!success)
 		goto cleanup;
@@ -632,13 +713,189 @@ bool CodeStreamDecompress::decompressTiles(void)
 							 numTilesToDecompress);
 	}
 cleanup:
-	if(executor)
+	if(concurrentTiles)
+		waitForInFlight(0);
+
+	return success;
+}
+bool CodeStreamDecompress::canStreamBands(uint16_t numTiles)
+{
+	return numTiles == 1 && cp_.coding_params_.dec_.streamingBandHeight_ && !current_plugin_tile &&
+		   outputImage_->supportsStripCache(&cp_) &&
+		   outputImage_->rowsPerStrip < outputImage_->comps->h;
+}
+bool CodeStreamDecompress::decompressBands(TileProcessor* processor)
+{
+	auto reduce = cp_.coding_params_.dec_.reduce_;
+	uint32_t bandRows = outputImage_->rowsPerStrip;
+	uint32_t bandHeight = bandRows << reduce;
+	uint32_t numBands = ceildiv<uint32_t>(outputImage_->comps->h, bandRows);
+	bool rc = true;
+
+	// code blocks straddling a band boundary are needed by both bands, so cache
+	// the coefficients of about two bands, unless caller has set a budget
+	bool transientCache = !codeblockCache_.enabled();
+	if(transientCache)
 	{
-		executor->run(taskflow).wait();
-		delete executor;
-		delete[] node;
+		auto tccp = processor->getTileCodingParams()->tccps;
+		uint64_t rows = bandRows + ((uint64_t)4 << tccp->cblkh);
+		codeblockCache_.init((uint64_t)outputImage_->comps->w * rows * sizeof(int32_t) * 2);
 	}
-	return success;
+
+	// each band is a region : tile components are rebuilt with region windows.
+	// T2 parses all packet headers once, for the first band, and records packet
+	// lengths if there are no PLT markers, so that later bands skip packets
+	// outside of the band without parsing them
+	processor->packetLengthCache.beginRecording();
+	cp_.wholeTileDecompress_ = false;
+	for(uint32_t i = 0; i < numBands && rc; ++i)
+	{
+		processor->release(GRK_TILE_CACHE_NONE);
+		if(!processor->init())
+		{
+			rc = false;
+			break;
+		}
+		auto band = new GrkImage();
+		outputImage_->copyHeader(band);
+		band->y0 = outputImage_->y0 + i * bandHeight;
+		band->y1 = std::min<uint32_t>(outputImage_->y1, band->y0 + bandHeight);
+		rc = band->subsampleAndReduce(reduce) && processor->decompressT2T1(band, false) &&
+			 stripCache_.ingestTile(band);
+		grk_object_unref(&band->obj);
+	}
+	cp_.wholeTileDecompress_ = true;
+	if(transientCache)
+	{
+		codeblockCache_.clear();
+		codeblockCache_.init(0);
+	}
+
+	return rc;
+}
+bool CodeStreamDecompress::rewindTileParts(void)
+{
+	if(!stream_->seek(codeStreamInfo->getMainHeaderEnd() + MARKER_BYTES))
+		return false;
+	curr_marker_ = J2K_MS_SOT;
+	decompressorState_.setState(DECOMPRESS_STATE_TPH_SOT);
+	decompressorState_.lastSotReadPosition = 0;
+	decompressorState_.tilesToDecompress_.init(
+		grk_rect16(0, 0, (uint16_t)cp_.t_grid_width, (uint16_t)cp_.t_grid_height));
+	if(cp_.tlm_markers)
+		cp_.tlm_markers->rewind();
+	for(uint16_t i = 0; i < cp_.t_grid_height * cp_.t_grid_width; ++i)
+	{
+		auto tcp = cp_.tcps + i;
+		tcp->tilePartCounter_ = 0;
+		delete tcp->compressedTileData_;
+		tcp->compressedTileData_ = nullptr;
+		delete[] tcp->ppt_buffer;
+		tcp->ppt_buffer = nullptr;
+		tcp->ppt_data = nullptr;
+		tcp->ppt_data_size = 0;
+		tcp->ppt_len = 0;
+	}
+	// tile images decompressed with the current reduce and layers are retained,
+	// and are re-used if a later request covers the same region of the tile
+	currentTileProcessor_ = nullptr;
+	tileCache_->restart(cp_.coding_params_.dec_.reduce_,
+						cp_.coding_params_.dec_.layers_to_decompress_);
+
+	return true;
+}
+bool CodeStreamDecompress::restartTileParts(void)
+{
+	if(!rewindTileParts())
+		return false;
+	// decoded code blocks are retained by the code block cache
+	if(outputImage_)
+		grk_object_unref(&outputImage_->obj);
+	outputImage_ = nullptr;
+	cp_.wholeTileDecompress_ = true;
+	resetCompositeImage();
+
+	return true;
+}
+void CodeStreamDecompress::resetCompositeImage(void)
+{
+	// restore composite image header, which may have been modified by post processing
+	auto composite = getCompositeImage();
+	auto decompressFormat = composite->decompressFormat;
+	auto forceRGB = composite->forceRGB;
+	auto upsample = composite->upsample;
+	auto precision = composite->precision;
+	auto numPrecision = composite->numPrecision;
+	auto splitByComponent = composite->splitByComponent;
+	composite->all_components_data_free();
+	headerImage_->copyHeader(composite);
+	composite->decompressFormat = decompressFormat;
+	composite->forceRGB = forceRGB;
+	composite->upsample = upsample;
+	composite->precision = precision;
+	composite->numPrecision = numPrecision;
+	composite->splitByComponent = splitByComponent;
+}
+bool CodeStreamDecompress::setReduce(uint8_t reduce)
+{
+	if(!headerRead_ || headerError_)
+	{
+		Logger::logger_.error("Need to read the main header before setting reduce");
+		return false;
+	}
+	for(uint16_t i = 0; i < cp_.t_grid_height * cp_.t_grid_width; ++i)
+	{
+		auto tcp = cp_.tcps + i;
+		for(uint16_t compno = 0; compno < headerImage_->numcomps; ++compno)
+		{
+			auto tccp = tcp->tccps + compno;
+			if(reduce >= tccp->numresolutions)
+			{
+				Logger::logger_.error("Reduce (%u) must be less than number of resolutions "
+									  "(%u) of component %u",
+									  reduce, tccp->numresolutions, compno);
+				return false;
+			}
+		}
+	}
+	cp_.coding_params_.dec_.reduce_ = reduce;
+	SIZMarker siz;
+	siz.subsampleAndReduceHeaderImageComponents(headerImage_, &cp_);
+	// also discards window and tiles from a previous decompress
+	if(!restartTileParts())
+	{
+		Logger::logger_.error("Unable to rewind to first tile part");
+		return false;
+	}
+	getCompositeImage()->postReadHeader(&cp_);
+
+	return true;
+}
+bool CodeStreamDecompress::setLayers(uint16_t layers)
+{
+	if(!headerRead_ || headerError_)
+	{
+		Logger::logger_.error("Need to read the main header before setting layers");
+		return false;
+	}
+	cp_.coding_params_.dec_.layers_to_decompress_ = layers;
+	auto defaultTcp = decompressorState_.default_tcp_;
+	defaultTcp->numLayersToDecompress = layers ? layers : defaultTcp->max_layers_;
+	for(uint16_t i = 0; i < cp_.t_grid_height * cp_.t_grid_width; ++i)
+	{
+		auto tcp = cp_.tcps + i;
+		tcp->numLayersToDecompress = layers ? layers : tcp->max_layers_;
+	}
+	// code blocks decoded from earlier layers are re-used if they receive
+	// no new coding passes
+	if(!restartTileParts())
+	{
+		Logger::logger_.error("Unable to rewind to first tile part");
+		return false;
+	}
+	getCompositeImage()->postReadHeader(&cp_);
+
+	return true;
 }
 bool CodeStreamDecompress::copy_default_tcp(void)
 {
@@ -827,6 +1084,7 @@ bool CodeStreamDecompress::skipNonScheduledTLM(CodingParams* cp)
 		return false;
 
 	cp_.tlm_markers->seek(&decompressorState_.tilesToDecompress_, cp, stream_);
+	cp_.tlm_markers->prefetch(&decompressorState_.tilesToDecompress_, stream_);
 
 	return true;
 }
@@ -846,76 +1104,94 @@ bool CodeStreamDecompress::decompressTile(void)
 	}
 	outputImage_->hasMultipleTiles = false;
 	uint16_t tileIndex = decompressorState_.tilesToDecompress_.getSingle();
-	auto tileCache = tileCache_->get(tileIndex);
-	auto tileProcessor = tileCache ? tileCache->processor : nullptr;
-	if(!tileCache || !tileCache->processor->getImage())
+	// find first tile part
+	try
 	{
-		// find first tile part
-		try
-		{
-			// try to skip non-scheduled tile parts using TLM marker if available
-			if(!skipNonScheduledTLM(&cp_))
-			{
-				// otherwise skip non-scheduled by reading tile headers
-				if(!codeStreamInfo->allocTileInfo((uint16_t)(cp_.t_grid_width * cp_.t_grid_height)))
-					return false;
-				if(!codeStreamInfo->seekFirstTilePart(tileIndex))
-					return false;
-			}
-		}
-		catch(const CorruptTLMException& cte)
+		// try to skip non-scheduled tile parts using TLM marker if available
+		if(!skipNonScheduledTLM(&cp_))
 		{
-			return false;
-		}
-		/* Special case if we have previously read the EOC marker
-		 * (if the previous tile decompressed is the last ) */
-		if(decompressorState_.getState() == DECOMPRESS_STATE_EOC)
-			decompressorState_.setState(DECOMPRESS_STATE_TPH_SOT);
-
-		bool canDecompress = true;
-		try
-		{
-			if(!parseTileParts(&canDecompress))
+			// otherwise skip non-scheduled by reading tile headers
+			if(!codeStreamInfo->allocTileInfo((uint16_t)(cp_.t_grid_width * cp_.t_grid_height)))
+				return false;
+			if(!codeStreamInfo->seekFirstTilePart(tileIndex))
 				return false;
 		}
-		catch(const InvalidMarkerException& ime)
-		{
-			Logger::logger_.error("Found invalid marker : 0x%x", ime.marker_);
+	}
+	catch(const CorruptTLMException& cte)
+	{
+		return false;
+	}
+	/* Special case if we have previously read the EOC marker
+	 * (if the previous tile decompressed is the last ) */
+	if(decompressorState_.getState() == DECOMPRESS_STATE_EOC)
+		decompressorState_.setState(DECOMPRESS_STATE_TPH_SOT);
+
+	bool canDecompress = true;
+	try
+	{
+		if(!parseTileParts(&canDecompress))
 			return false;
-		}
-		tileProcessor = currentTileProcessor_;
-		if(outputImage_->supportsStripCache(&cp_))
-		{
-			uint32_t numStrips = (outputImage_->height() + outputImage_->rowsPerStrip - 1) /
-								 outputImage_->rowsPerStrip;
-			stripCache_.init((uint32_t)ExecSingleton::get()->num_workers(), 1, numStrips,
-							 outputImage_->rowsPerStrip, cp_.coding_params_.dec_.reduce_,
-							 outputImage_, ioBufferCallback, ioUserData,
-							 grkRegisterReclaimCallback_);
-		}
+	}
+	catch(const InvalidMarkerException& ime)
+	{
+		Logger::logger_.error("Found invalid marker : 0x%x", ime.marker_);
+		return false;
+	}
+	auto tileProcessor = currentTileProcessor_;
+	bool stripCache = outputImage_->supportsStripCache(&cp_);
+	if(stripCache)
+	{
+		auto rows = outputImage_->rowsPerStrip;
+		stripCache_.init((uint32_t)ExecSingleton::get()->num_workers(), 1,
+						 ceildiv<uint32_t>(outputImage_->comps->h, rows),
+						 rows << cp_.coding_params_.dec_.reduce_,
+						 cp_.coding_params_.dec_.reduce_, outputImage_, ioBufferCallback,
+						 ioUserData, grkRegisterReclaimCallback_, false);
+	}
 
-		if(!tileProcessor->decompressT2T1(outputImage_))
+	if(!tileProcessor->decompressT2T1(outputImage_, canReuseTileImages()))
+		return false;
+	// retain copy of tile image, unless it has been written to the strip cache
+	if(canReuseTileImages() && !stripCache)
+	{
+		if(!tileProcessor->generateImage(outputImage_))
 			return false;
+		tileCache_->retain(tileIndex, getTileCacheKey(tileIndex, outputImage_));
+	}
 
-		// check for corrupt Adobe images where a final tile part is not parsed
-		// due to incorrectly-signalled number of tile parts
-		try
-		{
-			if(readSOTorEOC() && curr_marker_ == J2K_MS_SOT)
-			{
-				if(checkForIllegalTilePart())
-					return false;
-			}
-		}
-		catch(const InvalidMarkerException& ime)
+	// check for corrupt Adobe images where a final tile part is not parsed
+	// due to incorrectly-signalled number of tile parts
+	try
+	{
+		if(readSOTorEOC() && curr_marker_ == J2K_MS_SOT)
 		{
-			Logger::logger_.error("Found invalid marker : 0x%x", ime.marker_);
-			return false;
+			if(checkForIllegalTilePart())
+				return false;
 		}
 	}
+	catch(const InvalidMarkerException& ime)
+	{
+		Logger::logger_.error("Found invalid marker : 0x%x", ime.marker_);
+		return false;
+	}
 
 	return true;
 }
+bool CodeStreamDecompress::canReuseTileImages(void)
+{
+	auto meta = headerImage_->meta;
+
+	return tileCache_->getStrategy() != GRK_TILE_CACHE_NONE &&
+		   !(meta && (meta->color.palette || meta->color.channel_definition));
+}
+TileCacheKey CodeStreamDecompress::getTileCacheKey(uint16_t tileIndex, GrkImage* image)
+{
+	auto region = cp_.getTileBounds(image, tileIndex % cp_.t_grid_width,
+									tileIndex / cp_.t_grid_width);
+
+	return TileCacheKey(cp_.coding_params_.dec_.reduce_,
+						cp_.coding_params_.dec_.layers_to_decompress_, region);
+}
 bool CodeStreamDecompress::checkForIllegalTilePart(void)
 {
 	try
@@ -23,6 +23,10 @@
 
 namespace grk
 {
+/** maximum number of parsed tiles per worker thread that are waiting for,
+ *  or undergoing, T2/T1 decompression */
+const uint32_t maxTilesInFlightPerThread = 2;
+
 typedef std::function<bool(uint8_t* headerData, uint16_t header_size)> MARKER_FUNC;
 struct marker_handler
 {
@@ -49,8 +53,11 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	std::vector<GrkImage*> getAllImages(void);
 	void init(grk_decompress_core_params* p_param);
 	bool setDecompressRegion(grk_rect_single region);
+	bool setReduce(uint8_t reduce);
+	bool setLayers(uint16_t layers);
 	bool decompress(grk_plugin_tile* tile);
 	bool decompressTile(uint16_t tileIndex);
+	void getTileCacheStats(grk_tile_cache_stats* stats);
 	bool preProcess(void);
 	bool postProcess(void);
 	CodeStreamInfo* getCodeStreamInfo(void);
@@ -100,6 +107,18 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	bool hasTLM(void);
 	void nextTLM(void);
 	bool decompressTiles(void);
+	/**
+	 * Rewind to first tile part, so that a new window can be decompressed
+	 * after tile parts have been parsed for a previous window
+	 *
+	 * @return true if successful
+	 */
+	bool rewindTileParts(void);
+	bool restartTileParts(void);
+	/**
+	 * Restore composite image header from header image
+	 */
+	void resetCompositeImage(void);
 	bool decompressValidation(void);
 	bool copy_default_tcp(void);
 	bool read_unk(void);
@@ -315,6 +334,31 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	const marker_handler* get_marker_handler(uint16_t id);
 
 	bool createOutputImage(void);
+	bool canStreamBands(uint16_t numTiles);
+	/**
+	 * Decompress single tile as a sequence of horizontal band regions,
+	 * passing each band to the strip cache before decompressing the next one
+	 *
+	 * @param processor tile processor
+	 *
+	 * @return true if successful
+	 */
+	bool decompressBands(TileProcessor* processor);
+	/**
+	 * @return true if cached tile images can be re-used in place of decompressing the tile.
+	 * Palette and channel definition post processing modify tile images in place,
+	 * so such images are never re-used.
+	 */
+	bool canReuseTileImages(void);
+	/**
+	 * Get tile cache key for tile decompressed into image with current parameters
+	 *
+	 * @param tileIndex tile index
+	 * @param image output image, whose bounds are the decompress region
+	 *
+	 * @return tile cache key
+	 */
+	TileCacheKey getTileCacheKey(uint16_t tileIndex, GrkImage* image);
 	bool checkForIllegalTilePart(void);
 
 	std::map<uint16_t, marker_handler*> marker_map;
@@ -328,6 +372,7 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	GrkImage* outputImage_;
 	TileCache* tileCache_;
 	StripCache stripCache_;
+	CodeblockCache codeblockCache_;
 	grk_io_pixels_callback ioBufferCallback;
 	void* ioUserData;
 	grk_io_register_reclaim_callback grkRegisterReclaimCallback_;
@@ -236,6 +236,8 @@ struct DecodingParams
 	uint16_t layers_to_decompress_;
 
 	uint32_t randomAccessFlags_;
+	/** if != 0, then single-tile images are streamed in bands of this height */
+	uint32_t streamingBandHeight_;
 };
 
 /**
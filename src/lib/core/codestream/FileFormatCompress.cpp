@@ -926,6 +926,10 @@ uint64_t FileFormatCompress::compress(grk_plugin_tile* tile)
 
 	return rc;
 }
+bool FileFormatCompress::pushRows(const int32_t* const* rows, uint32_t stride, uint32_t numRows)
+{
+	return codeStream->pushRows(rows, stride, numRows);
+}
 bool FileFormatCompress::end(void)
 {
 	/* write header */
@@ -31,6 +31,7 @@ class FileFormatCompress : public FileFormat, public ICodeStreamCompress
 	bool init(grk_cparameters* p_param, GrkImage* p_image);
 	bool start(void);
 	uint64_t compress(grk_plugin_tile* tile);
+	bool pushRows(const int32_t* const* rows, uint32_t stride, uint32_t numRows);
 
   private:
 	bool end(void);
@@ -103,6 +103,10 @@ GrkImage* FileFormatDecompress::getImage(void)
 {
 	return codeStream->getImage();
 }
+void FileFormatDecompress::getTileCacheStats(grk_tile_cache_stats* stats)
+{
+	codeStream->getTileCacheStats(stats);
+}
 grk_color* FileFormatDecompress::getColour(void)
 {
 	auto image = codeStream->getHeaderImage();
@@ -266,6 +270,14 @@ bool FileFormatDecompress::setDecompressRegion(grk_rect_single region)
 {
 	return codeStream->setDecompressRegion(region);
 }
+bool FileFormatDecompress::setReduce(uint8_t reduce)
+{
+	return codeStream->setReduce(reduce);
+}
+bool FileFormatDecompress::setLayers(uint16_t layers)
+{
+	return codeStream->setLayers(layers);
+}
 /** Set up decompressor function handler */
 void FileFormatDecompress::init(grk_decompress_core_params* parameters)
 {
@@ -35,8 +35,11 @@ class FileFormatDecompress : public FileFormat, public ICodeStreamDecompress
 	GrkImage* getImage(void);
 	void init(grk_decompress_core_params* p_param);
 	bool setDecompressRegion(grk_rect_single region);
+	bool setReduce(uint8_t reduce);
+	bool setLayers(uint16_t layers);
 	bool decompress(grk_plugin_tile* tile);
 	bool decompressTile(uint16_t tileIndex);
+	void getTileCacheStats(grk_tile_cache_stats* stats);
 	bool end(void);
 	bool postProcess(void);
 	bool preProcess(void);
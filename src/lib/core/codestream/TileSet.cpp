@@ -18,6 +18,7 @@ void TileSet::init(grk_rect16 allTiles)
 void TileSet::schedule(grk_rect16 tiles)
 {
 	tilesToDecompress_.clear();
+	tilesDecompressed_.clear();
 	assert(!tiles.empty());
 	for(uint16_t j = tiles.y0; j < tiles.y1; ++j)
 	{
@@ -33,6 +34,7 @@ void TileSet::schedule(grk_pt16 tile)
 void TileSet::schedule(uint16_t tileIndex)
 {
 	tilesToDecompress_.clear();
+	tilesDecompressed_.clear();
 	tilesToDecompress_.insert(tileIndex);
 	lastTileToDecompress_ = tileIndex;
 }
@@ -47,7 +47,12 @@ class SIZMarker
 	 */
 	bool write(CodeStreamCompress* codeStream, BufferedStream* stream);
 
-  private:
+	/**
+	 * Apply sub-sampling and resolution reduction to header image components
+	 *
+	 * @param       headerImage   header image
+	 * @param       p_cp          coding parameters
+	 */
 	void subsampleAndReduceHeaderImageComponents(GrkImage* headerImage, const CodingParams* p_cp);
 };
 
@@ -85,6 +85,7 @@
 #include "simd.h"
 #include "ThreadPool.hpp"
 #include "packer.h"
+#include "Interleaver.h"
 #include "MinHeap.h"
 #include "SequentialCache.h"
 #include "SparseCache.h"
@@ -104,6 +105,8 @@
 #include "GrkMatrix.h"
 #include "GrkImage.h"
 #include "StripCache.h"
+#include "CodeblockCache.h"
+#include "TileCache.h"
 #include "grk_exceptions.h"
 #include "SparseBuffer.h"
 #include "BitIO.h"
@@ -146,13 +149,13 @@
 #include "TileComponent.h"
 #include "mct.h"
 #include "TileProcessor.h"
-#include "TileCache.h"
 #include "T2Compress.h"
 #include "T2Decompress.h"
 #include "grk_intmath.h"
 #include "plugin_bridge.h"
 #include "RateControl.h"
 #include "RateInfo.h"
+#include "PacketSizeModel.h"
 #include "T1Factory.h"
 #include "DecompressScheduler.h"
 #include "CompressScheduler.h"
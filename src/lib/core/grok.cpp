@@ -122,6 +122,11 @@ void GRK_CALLCONV grk_initialize(const char* pluginPath, uint32_t numthreads, bo
 	}
 }
 
+GRK_API void GRK_CALLCONV grk_set_memory_flags(uint32_t flags)
+{
+	grk_set_allocation_flags(flags);
+}
+
 GRK_API void GRK_CALLCONV grk_deinitialize()
 {
 	grk_plugin_cleanup();
@@ -176,6 +181,15 @@ static size_t grk_write_to_file(const uint8_t* buffer, size_t numBytes, void* p_
 {
 	return fwrite(buffer, 1, numBytes, (FILE*)p_file);
 }
+static void grk_prefetch_from_file([[maybe_unused]] uint64_t offset,
+								   [[maybe_unused]] uint64_t numBytes,
+								   [[maybe_unused]] void* p_file)
+{
+#ifdef POSIX_FADV_WILLNEED
+	posix_fadvise(fileno((FILE*)p_file), (off_t)offset, (off_t)numBytes, POSIX_FADV_WILLNEED);
+#endif
+}
+
 static bool grk_seek_in_file(uint64_t numBytes, void* p_user_data)
 {
 	if(numBytes > INT64_MAX)
@@ -368,6 +382,24 @@ bool GRK_CALLCONV grk_decompress_set_window(grk_codec* codecWrapper, float start
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_decompress_set_reduce(grk_codec* codecWrapper, uint8_t reduce)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->decompressor_ ? codec->decompressor_->setReduce(reduce) : false;
+	}
+	return false;
+}
+bool GRK_CALLCONV grk_decompress_set_layers(grk_codec* codecWrapper, uint16_t layers)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->decompressor_ ? codec->decompressor_->setLayers(layers) : false;
+	}
+	return false;
+}
 bool GRK_CALLCONV grk_decompress(grk_codec* codecWrapper, grk_plugin_tile* tile)
 {
 	if(codecWrapper)
@@ -391,6 +423,20 @@ bool GRK_CALLCONV grk_decompress_tile(grk_codec* codecWrapper, uint16_t tileInde
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_decompress_get_tile_cache_stats(grk_codec* codecWrapper,
+													  grk_tile_cache_stats* stats)
+{
+	if(codecWrapper && stats)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		if(!codec->decompressor_)
+			return false;
+		codec->decompressor_->getTileCacheStats(stats);
+
+		return true;
+	}
+	return false;
+}
 void GRK_CALLCONV grk_dump_codec(grk_codec* codecWrapper, uint32_t info_flag, FILE* output_stream)
 {
 	assert(codecWrapper);
@@ -564,6 +610,16 @@ static bool grk_compress_start(grk_codec* codecWrapper)
 	return false;
 }
 
+bool GRK_CALLCONV grk_compress_push_rows(grk_codec* codecWrapper, const int32_t* const* rows,
+										 uint32_t stride, uint32_t numRows)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->compressor_ ? codec->compressor_->pushRows(rows, stride, numRows) : false;
+	}
+	return false;
+}
 uint64_t GRK_CALLCONV grk_compress(grk_codec* codecWrapper, grk_plugin_tile* tile)
 {
 	if(codecWrapper)
@@ -627,6 +683,8 @@ static grk_stream* grk_stream_create_file_stream(const char* fname, size_t buffe
 	grk_stream_set_read_function(stream, grk_read_from_file);
 	grk_stream_set_write_function(stream, grk_write_to_file);
 	grk_stream_set_seek_function(stream, grk_seek_in_file);
+	if(is_read_stream && !stdin_stdout)
+		grk_stream_set_prefetch_function(stream, grk_prefetch_from_file);
 	return stream;
 }
 
@@ -905,6 +963,12 @@ void grk_stream_set_seek_function(grk_stream* stream, grk_stream_seek_fn func)
 	if(streamImpl)
 		streamImpl->setSeekFunction(func);
 }
+void grk_stream_set_prefetch_function(grk_stream* stream, grk_stream_prefetch_fn func)
+{
+	auto streamImpl = BufferedStream::getImpl(stream);
+	if(streamImpl)
+		streamImpl->setPrefetchFunction(func);
+}
 void grk_stream_set_write_function(grk_stream* stream, grk_stream_write_fn func)
 {
 	auto streamImpl = BufferedStream::getImpl(stream);
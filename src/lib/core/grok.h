@@ -194,11 +194,16 @@ typedef struct _grk_raw_cparameters
  * Rate control algorithms
 	GRK_RATE_CONTROL_BISECT: bisect with all truncation points
 	GRK_RATE_CONTROL_PCRD_OPT: bisect with only feasible truncation points
+	GRK_RATE_CONTROL_PCRD_OPT_IMAGE: bisect with only feasible truncation points,
+	using one threshold per layer for all tiles of the image. Only applies to compression
+	ratios without a maximum component size, and not when rows are pushed : otherwise,
+	GRK_RATE_CONTROL_PCRD_OPT is used, with a warning
  */
 typedef enum _GRK_RATE_CONTROL_ALGORITHM
 {
 	GRK_RATE_CONTROL_BISECT,
-	GRK_RATE_CONTROL_PCRD_OPT
+	GRK_RATE_CONTROL_PCRD_OPT,
+	GRK_RATE_CONTROL_PCRD_OPT_IMAGE
 } GRK_RATE_CONTROL_ALGORITHM;
 
 /**
@@ -475,9 +480,22 @@ typedef struct _grk_stream_params
 typedef enum _GRK_TILE_CACHE_STRATEGY
 {
 	GRK_TILE_CACHE_NONE, /* no tile caching */
-	GRK_TILE_CACHE_IMAGE /* cache final tile image */
+	GRK_TILE_CACHE_IMAGE, /* cache final tile image */
+	GRK_TILE_CACHE_LRU /* cache final tile image, evicting least recently used
+						  tile images once cache exceeds tileCacheMaxBytes */
 } GRK_TILE_CACHE_STRATEGY;
 
+/**
+ * Tile cache statistics
+ */
+typedef struct _grk_tile_cache_stats
+{
+	uint64_t hits; /* number of tile requests served from cache */
+	uint64_t misses; /* number of tile requests that required decompression */
+	uint64_t evictions; /* number of tile images evicted from cache */
+	uint64_t bytes; /* number of bytes currently held by cached tile images */
+} grk_tile_cache_stats;
+
 /**
  * Core decompression parameters
  * */
@@ -498,7 +516,34 @@ typedef struct _grk_decompress_core_params
 	 used, all the quality layers are decompressed
 	 */
 	uint16_t layers_to_decompress_;
+	/**
+	 Tile cache strategy. Cached tile images are re-used by later decompress calls on the
+	 same codec, when a tile is requested again with the same reduce, layers and window
+	 region over the tile.
+	 */
 	GRK_TILE_CACHE_STRATEGY tileCacheStrategy;
+	/**
+	 Maximum number of bytes held by cached tile images, when using
+	 GRK_TILE_CACHE_LRU strategy. If zero, cache size is unbounded.
+	 */
+	uint64_t tileCacheMaxBytes;
+	/**
+	 Maximum number of bytes held by cached T1-decoded code block coefficients.
+	 When decompressing successive windows from the same codec, code blocks that
+	 were already decoded for a previous window are not decoded again.
+	 If zero, code block coefficients are not cached.
+	 */
+	uint64_t codeblockCacheMaxBytes;
+	/**
+	 Height in reference grid rows of the horizontal bands used to stream a single-tile
+	 image to the strip cache, rounded up to a multiple of 2^reduce. Each band is
+	 decompressed as a region and written out before the next band is decompressed,
+	 so that peak memory is bounded by image width times band height (plus wavelet
+	 filter margins), rather than by image area. Code blocks that straddle two bands are
+	 decoded once and cached, within a budget of about two bands of coefficients if
+	 codeblockCacheMaxBytes is not set. If zero, a single-tile image is decompressed in one pass.
+	 */
+	uint32_t streamingBandHeight;
 
 	uint32_t randomAccessFlags_;
 
@@ -568,6 +613,7 @@ typedef struct _grk_decompress_params
 	uint32_t kernelBuildOptions;
 	uint32_t repeats;
 	uint32_t numThreads;
+	uint32_t memoryFlags; /* combination of GRK_MEMORY_* flags */
 	void* user_data;
 } grk_decompress_parameters;
 
@@ -764,6 +810,24 @@ GRK_API const char* GRK_CALLCONV grk_version(void);
  */
 GRK_API void GRK_CALLCONV grk_initialize(const char* pluginPath, uint32_t numthreads, bool verbose);
 
+/**
+ * Memory flags for large buffers allocated by the library (Linux only)
+ *
+ * GRK_MEMORY_HUGE_PAGES: back large buffers with transparent huge pages,
+ * reducing TLB misses in the wavelet passes
+ * GRK_MEMORY_NUMA_INTERLEAVE: interleave pages of large buffers across NUMA nodes,
+ * so that workers on all nodes share memory bandwidth of a buffer that spans the image
+ */
+#define GRK_MEMORY_HUGE_PAGES (1 << 0)
+#define GRK_MEMORY_NUMA_INTERLEAVE (1 << 1)
+
+/**
+ * Set memory flags. Only affects buffers allocated after this call.
+ *
+ * @param flags combination of GRK_MEMORY_* flags, or zero for default allocation
+ */
+GRK_API void GRK_CALLCONV grk_set_memory_flags(uint32_t flags);
+
 /**
  * De-initialize library
  */
@@ -877,6 +941,8 @@ GRK_API grk_image* GRK_CALLCONV grk_decompress_get_composited_image(grk_codec* c
 /**
  * Set the given area to be decompressed. This function should be called
  * right after grk_decompress_read_header is called, and before any tile header is read.
+ * It may also be called after a previous call to grk_decompress, in order to
+ * decompress another area with the same codec.
  *
  * @param	codec			decompression codec
  * @param	start_x		    left position of the rectangle to decompress (in image coordinates).
@@ -890,6 +956,36 @@ GRK_API grk_image* GRK_CALLCONV grk_decompress_get_composited_image(grk_codec* c
 GRK_API bool GRK_CALLCONV grk_decompress_set_window(grk_codec* codec, float start_x, float start_y,
 													float end_x, float end_y);
 
+/**
+ * Set number of highest resolution levels to be discarded. This function should be called
+ * after grk_decompress_read_header, and may also be called after a previous call
+ * to grk_decompress, in order to decompress the image at another resolution
+ * with the same codec. If the code block cache is enabled, resolutions reconstructed
+ * by a previous whole tile decompress are re-used when decompressing at a higher resolution.
+ * A window set by grk_decompress_set_window must be set again after calling this function.
+ *
+ * @param	codec			decompression codec
+ * @param	reduce			number of highest resolution levels to be discarded
+ *
+ * @return	true			if reduce could be set.
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_set_reduce(grk_codec* codec, uint8_t reduce);
+
+/**
+ * Set number of quality layers to be decompressed. This function should be called
+ * after grk_decompress_read_header, and may also be called after a previous call
+ * to grk_decompress, in order to progressively refine the image quality with the
+ * same codec. If the code block cache is enabled, code blocks that receive no new coding
+ * passes from the additional layers are not decoded again.
+ * A window set by grk_decompress_set_window must be set again after calling this function.
+ *
+ * @param	codec			decompression codec
+ * @param	layers			number of layers to decompress; zero signifies all layers
+ *
+ * @return	true			if layers could be set.
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_set_layers(grk_codec* codec, uint16_t layers);
+
 /**
  * Decompress image from a JPEG 2000 code stream
  *
@@ -910,6 +1006,17 @@ GRK_API bool GRK_CALLCONV grk_decompress(grk_codec* codec, grk_plugin_tile* tile
  */
 GRK_API bool GRK_CALLCONV grk_decompress_tile(grk_codec* codec, uint16_t tileIndex);
 
+/**
+ * Get tile cache statistics
+ *
+ * @param	codec			decompression codec
+ * @param	stats			tile cache statistics
+ *
+ * @return					true if successful, otherwise false
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_get_tile_cache_stats(grk_codec* codec,
+															  grk_tile_cache_stats* stats);
+
 /* COMPRESSION FUNCTIONS*/
 
 /**
@@ -1071,6 +1178,30 @@ GRK_API void GRK_CALLCONV grk_compress_set_default_params(grk_cparameters* param
 GRK_API grk_codec* GRK_CALLCONV grk_compress_init(grk_stream_params* stream_params,
 												  grk_cparameters* parameters, grk_image* p_image);
 
+/**
+ * Push the next rows of an image to a compressor that was initialized with an image
+ * without component data. Rows must be pushed in order, from the top of the image.
+ * Each row of tiles is transformed and compressed as its rows arrive, and written once
+ * it is complete. Samples are buffered one row of code blocks at a time for each
+ * resolution, but rate control needs all compressed code blocks of a tile, so these
+ * are buffered until the row of tiles is written. Memory is therefore proportional to
+ * image width times tile height : a single-tile image buffers the compressed data of
+ * the whole image.
+ * Once all rows have been pushed, call grk_compress to finish the code stream.
+ *
+ * Components must not be subsampled, and a custom multi-component transform
+ * is not supported.
+ *
+ * @param codec 		compression codec
+ * @param rows 			one pointer per component, to the first sample of the first row
+ * @param stride 		stride of rows, in samples
+ * @param numRows 		number of rows
+ *
+ * @return 				true if successful
+ */
+GRK_API bool GRK_CALLCONV grk_compress_push_rows(grk_codec* codec, const int32_t* const* rows,
+												 uint32_t stride, uint32_t numRows);
+
 /**
  * Compress an image into a JPEG 2000 code stream using plugin
  *
@@ -36,6 +36,10 @@ typedef size_t (*grk_stream_write_fn)(const uint8_t* buffer, size_t numBytes, vo
  * (absolute) seek callback
  */
 typedef bool (*grk_stream_seek_fn)(uint64_t numBytes, void* user_data);
+/*
+ * prefetch callback: start asynchronous read-ahead of a byte range
+ */
+typedef void (*grk_stream_prefetch_fn)(uint64_t offset, uint64_t numBytes, void* user_data);
 /*
  *  free user data callback
  */
@@ -65,6 +69,14 @@ void grk_stream_set_write_function(grk_stream* stream, grk_stream_write_fn func)
  */
 void grk_stream_set_seek_function(grk_stream* stream, grk_stream_seek_fn func);
 
+/**
+ * Set prefetch function (optional)
+ *
+ * @param       stream      JPEG 2000 stream
+ * @param       func        prefetch function.
+ */
+void grk_stream_set_prefetch_function(grk_stream* stream, grk_stream_prefetch_fn func);
+
 /**
  * Set user data for JPEG 2000 stream
  *
@@ -57,9 +57,11 @@ namespace HWY_NAMESPACE
 				auto ni = Clamp(NearestInt(Load(df, chan0 + j)) + vshift, vmin, vmax);
 				Store(ni, di, (int32_t*)(chan0 + j));
 			}
-			if(info.stripCache_->isInitialized() && !info.stripCache_->isMultiTile())
-				info.stripCache_->ingestStrip(ExecSingleton::threadId(), info.tile, info.yBegin,
-											  info.yEnd);
+			if(info.stripCache_->isInitialized() && !info.stripCache_->isMultiTile() &&
+			   info.tile->numcomps_ == 1 &&
+			   !info.stripCache_->ingestStrip(ExecSingleton::threadId(), info.tile, info.yBegin,
+											  info.yEnd))
+				*info.success = false;
 		}
 	};
 
@@ -90,12 +92,131 @@ namespace HWY_NAMESPACE
 				auto ni = Clamp(Load(di, chan0 + j) + vshift, vmin, vmax);
 				Store(ni, di, chan0 + j);
 			}
-			if(info.stripCache_->isInitialized() && !info.stripCache_->isMultiTile())
-				info.stripCache_->ingestStrip(ExecSingleton::threadId(), info.tile, info.yBegin,
-											  info.yEnd);
+			if(info.stripCache_->isInitialized() && !info.stripCache_->isMultiTile() &&
+			   info.tile->numcomps_ == 1 &&
+			   !info.stripCache_->ingestStrip(ExecSingleton::threadId(), info.tile, info.yBegin,
+											  info.yEnd))
+				*info.success = false;
 		}
 	};
 
+	/**
+	 * Store one vector each of r, g and b samples as interleaved samples of an 8 or 16 bit
+	 * packer. As with the scalar packers, samples are truncated to the packed width.
+	 */
+	template<class D, class V>
+	HWY_INLINE void pack_rgb(D di, V r, V g, V b, uint8_t packer, uint8_t* dest)
+	{
+		if(packer == 8)
+		{
+			const Rebind<uint8_t, D> d8;
+			const auto mask = Set(di, 0xFF);
+			StoreInterleaved3(DemoteTo(d8, And(r, mask)), DemoteTo(d8, And(g, mask)),
+							  DemoteTo(d8, And(b, mask)), d8, dest);
+		}
+		else
+		{
+			const Rebind<uint16_t, D> d16;
+			const auto mask = Set(di, 0xFFFF);
+			auto r16 = DemoteTo(d16, And(r, mask));
+			auto g16 = DemoteTo(d16, And(g, mask));
+			auto b16 = DemoteTo(d16, And(b, mask));
+			if(packer == packer16BitBE)
+			{
+				r16 = Or(ShiftLeft<8>(r16), ShiftRight<8>(r16));
+				g16 = Or(ShiftLeft<8>(g16), ShiftRight<8>(g16));
+				b16 = Or(ShiftLeft<8>(b16), ShiftRight<8>(b16));
+			}
+			StoreInterleaved3(r16, g16, b16, d16, (uint16_t*)dest);
+		}
+	}
+
+	/**
+	 * Apply inverse MCT to rows [yBegin, yEnd) of a single tile image, and write the
+	 * samples back to the tile. When the strip cache can take them directly, also
+	 * interleave and pack them into a strip buffer in the same pass.
+	 *
+	 * op(j, r, g, b) sets r, g and b to the clamped, dc shifted samples at index j
+	 *
+	 * @return false if the strip could not be written to the strip cache
+	 */
+	template<class OP>
+	HWY_INLINE bool decompress_rows(const ScheduleInfo& info, int32_t* chan0, int32_t* chan1,
+									int32_t* chan2, OP op)
+	{
+		const HWY_FULL(int32_t) di;
+		const uint32_t N = (uint32_t)Lanes(di);
+		auto tilec = info.tile->comps + info.compno;
+		uint64_t stride = tilec->getWindow()->getResWindowBufferHighestStride();
+		uint32_t width = (tilec->resolutions_ + tilec->highestResolutionDecompressed)->width();
+		auto cache = info.stripCache_;
+		uint8_t packer = 0;
+		if(cache->isInitialized() && !cache->isMultiTile())
+			packer = cache->getInterleavePacker(3, width);
+		if(!packer)
+		{
+			auto begin = (uint64_t)info.yBegin * stride;
+			auto end = (uint64_t)info.yEnd * stride;
+			for(auto j = begin; j < end; j += N)
+			{
+				decltype(Zero(di)) r, g, b;
+				op(j, r, g, b);
+				Store(r, di, chan0 + j);
+				Store(g, di, chan1 + j);
+				Store(b, di, chan2 + j);
+			}
+			if(cache->isInitialized() && !cache->isMultiTile() &&
+			   !cache->ingestStrip(ExecSingleton::threadId(), info.tile, info.yBegin, info.yEnd))
+			{
+				*info.success = false;
+				return false;
+			}
+			return true;
+		}
+		auto threadId = ExecSingleton::threadId();
+		GrkIOBuf buf;
+		if(!cache->getStripBuffer(threadId, info.yBegin, info.yEnd, buf))
+		{
+			*info.success = false;
+			return false;
+		}
+		const uint32_t pixelBytes = packer == 8 ? 3 : 6;
+		auto dest = buf.data_;
+		for(uint32_t y = info.yBegin; y < info.yEnd; ++y)
+		{
+			auto src = (uint64_t)y * stride;
+			uint32_t x = 0;
+			decltype(Zero(di)) r, g, b;
+			for(; x + N <= width; x += N)
+			{
+				op(src + x, r, g, b);
+				Store(r, di, chan0 + src + x);
+				Store(g, di, chan1 + src + x);
+				Store(b, di, chan2 + src + x);
+				pack_rgb(di, r, g, b, packer, dest + x * pixelBytes);
+			}
+			// tile rows are padded to whole vectors, but strip rows are not
+			if(x < width)
+			{
+				HWY_ALIGN uint8_t tail[6 * HWY_MAX_BYTES / sizeof(int32_t)];
+				op(src + x, r, g, b);
+				Store(r, di, chan0 + src + x);
+				Store(g, di, chan1 + src + x);
+				Store(b, di, chan2 + src + x);
+				pack_rgb(di, r, g, b, packer, tail);
+				memcpy(dest + x * pixelBytes, tail, (width - x) * pixelBytes);
+			}
+			dest += (uint64_t)width * pixelBytes;
+		}
+		if(!cache->ingestStrip(threadId, buf))
+		{
+			*info.success = false;
+			return false;
+		}
+
+		return true;
+	}
+
 	/**
 	 * Apply MCT with optional DC shift to reversible decompressed image
 	 */
@@ -104,10 +225,6 @@ namespace HWY_NAMESPACE
 	  public:
 		void transform(ScheduleInfo info)
 		{
-			auto highestResBufferStride =
-				info.tile->comps[info.compno].getWindow()->getResWindowBufferHighestStride();
-			auto index = (uint64_t)info.yBegin * highestResBufferStride;
-			auto chunkSize = (uint64_t)(info.yEnd - info.yBegin) * highestResBufferStride;
 			const std::vector<ShiftInfo>& shiftInfo = info.shiftInfo;
 			auto chan0 = info.tile->comps[0].getWindow()->getResWindowBufferHighestSimple().buf_;
 			auto chan1 = info.tile->comps[1].getWindow()->getResWindowBufferHighestSimple().buf_;
@@ -127,19 +244,15 @@ namespace HWY_NAMESPACE
 			auto maxg = Set(di, _max[1]);
 			auto maxb = Set(di, _max[2]);
 
-			size_t begin = index;
-			for(auto j = begin; j < begin + chunkSize; j += Lanes(di))
-			{
+			decompress_rows(info, chan0, chan1, chan2, [&](size_t j, auto& r, auto& g, auto& b) {
 				auto y = Load(di, chan0 + j);
 				auto u = Load(di, chan1 + j);
 				auto v = Load(di, chan2 + j);
-				auto g = y - ShiftRight<2>(u + v);
-				auto r = v + g;
-				auto b = u + g;
-				Store(Clamp(r + vdcr, minr, maxr), di, chan0 + j);
-				Store(Clamp(g + vdcg, ming, maxg), di, chan1 + j);
-				Store(Clamp(b + vdcb, minb, maxb), di, chan2 + j);
-			}
+				g = y - ShiftRight<2>(u + v);
+				r = Clamp(v + g + vdcr, minr, maxr);
+				b = Clamp(u + g + vdcb, minb, maxb);
+				g = Clamp(g + vdcg, ming, maxg);
+			});
 		}
 	};
 
@@ -151,19 +264,11 @@ namespace HWY_NAMESPACE
 	  public:
 		void transform(ScheduleInfo info)
 		{
-			auto highestResBufferStride =
-				info.tile->comps[info.compno].getWindow()->getResWindowBufferHighestStride();
-			auto index = (uint64_t)info.yBegin * highestResBufferStride;
-			auto chunkSize = (uint64_t)(info.yEnd - info.yBegin) * highestResBufferStride;
 			const std::vector<ShiftInfo>& shiftInfo = info.shiftInfo;
 			auto chan0 = info.tile->comps[0].getWindow()->getResWindowBufferHighestSimpleF().buf_;
 			auto chan1 = info.tile->comps[1].getWindow()->getResWindowBufferHighestSimpleF().buf_;
 			auto chan2 = info.tile->comps[2].getWindow()->getResWindowBufferHighestSimpleF().buf_;
 
-			auto c0 = (int32_t*)chan0;
-			auto c1 = (int32_t*)chan1;
-			auto c2 = (int32_t*)chan2;
-
 			const HWY_FULL(float) df;
 			const HWY_FULL(int32_t) di;
 
@@ -185,23 +290,90 @@ namespace HWY_NAMESPACE
 			auto vgv = Set(df, 0.71414f);
 			auto vbu = Set(df, 1.772f);
 
-			size_t begin = index;
-			for(auto j = begin; j < begin + chunkSize; j += Lanes(di))
-			{
-				auto vy = Load(df, chan0 + j);
-				auto vu = Load(df, chan1 + j);
-				auto vv = Load(df, chan2 + j);
-				auto vr = vy + vv * vrv;
-				auto vg = vy - vu * vgu - vv * vgv;
-				auto vb = vy + vu * vbu;
-
-				Store(Clamp(NearestInt(vr) + vdcr, minr, maxr), di, c0 + j);
-				Store(Clamp(NearestInt(vg) + vdcg, ming, maxg), di, c1 + j);
-				Store(Clamp(NearestInt(vb) + vdcb, minb, maxb), di, c2 + j);
-			}
+			decompress_rows(info, (int32_t*)chan0, (int32_t*)chan1, (int32_t*)chan2,
+							[&](size_t j, auto& r, auto& g, auto& b) {
+								auto vy = Load(df, chan0 + j);
+								auto vu = Load(df, chan1 + j);
+								auto vv = Load(df, chan2 + j);
+								auto vr = vy + vv * vrv;
+								auto vg = vy - vu * vgu - vv * vgv;
+								auto vb = vy + vu * vbu;
+
+								r = Clamp(NearestInt(vr) + vdcr, minr, maxr);
+								g = Clamp(NearestInt(vg) + vdcg, ming, maxg);
+								b = Clamp(NearestInt(vb) + vdcb, minb, maxb);
+							});
 		}
 	};
 
+	/**
+	 * Forward reversible MCT with dc shift on samples [begin, end) of three channels,
+	 * processed in whole vectors
+	 */
+	HWY_INLINE void compress_rev_samples(int32_t* chan0, int32_t* chan1, int32_t* chan2,
+										 size_t begin, size_t end, const int32_t* shift)
+	{
+		const HWY_FULL(int32_t) di;
+		auto vdcr = Set(di, shift[0]);
+		auto vdcg = Set(di, shift[1]);
+		auto vdcb = Set(di, shift[2]);
+
+		for(auto j = begin; j < end; j += Lanes(di))
+		{
+			auto r = Load(di, chan0 + j) + vdcr;
+			auto g = Load(di, chan1 + j) + vdcg;
+			auto b = Load(di, chan2 + j) + vdcb;
+			auto y = ShiftRight<2>((g + g) + b + r);
+			auto u = b - g;
+			auto v = r - g;
+			Store(y, di, chan0 + j);
+			Store(u, di, chan1 + j);
+			Store(v, di, chan2 + j);
+		}
+	}
+
+	/**
+	 * Forward irreversible MCT with dc shift on samples [begin, end) of three channels,
+	 * processed in whole vectors. Output is floating point.
+	 */
+	HWY_INLINE void compress_irrev_samples(int32_t* chan0, int32_t* chan1, int32_t* chan2,
+										   size_t begin, size_t end, const int32_t* shift)
+	{
+		const float a_r = 0.299f;
+		const float a_g = 0.587f;
+		const float a_b = 0.114f;
+		const float cb = 0.5f / (1.0f - a_b);
+		const float cr = 0.5f / (1.0f - a_r);
+
+		const HWY_FULL(float) df;
+		const HWY_FULL(int32_t) di;
+
+		auto va_r = Set(df, a_r);
+		auto va_g = Set(df, a_g);
+		auto va_b = Set(df, a_b);
+		auto vcb = Set(df, cb);
+		auto vcr = Set(df, cr);
+
+		auto vdcr = Set(di, shift[0]);
+		auto vdcg = Set(di, shift[1]);
+		auto vdcb = Set(di, shift[2]);
+
+		for(auto j = begin; j < end; j += Lanes(di))
+		{
+			auto r = ConvertTo(df, Load(di, chan0 + j) + vdcr);
+			auto g = ConvertTo(df, Load(di, chan1 + j) + vdcg);
+			auto b = ConvertTo(df, Load(di, chan2 + j) + vdcb);
+
+			auto y = va_r * r + va_g * g + va_b * b;
+			auto u = vcb * (b - y);
+			auto v = vcr * (r - y);
+
+			Store(y, df, (float*)(chan0 + j));
+			Store(u, df, (float*)(chan1 + j));
+			Store(v, df, (float*)(chan2 + j));
+		}
+	}
+
 	/**
 	 * Apply MCT with optional DC shift to reversible compressed image
 	 */
@@ -218,27 +390,9 @@ namespace HWY_NAMESPACE
 			auto chan0 = info.tile->comps[0].getWindow()->getResWindowBufferHighestSimple().buf_;
 			auto chan1 = info.tile->comps[1].getWindow()->getResWindowBufferHighestSimple().buf_;
 			auto chan2 = info.tile->comps[2].getWindow()->getResWindowBufferHighestSimple().buf_;
-
-			const HWY_FULL(int32_t) di;
 			int32_t shift[3] = {shiftInfo[0]._shift, shiftInfo[1]._shift, shiftInfo[2]._shift};
 
-			auto vdcr = Set(di, shift[0]);
-			auto vdcg = Set(di, shift[1]);
-			auto vdcb = Set(di, shift[2]);
-
-			size_t begin = index;
-			for(auto j = begin; j < begin + chunkSize; j += Lanes(di))
-			{
-				auto r = Load(di, chan0 + j) + vdcr;
-				auto g = Load(di, chan1 + j) + vdcg;
-				auto b = Load(di, chan2 + j) + vdcb;
-				auto y = ShiftRight<2>((g + g) + b + r);
-				auto u = b - g;
-				auto v = r - g;
-				Store(y, di, chan0 + j);
-				Store(u, di, chan1 + j);
-				Store(v, di, chan2 + j);
-			}
+			compress_rev_samples(chan0, chan1, chan2, index, index + chunkSize, shift);
 		}
 	};
 
@@ -258,45 +412,10 @@ namespace HWY_NAMESPACE
 			auto chan0 = info.tile->comps[0].getWindow()->getResWindowBufferHighestSimple().buf_;
 			auto chan1 = info.tile->comps[1].getWindow()->getResWindowBufferHighestSimple().buf_;
 			auto chan2 = info.tile->comps[2].getWindow()->getResWindowBufferHighestSimple().buf_;
-
 			int32_t shift[3] = {shiftInfo[0]._shift, shiftInfo[1]._shift, shiftInfo[2]._shift};
 
-			const HWY_FULL(float) df;
-			const HWY_FULL(int32_t) di;
-
-			auto va_r = Set(df, a_r);
-			auto va_g = Set(df, a_g);
-			auto va_b = Set(df, a_b);
-			auto vcb = Set(df, cb);
-			auto vcr = Set(df, cr);
-
-			auto vdcr = Set(di, shift[0]);
-			auto vdcg = Set(di, shift[1]);
-			auto vdcb = Set(di, shift[2]);
-
-			size_t begin = index;
-			for(auto j = begin; j < begin + chunkSize; j += Lanes(di))
-			{
-				auto r = ConvertTo(df, Load(di, chan0 + j) + vdcr);
-				auto g = ConvertTo(df, Load(di, chan1 + j) + vdcg);
-				auto b = ConvertTo(df, Load(di, chan2 + j) + vdcb);
-
-				auto y = va_r * r + va_g * g + va_b * b;
-				auto u = vcb * (b - y);
-				auto v = vcr * (r - y);
-
-				Store(y, df, (float*)(chan0 + j));
-				Store(u, df, (float*)(chan1 + j));
-				Store(v, df, (float*)(chan2 + j));
-			}
+			compress_irrev_samples(chan0, chan1, chan2, index, index + chunkSize, shift);
 		}
-
-	  private:
-		const float a_r = 0.299f;
-		const float a_g = 0.587f;
-		const float a_b = 0.114f;
-		const float cb = 0.5f / (1.0f - a_b);
-		const float cr = 0.5f / (1.0f - a_r);
 	};
 
 	template<class T>
@@ -332,7 +451,7 @@ namespace HWY_NAMESPACE
 			}
 			if(tasks)
 			{
-				ExecSingleton::get()->run(taskflow).wait();
+				ExecSingleton::run(taskflow);
 				delete[] tasks;
 			}
 		}
@@ -363,6 +482,16 @@ namespace HWY_NAMESPACE
 		vscheduler<CompressIrrev>(info);
 	}
 
+	void hwy_compress_rev_row(int32_t** rows, size_t len, const int32_t* shift)
+	{
+		compress_rev_samples(rows[0], rows[1], rows[2], 0, len, shift);
+	}
+
+	void hwy_compress_irrev_row(int32_t** rows, size_t len, const int32_t* shift)
+	{
+		compress_irrev_samples(rows[0], rows[1], rows[2], 0, len, shift);
+	}
+
 	void hwy_decompress_rev(ScheduleInfo info)
 	{
 		vscheduler<DecompressRev>(info);
@@ -391,20 +520,32 @@ namespace grk
 {
 HWY_EXPORT(hwy_compress_rev);
 HWY_EXPORT(hwy_compress_irrev);
+HWY_EXPORT(hwy_compress_rev_row);
+HWY_EXPORT(hwy_compress_irrev_row);
 HWY_EXPORT(hwy_decompress_rev);
 HWY_EXPORT(hwy_decompress_irrev);
 HWY_EXPORT(hwy_decompress_dc_shift_irrev);
 HWY_EXPORT(hwy_decompress_dc_shift_rev);
 
 mct::mct(Tile* tile, GrkImage* image, TileCodingParams* tcp, StripCache* stripCache)
-	: tile_(tile), image_(image), tcp_(tcp), stripCache_(stripCache)
+	: tile_(tile), image_(image), tcp_(tcp), stripCache_(stripCache), success_(true)
 {}
+bool mct::isSuccessful(void) const
+{
+	return success_;
+}
+void mct::setTileCodingParams(TileCodingParams* tcp)
+{
+	tcp_ = tcp;
+}
 /***
  * decompress dc shift only - irreversible
  */
 void mct::decompress_dc_shift_irrev(FlowComponent* flow, uint16_t compno)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
+	success_ = true;
+	info.success = &success_;
 	info.compno = compno;
 	genShift(compno, 1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_dc_shift_irrev)(info);
@@ -415,6 +556,8 @@ void mct::decompress_dc_shift_irrev(FlowComponent* flow, uint16_t compno)
 void mct::decompress_dc_shift_rev(FlowComponent* flow, uint16_t compno)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
+	success_ = true;
+	info.success = &success_;
 	info.compno = compno;
 	genShift(compno, 1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_dc_shift_rev)(info);
@@ -427,6 +570,8 @@ void mct::decompress_dc_shift_rev(FlowComponent* flow, uint16_t compno)
 void mct::decompress_irrev(FlowComponent* flow)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
+	success_ = true;
+	info.success = &success_;
 	hwy::DisableTargets(uint32_t(~HWY_SCALAR));
 	genShift(1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_irrev)
@@ -439,6 +584,8 @@ void mct::decompress_irrev(FlowComponent* flow)
 void mct::decompress_rev(FlowComponent* flow)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
+	success_ = true;
+	info.success = &success_;
 	genShift(1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_rev)
 	(info);
@@ -464,6 +611,26 @@ void mct::compress_irrev(FlowComponent* flow)
 	(info);
 }
 
+/* <summary> */
+/* Forward reversible MCT on one row of each of the first three components. */
+/* </summary> */
+void mct::compress_rev(int32_t** rows, uint64_t len)
+{
+	std::vector<ShiftInfo> shiftInfo;
+	genShift(-1, shiftInfo);
+	int32_t shift[3] = {shiftInfo[0]._shift, shiftInfo[1]._shift, shiftInfo[2]._shift};
+	HWY_DYNAMIC_DISPATCH(hwy_compress_rev_row)(rows, len, shift);
+}
+/* <summary> */
+/* Forward irreversible MCT on one row of each of the first three components. */
+/* </summary> */
+void mct::compress_irrev(int32_t** rows, uint64_t len)
+{
+	std::vector<ShiftInfo> shiftInfo;
+	genShift(-1, shiftInfo);
+	int32_t shift[3] = {shiftInfo[0]._shift, shiftInfo[1]._shift, shiftInfo[2]._shift};
+	HWY_DYNAMIC_DISPATCH(hwy_compress_irrev_row)(rows, len, shift);
+}
 void mct::genShift(uint16_t compno, int32_t sign, std::vector<ShiftInfo>& shiftInfo)
 {
 	int32_t _min, _max, shift;
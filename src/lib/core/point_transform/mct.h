@@ -21,6 +21,7 @@
 
 #pragma once
 #include <vector>
+#include <atomic>
 
 namespace grk
 {
@@ -37,7 +38,7 @@ struct ScheduleInfo
 {
 	ScheduleInfo(Tile* t, FlowComponent* flow, StripCache* stripCache, uint32_t linesPerTask)
 		: tile(t), compno(0), flow_(flow), linesPerTask_(linesPerTask), stripCache_(stripCache),
-		  yBegin(0), yEnd(0)
+		  yBegin(0), yEnd(0), success(nullptr)
 	{}
 	Tile* tile;
 	uint16_t compno;
@@ -47,12 +48,15 @@ struct ScheduleInfo
 	StripCache* stripCache_;
 	uint32_t yBegin;
 	uint32_t yEnd;
+	// cleared by decompression tasks that fail
+	std::atomic_bool* success;
 };
 
 class mct
 {
   public:
 	mct(Tile* tile, GrkImage* image, TileCodingParams* tcp, StripCache* stripCache);
+	void setTileCodingParams(TileCodingParams* tcp);
 
 	/**
 	 Apply a reversible multi-component transform to an image
@@ -67,6 +71,16 @@ class mct
 	 Apply an irreversible multi-component transform to an image
 	 */
 	void compress_irrev(FlowComponent* flow);
+
+	/**
+	 Apply a forward multi-component transform, with dc shift, to one row of each
+	 of the first three components. Rows must be padded to a whole number of vectors.
+
+	 @param rows       rows of the first three components
+	 @param len        number of samples in each row
+	 */
+	void compress_rev(int32_t** rows, uint64_t len);
+	void compress_irrev(int32_t** rows, uint64_t len);
 	/**
 	 Apply an irreversible multi-component inverse transform to an image
 	 */
@@ -122,6 +136,11 @@ class mct
 	 */
 	static void calculate_norms(double* pNorms, uint16_t nb_comps, float* pMatrix);
 
+	/**
+	 Check that no scheduled decompression task has failed
+	 */
+	bool isSuccessful(void) const;
+
   private:
 	void genShift(uint16_t compno, int32_t sign, std::vector<ShiftInfo>& shiftInfo);
 	void genShift(int32_t sign, std::vector<ShiftInfo>& shiftInfo);
@@ -130,6 +149,7 @@ class mct
 	GrkImage* image_;
 	TileCodingParams* tcp_;
 	StripCache* stripCache_;
+	std::atomic_bool success_;
 };
 
 /* ----------------------------------------------------------------------- */
@@ -26,10 +26,22 @@ CompressScheduler::CompressScheduler(Tile* tile, bool needsRateControl, TileCodi
 {
 	for(uint16_t compno = 0; compno < numcomps_; ++compno)
 	{
-		uint8_t numResolutions = (tile->comps + compno)->highestResolutionDecompressed + 1;
-		imageComponentFlows_[compno] = new ImageComponentFlow(numResolutions);
+		imageComponentFlows_[compno] =
+			new ImageComponentFlow((tile->comps + compno)->numresolutions);
 	}
 }
+bool CompressScheduler::scheduleWavelet(void)
+{
+	wavelets_.resize(numcomps_);
+	for(uint16_t compno = 0; compno < numcomps_; ++compno)
+	{
+		if(!wavelets_[compno].compress(tile->comps + compno, (tcp_->tccps + compno)->qmfbid,
+									   imageComponentFlows_[compno]))
+			return false;
+	}
+
+	return true;
+}
 bool CompressScheduler::schedule(uint16_t compno)
 {
 	return scheduleBlocks(compno);
@@ -39,13 +51,15 @@ bool CompressScheduler::scheduleBlocks(uint16_t compno)
 	uint8_t resno, bandIndex;
 	tile->distortion = 0;
 	std::vector<CompressBlockExec*> blocks;
-	uint32_t maxCblkW = 0;
-	uint32_t maxCblkH = 0;
+	size_t numThreads = ExecSingleton::get()->num_workers();
+	// blocks of each component's resolution flow
+	std::vector<std::vector<std::vector<CompressBlockExec*>>> flowBlocks(numcomps_);
 
 	for(compno = 0; compno < tile->numcomps_; ++compno)
 	{
 		auto tilec = tile->comps + compno;
-		auto tccp = tcp_->tccps + compno;
+		auto highest = tilec->getWindow()->getResWindowBufferHighestSimple();
+		flowBlocks[compno].resize(imageComponentFlows_[compno]->numResFlows_);
 		for(resno = 0; resno < tilec->numresolutions; ++resno)
 		{
 			auto res = &tilec->resolutions_[resno];
@@ -62,41 +76,125 @@ bool CompressScheduler::scheduleBlocks(uint16_t compno)
 							continue;
 						if(!cblk->allocData(nominalBlockSize))
 							continue;
-						auto block = new CompressBlockExec();
-						block->tile = tile;
-						block->doRateControl = needsRateControl;
-						block->x = cblk->x0;
-						block->y = cblk->y0;
+						auto block = createBlock(compno, resno, band, cblk);
 						tilec->getWindow()->toRelativeCoordinates(resno, band->orientation,
 																  block->x, block->y);
-						auto highest = tilec->getWindow()->getResWindowBufferHighestSimple();
 						block->tiledp = highest.buf_ + (uint64_t)block->x +
 										block->y * (uint64_t)highest.stride_;
-						maxCblkW = std::max<uint32_t>(maxCblkW, (uint32_t)(1 << tccp->cblkw));
-						maxCblkH = std::max<uint32_t>(maxCblkH, (uint32_t)(1 << tccp->cblkh));
-						block->compno = compno;
-						block->bandOrientation = band->orientation;
-						block->cblk = cblk;
-						block->cblk_sty = tccp->cblk_sty;
-						block->qmfbid = tccp->qmfbid;
-						block->resno = resno;
-						block->inv_step_ht = 1.0f / band->stepsize;
-						block->stepsize = band->stepsize;
-						block->mct_norms = mct_norms_;
-						block->mct_numcomps = mct_numcomps_;
-						block->k_msbs = (uint8_t)(band->numbps - cblk->numbps);
-						blocks.push_back(block);
+						block->stride = highest.stride_;
+						if(numThreads == 1)
+							blocks.push_back(block);
+						else
+							flowBlocks[compno][resno ? (size_t)(resno - 1) : 0].push_back(block);
 					}
 				}
 			}
 		}
 	}
-	for(auto i = 0U; i < ExecSingleton::get()->num_workers(); ++i)
-		t1Implementations.push_back(T1Factory::makeT1(true, tcp_, maxCblkW, maxCblkH));
+	createT1Implementations();
+	if(numThreads == 1)
+	{
+		compress(&blocks);
+		return true;
+	}
+	for(compno = 0; compno < numcomps_; ++compno)
+	{
+		auto flow = imageComponentFlows_[compno];
+		for(uint8_t resFlowNo = 0; resFlowNo < flow->numResFlows_; ++resFlowNo)
+		{
+			auto& resBlocks = flowBlocks[compno][resFlowNo];
+			size_t batchSize = blockBatchSize(resBlocks.size(), numThreads);
+			for(size_t i = 0; i < resBlocks.size(); i += batchSize)
+			{
+				std::vector<CompressBlockExec*> batch(
+					resBlocks.begin() + (ptrdiff_t)i,
+					resBlocks.begin() + (ptrdiff_t)std::min(i + batchSize, resBlocks.size()));
+				flow->getResFlow(resFlowNo)->blocks_->nextTask().work([this, batch] {
+					auto threadnum = ExecSingleton::get()->this_worker_id();
+					auto impl = t1Implementations[(size_t)threadnum];
+					for(auto block : batch)
+					{
+						compress(impl, block);
+						delete block;
+					}
+				});
+			}
+		}
+		flow->addTo(codecFlow_);
+		flow->graphCompress();
+	}
+
+	return run();
+}
+bool CompressScheduler::scheduleBlockRow(uint16_t compno, uint8_t resno, uint8_t bandIndex,
+										 uint32_t y0, int32_t* strip, uint32_t stride)
+{
+	auto band = tile->comps[compno].resolutions_[resno].tileBand + bandIndex;
+	std::vector<CompressBlockExec*> blocks;
+	for(auto prc : band->precincts)
+	{
+		if(y0 < prc->y0 || y0 >= prc->y1)
+			continue;
+		auto nominalBlockSize = prc->getNominalBlockSize();
+		auto grid = prc->getCblkGrid();
+		uint64_t cblkno = (uint64_t)((y0 >> prc->getCblkExpn().y) - grid.y0) * grid.width();
+		for(uint32_t i = 0; i < grid.width(); ++i, ++cblkno)
+		{
+			auto cblk = prc->getCompressedBlockPtr(cblkno);
+			if(cblk->empty())
+				continue;
+			assert(cblk->y0 == y0);
+			if(!cblk->allocData(nominalBlockSize))
+				continue;
+			auto block = createBlock(compno, resno, band, cblk);
+			block->tiledp = strip + (cblk->x0 - band->x0);
+			block->stride = stride;
+			blocks.push_back(block);
+		}
+	}
+	if(t1Implementations.empty())
+		createT1Implementations();
+	blockCount = -1;
 	compress(&blocks);
 
 	return true;
 }
+CompressBlockExec* CompressScheduler::createBlock(uint16_t compno, uint8_t resno, Subband* band,
+												  CompressCodeblock* cblk)
+{
+	auto tccp = tcp_->tccps + compno;
+	auto block = new CompressBlockExec();
+	block->tile = tile;
+	block->doRateControl = needsRateControl;
+	block->x = cblk->x0;
+	block->y = cblk->y0;
+	block->compno = compno;
+	block->bandOrientation = band->orientation;
+	block->cblk = cblk;
+	block->cblk_sty = tccp->cblk_sty;
+	block->qmfbid = tccp->qmfbid;
+	block->resno = resno;
+	block->inv_step_ht = 1.0f / band->stepsize;
+	block->stepsize = band->stepsize;
+	block->mct_norms = mct_norms_;
+	block->mct_numcomps = mct_numcomps_;
+	block->k_msbs = (uint8_t)(band->numbps - cblk->numbps);
+
+	return block;
+}
+void CompressScheduler::createT1Implementations(void)
+{
+	uint32_t maxCblkW = 0;
+	uint32_t maxCblkH = 0;
+	for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
+	{
+		auto tccp = tcp_->tccps + compno;
+		maxCblkW = std::max<uint32_t>(maxCblkW, (uint32_t)(1 << tccp->cblkw));
+		maxCblkH = std::max<uint32_t>(maxCblkH, (uint32_t)(1 << tccp->cblkh));
+	}
+	for(auto i = 0U; i < ExecSingleton::get()->num_workers(); ++i)
+		t1Implementations.push_back(T1Factory::makeT1(true, tcp_, maxCblkW, maxCblkH));
+}
 
 void CompressScheduler::compress(std::vector<CompressBlockExec*>* blocks)
 {
@@ -133,7 +231,7 @@ void CompressScheduler::compress(std::vector<CompressBlockExec*>* blocks)
 			{}
 		});
 	}
-	ExecSingleton::get()->run(taskflow).wait();
+	ExecSingleton::run(taskflow);
 
 	delete[] node;
 	delete[] encodeBlocks;
@@ -24,10 +24,29 @@ class CompressScheduler : public Scheduler
 	CompressScheduler(Tile* tile, bool needsRateControl, TileCodingParams* tcp,
 					  const double* mct_norms, uint16_t mct_numcomps);
 	~CompressScheduler() = default;
+	/**
+	 * Schedule forward wavelet transform of all components. With multiple workers, the
+	 * transform runs together with T1 when blocks are scheduled
+	 */
+	bool scheduleWavelet(void);
+	/**
+	 * Compress code blocks of all components. With multiple workers, the blocks of each
+	 * resolution are compressed as soon as the wavelet level producing them completes
+	 */
 	bool schedule(uint16_t compno) override;
+	/**
+	 * Compress the row of code blocks of a band whose top edge is band row y0.
+	 * Samples are read from a strip buffer whose first row is band row y0,
+	 * and whose first column is the first column of the band.
+	 */
+	bool scheduleBlockRow(uint16_t compno, uint8_t resno, uint8_t bandIndex, uint32_t y0,
+						  int32_t* strip, uint32_t stride);
 
   private:
 	bool scheduleBlocks(uint16_t compno);
+	CompressBlockExec* createBlock(uint16_t compno, uint8_t resno, Subband* band,
+								   CompressCodeblock* cblk);
+	void createT1Implementations(void);
 	void compress(std::vector<CompressBlockExec*>* blocks);
 	bool compress(size_t threadId, uint64_t maxBlocks);
 	void compress(T1Interface* impl, CompressBlockExec* block);
@@ -40,6 +59,7 @@ class CompressScheduler : public Scheduler
 	TileCodingParams* tcp_;
 	const double* mct_norms_;
 	uint16_t mct_numcomps_;
+	std::vector<WaveletFwdImpl> wavelets_;
 };
 
 } // namespace grk
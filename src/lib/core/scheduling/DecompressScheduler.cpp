@@ -39,7 +39,7 @@ DecompressScheduler::DecompressScheduler(TileProcessor* tileProcessor, Tile* til
 										 TileCodingParams* tcp, uint8_t prec)
 	: Scheduler(tile), tileProcessor_(tileProcessor), tcp_(tcp), prec_(prec),
 	  numcomps_(tile->numcomps_), tileBlocks_(TileDecompressBlocks(numcomps_)),
-	  waveletReverse_(nullptr)
+	  waveletReverse_(nullptr), seededRes_(numcomps_, 0)
 {
 	waveletReverse_ = new WaveletReverse*[numcomps_];
 	for(uint16_t compno = 0; compno < numcomps_; ++compno)
@@ -75,9 +75,57 @@ bool DecompressScheduler::schedule(uint16_t compno)
 			releaseBlocks(i);
 		return false;
 	}
+	if(canCacheResolution(compno))
+	{
+		// cache final resolution once inverse wavelet is complete
+		if(ExecSingleton::get()->num_workers() == 1)
+			cacheResolution(compno);
+		else
+			imageFlow->getFinalFlowT1()->nextTask().work(
+				[this, compno] { cacheResolution(compno); });
+	}
 
 	return true;
 }
+bool DecompressScheduler::canCacheResolution(uint16_t compno)
+{
+	auto tilec = tile_->comps + compno;
+	auto cache = tileProcessor_->getCodeblockCache();
+
+	// full resolution is never needed as a lower resolution of a subsequent decompress
+	return cache && cache->enabled() && tilec->isWholeTileDecoding() &&
+		   getImageComponentFlow(compno) && tilec->highestResolutionDecompressed > 0 &&
+		   tilec->highestResolutionDecompressed + 1U < tilec->numresolutions;
+}
+uint8_t DecompressScheduler::seedResolution(uint16_t compno)
+{
+	auto tilec = tile_->comps + compno;
+	auto cache = tileProcessor_->getCodeblockCache();
+	for(uint8_t resno = tilec->highestResolutionDecompressed; resno > 1; --resno)
+	{
+		auto res = tilec->resolutions_ + resno - 1;
+		auto win = tilec->getWindow()->getResWindowBufferSimple(resno - 1U);
+		if(cache->get(CodeblockCacheKey::resolution(tileProcessor_->getIndex(), compno,
+													(uint8_t)(resno - 1)),
+					  tcp_->numLayersToDecompress, win.buf_, res->width(), res->height(),
+					  win.stride_))
+			return (uint8_t)(resno - 1);
+	}
+
+	return 0;
+}
+void DecompressScheduler::cacheResolution(uint16_t compno)
+{
+	if(!success)
+		return;
+	auto tilec = tile_->comps + compno;
+	uint8_t resno = tilec->highestResolutionDecompressed;
+	auto res = tilec->resolutions_ + resno;
+	auto win = tilec->getWindow()->getResWindowBufferSimple(resno);
+	tileProcessor_->getCodeblockCache()->put(
+		CodeblockCacheKey::resolution(tileProcessor_->getIndex(), compno, resno),
+		tcp_->numLayersToDecompress, win.buf_, res->width(), res->height(), win.stride_);
+}
 
 void DecompressScheduler::releaseBlocks(uint16_t compno)
 {
@@ -94,9 +142,23 @@ bool DecompressScheduler::scheduleBlocks(uint16_t compno)
 	auto tccp = tcp_->tccps + compno;
 	auto tilec = tile_->comps + compno;
 	bool wholeTileDecoding = tilec->isWholeTileDecoding();
+	auto codeblockCache = tileProcessor_->getCodeblockCache();
+	if(codeblockCache && !codeblockCache->enabled())
+		codeblockCache = nullptr;
+	// for whole tile decompression, restore highest cached reconstructed resolution,
+	// and skip its code blocks
+	if(codeblockCache && wholeTileDecoding)
+		seededRes_[compno] = seedResolution(compno);
 	uint8_t resno = 0;
 	for(; resno <= tilec->highestResolutionDecompressed; ++resno)
 	{
+		if(seededRes_[compno] && resno <= seededRes_[compno])
+		{
+			// keep block flows aligned with resolution flows
+			if(resno > 0)
+				blocks.push_back(resBlocks);
+			continue;
+		}
 		auto res = tilec->resolutions_ + resno;
 		for(uint8_t bandIndex = 0; bandIndex < res->numTileBandWindows; ++bandIndex)
 		{
@@ -113,6 +175,8 @@ bool DecompressScheduler::scheduleBlocks(uint16_t compno)
 					if(wholeTileDecoding || paddedBandWindow->nonEmptyIntersection(&cblkBounds))
 					{
 						auto cblk = precinct->getDecompressedBlockPtr(cblkno);
+						if(tileProcessor_->retainsLayers())
+							cblk->truncate(tcp_->numLayersToDecompress);
 						auto block = new DecompressBlockExec();
 						block->x = cblk->x0;
 						block->y = cblk->y0;
@@ -128,6 +192,10 @@ bool DecompressScheduler::scheduleBlocks(uint16_t compno)
 						block->stepsize = band->stepsize;
 						block->k_msbs = (uint8_t)(band->numbps - cblk->numbps);
 						block->R_b = prec_ + gain_b[band->orientation];
+						block->tileIndex = tileProcessor_->getIndex();
+						block->compno = compno;
+						block->codeblockCache = codeblockCache;
+						block->moreLayers = tcp_->numLayersToDecompress < tcp_->max_layers_;
 						resBlocks.blocks_.push_back(block);
 					}
 				}
@@ -155,6 +223,8 @@ bool DecompressScheduler::scheduleBlocks(uint16_t compno)
 	imageComponentFlows_[compno] = new ImageComponentFlow(numResolutions);
 	if(!tile_->comps->isWholeTileDecoding())
 		imageComponentFlows_[compno]->setRegionDecompression();
+	else if(canCacheResolution(compno))
+		imageComponentFlows_[compno]->addFinalFlow();
 
 	// nominal code block dimensions
 	uint16_t codeblock_width = (uint16_t)(tccp->cblkw ? (uint32_t)1 << tccp->cblkw : 0);
@@ -238,7 +308,8 @@ bool DecompressScheduler::scheduleWavelet(uint16_t compno)
 	uint8_t numRes = tilec->highestResolutionDecompressed + 1U;
 	waveletReverse_[compno] =
 		new WaveletReverse(tileProcessor_, tilec, compno, tilec->getWindow()->unreducedBounds(),
-						   numRes, (tcp_->tccps + compno)->qmfbid);
+						   numRes, (tcp_->tccps + compno)->qmfbid,
+						   (uint8_t)(seededRes_[compno] + 1));
 
 	return waveletReverse_[compno]->decompress();
 }
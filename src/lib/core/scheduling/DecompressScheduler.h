@@ -46,6 +46,9 @@ class DecompressScheduler : public Scheduler
   private:
 	bool scheduleBlocks(uint16_t compno);
 	bool scheduleWavelet(uint16_t compno);
+	uint8_t seedResolution(uint16_t compno);
+	void cacheResolution(uint16_t compno);
+	bool canCacheResolution(uint16_t compno);
 	bool decompressBlock(T1Interface* impl, DecompressBlockExec* block);
 	void releaseBlocks(uint16_t compno);
 	TileProcessor* tileProcessor_;
@@ -54,6 +57,8 @@ class DecompressScheduler : public Scheduler
 	uint16_t numcomps_;
 	TileDecompressBlocks tileBlocks_;
 	WaveletReverse** waveletReverse_;
+	// per component: highest resolution seeded from code block cache
+	std::vector<uint8_t> seededRes_;
 };
 
 } // namespace grk
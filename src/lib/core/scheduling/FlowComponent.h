@@ -42,12 +42,13 @@ class FlowComponent
 	}
 	tf::Task& nextTask()
 	{
-		componentTasks_.push(componentFlow_.placeholder());
+		componentTasks_.push_back(componentFlow_.placeholder());
 		return componentTasks_.back();
 	}
 
   private:
-	std::queue<tf::Task> componentTasks_;
+	// unlike std::queue, an empty vector does not allocate
+	std::vector<tf::Task> componentTasks_;
 	tf::Taskflow componentFlow_;
 	tf::Task compositionTask_;
 };
@@ -111,7 +111,12 @@ ImageComponentFlow::~ImageComponentFlow()
 }
 void ImageComponentFlow::setRegionDecompression(void)
 {
-	waveletFinalCopy_ = new FlowComponent();
+	addFinalFlow();
+}
+void ImageComponentFlow::addFinalFlow(void)
+{
+	if(!waveletFinalCopy_)
+		waveletFinalCopy_ = new FlowComponent();
 }
 void ImageComponentFlow::graph(void)
 {
@@ -122,6 +127,19 @@ void ImageComponentFlow::graph(void)
 	if(waveletFinalCopy_)
 		(resFlows_ + numResFlows_ - 1)->precede(waveletFinalCopy_);
 }
+void ImageComponentFlow::graphCompress(void)
+{
+	for(uint8_t i = 0; i < numResFlows_; ++i)
+	{
+		auto resFlow = resFlows_ + i;
+		if(!resFlow->doWavelet_)
+			continue;
+		resFlow->waveletVert_->precede(resFlow->waveletHoriz_);
+		resFlow->waveletHoriz_->precede(resFlow->blocks_);
+		if(i > 0)
+			resFlow->waveletHoriz_->precede((resFlow - 1)->waveletVert_);
+	}
+}
 FlowComponent* ImageComponentFlow::getFinalFlowT1(void)
 {
 	return waveletFinalCopy_ ? waveletFinalCopy_ : (resFlows_ + numResFlows_ - 1)->getFinalFlowT1();
@@ -46,9 +46,19 @@ class ImageComponentFlow
 	ImageComponentFlow(uint8_t numResolutions);
 	virtual ~ImageComponentFlow(void);
 	void setRegionDecompression(void);
+	/**
+	 * Add final flow, which runs after the final wavelet resolution
+	 */
+	void addFinalFlow(void);
 	std::string genBlockFlowTaskName(uint8_t resFlowNo);
 	ResFlow* getResFlow(uint8_t resFlowNo);
 	void graph(void);
+	/**
+	 * Generate compression graph, where each resolution's vertical wavelet pass precedes
+	 * its horizontal pass, which precedes both the next lower resolution's vertical pass
+	 * and the resolution's code blocks
+	 */
+	void graphCompress(void);
 	ImageComponentFlow* addTo(tf::Taskflow& composition);
 	FlowComponent* getFinalFlowT1(void);
 	FlowComponent* getPrePostProc(tf::Taskflow& codecFlow);
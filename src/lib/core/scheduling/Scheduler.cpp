@@ -36,7 +36,7 @@ Scheduler::~Scheduler()
 }
 bool Scheduler::run(void)
 {
-	ExecSingleton::get()->run(codecFlow_).wait();
+	ExecSingleton::run(codecFlow_);
 
 	return success;
 }
@@ -53,7 +53,11 @@ tf::Taskflow& Scheduler::getCodecFlow(void)
 {
 	return codecFlow_;
 }
-
+size_t Scheduler::blockBatchSize(size_t numBlocks, size_t numThreads)
+{
+	// keep enough tasks per worker for load balancing
+	return std::clamp<size_t>(numBlocks / (numThreads * minTasksPerWorker), 1, maxBlockBatch);
+}
 FlowComponent* Scheduler::getPrePostProc(void)
 {
 	if(!prePostProc_)
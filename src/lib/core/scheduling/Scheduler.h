@@ -32,6 +32,14 @@ class Scheduler
 	FlowComponent* getPrePostProc(void);
 
   protected:
+	/**
+	 * Number of code blocks processed by a single task. Batching amortizes
+	 * task overhead over small code blocks
+	 */
+	static size_t blockBatchSize(size_t numBlocks, size_t numThreads);
+	static constexpr size_t minTasksPerWorker = 4;
+	static constexpr size_t maxBlockBatch = 16;
+
 	std::atomic_bool success;
 	std::vector<T1Interface*> t1Implementations;
 	ImageComponentFlow** imageComponentFlows_;
@@ -47,6 +47,22 @@ class ExecSingleton
 	{
 		get()->shutdown();
 	}
+	/**
+	 * Run taskflow on the shared executor and wait for it to complete.
+	 *
+	 * When called from one of the executor's own workers (nested parallelism,
+	 * e.g. T1 tasks spawned by a tile task), the calling worker joins the
+	 * work-stealing loop until the taskflow completes, rather than blocking,
+	 * so the pool can never deadlock on itself.
+	 */
+	static void run(tf::Taskflow& taskflow)
+	{
+		auto executor = get();
+		if(executor->this_worker_id() >= 0)
+			executor->run_and_wait(taskflow);
+		else
+			executor->run(taskflow).wait();
+	}
 	static uint32_t threadId(void)
 	{
 		return get()->num_workers() > 1 ? (uint32_t)ExecSingleton::get()->this_worker_id() : 0;
@@ -43,21 +43,41 @@ struct BlockExec
 };
 struct DecompressBlockExec : public BlockExec
 {
-	DecompressBlockExec() : cblk(nullptr), resno(0), roishift(0) {}
+	DecompressBlockExec()
+		: cblk(nullptr), resno(0), roishift(0), tileIndex(0), compno(0), codeblockCache(nullptr),
+		  moreLayers(false)
+	{}
 	bool open(T1Interface* t1)
 	{
 		return t1->decompress(this);
 	}
 	void close(void) {}
+	CodeblockCacheKey cacheKey(void) const
+	{
+		return CodeblockCacheKey(tileIndex, compno, resno, (uint8_t)bandOrientation, cblk->x0,
+								 cblk->y0);
+	}
+	// number of passes and compressed bytes, which grow as more layers are decompressed
+	uint64_t cacheTag(void) const
+	{
+		return ((uint64_t)cblk->getNumPasses() << 32) | (uint32_t)cblk->getSegBuffersLen();
+	}
 	DecompressCodeblock* cblk;
 	uint8_t resno;
 	uint8_t roishift;
+	uint16_t tileIndex;
+	uint16_t compno;
+	// optional cache of T1-decoded coefficients
+	CodeblockCache* codeblockCache;
+	// true if code block may receive coding passes from layers that are not decompressed
+	bool moreLayers;
 };
 struct CompressBlockExec : public BlockExec
 {
 	CompressBlockExec()
 		: cblk(nullptr), tile(nullptr), doRateControl(false), distortion(0), tiledp(nullptr),
-		  compno(0), resno(0), precinctIndex(0), cblkno(0), inv_step_ht(0), mct_norms(nullptr),
+		  stride(0), compno(0), resno(0), precinctIndex(0), cblkno(0), inv_step_ht(0),
+		  mct_norms(nullptr),
 #ifdef DEBUG_LOSSLESS_T1
 		  unencodedData(nullptr),
 #endif
@@ -73,6 +93,8 @@ struct CompressBlockExec : public BlockExec
 	bool doRateControl;
 	double distortion;
 	int32_t* tiledp;
+	// stride of tiledp
+	uint32_t stride;
 	uint16_t compno;
 	uint8_t resno;
 	uint64_t precinctIndex;
@@ -41,6 +41,22 @@ struct Segment
 	uint32_t numBytesInPacket; // number of bytes contributed by current packet
 };
 
+// compressed data contributed to a code block segment by a single packet
+struct SegmentContribution
+{
+	SegmentContribution(uint16_t layer, uint32_t segment, uint32_t maxPasses, uint32_t passes,
+						uint8_t* buf, uint32_t length)
+		: layno(layer), segno(segment), maxpasses(maxPasses), numpasses(passes), data(buf),
+		  len(length)
+	{}
+	uint16_t layno;
+	uint32_t segno;
+	uint32_t maxpasses;
+	uint32_t numpasses;
+	uint8_t* data;
+	uint32_t len;
+};
+
 // compressing/decoding pass
 struct CodePass
 {
@@ -212,6 +228,14 @@ struct DecompressCodeblock : public Codeblock
 	{
 		return numSegments;
 	}
+	uint32_t getNumPasses(void)
+	{
+		uint32_t numPasses = 0;
+		for(uint32_t i = 0; i < numSegments; ++i)
+			numPasses += segs[i].numpasses;
+
+		return numPasses;
+	}
 	Segment* getCurrentSegment(void)
 	{
 		return numSegments ? getSegment(numSegments - 1) : nullptr;
@@ -255,7 +279,37 @@ struct DecompressCodeblock : public Codeblock
 		segs = nullptr;
 		grk_buf2d::dealloc();
 	}
+	/**
+	 * Rebuild segments from the contributions of the first numLayers layers
+	 *
+	 * @param numLayers number of layers to decompress
+	 */
+	void truncate(uint16_t numLayers)
+	{
+		cleanUpSegBuffers();
+		for(const auto& c : contributions)
+		{
+			// a code block receives packets in layer order
+			if(c.layno >= numLayers)
+				break;
+			while(numSegments <= c.segno)
+			{
+				auto seg = nextSegment();
+				seg->clear();
+				seg->maxpasses = c.maxpasses;
+			}
+			auto seg = getSegment(c.segno);
+			seg->numpasses += c.numpasses;
+			seg->len += c.len;
+			if(c.len)
+				seg_buffers.push_back(new grk_buf8(c.data, c.len, false));
+		}
+		setCacheState(GRK_CACHE_STATE_CLOSED);
+	}
 	std::vector<grk_buf8*> seg_buffers;
+	// contributions of all parsed packets, recorded when code block is retained
+	// for decompression with a different number of layers
+	std::vector<SegmentContribution> contributions;
 
   private:
 	Segment* segs; /* information on segments */
@@ -57,8 +57,92 @@
 #include "grk_includes.h"
 #include "QuantizerOJPH.h"
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "t1/OJPH/QuantizerOJPH.cpp"
+#include <hwy/foreach_target.h>
+#include <hwy/highway.h>
+HWY_BEFORE_NAMESPACE();
 namespace ojph
 {
+namespace HWY_NAMESPACE
+{
+	using namespace hwy::HWY_NAMESPACE;
+
+	void hwy_quantize_rev(const int32_t* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+						  uint32_t h, int32_t shift)
+	{
+		const HWY_FULL(int32_t) di;
+		const size_t N = Lanes(di);
+		const auto vsign = Set(di, INT32_MIN);
+		for(uint32_t j = 0; j < h; ++j)
+		{
+			size_t i = 0;
+			for(; i + N <= w; i += N)
+			{
+				auto temp = LoadU(di, src + i);
+				auto val = ShiftLeftSame(Abs(temp), shift);
+				StoreU(Or(And(temp, vsign), val), di, dest + i);
+			}
+			for(; i < w; ++i)
+			{
+				int32_t temp = src[i];
+				int32_t val = temp >= 0 ? temp : -temp;
+				int32_t sign = (int32_t)((temp >= 0) ? 0U : 0x80000000);
+				dest[i] = sign | (val << shift);
+			}
+			src += srcStride;
+			dest += w;
+		}
+	}
+
+	void hwy_quantize_irrev(const float* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+							uint32_t h, float invStepSize, int32_t shift)
+	{
+		const HWY_FULL(float) df;
+		const RebindToSigned<decltype(df)> di;
+		const size_t N = Lanes(df);
+		const auto vinv = Set(df, invStepSize);
+		const auto vscale = Set(df, (float)(1 << shift));
+		const auto vsign = Set(di, INT32_MIN);
+		for(uint32_t j = 0; j < h; ++j)
+		{
+			size_t i = 0;
+			for(; i + N <= w; i += N)
+			{
+				auto t = ConvertTo(di, Mul(Mul(LoadU(df, src + i), vinv), vscale));
+				StoreU(Or(And(t, vsign), Abs(t)), di, dest + i);
+			}
+			for(; i < w; ++i)
+			{
+				int32_t t = (int32_t)(src[i] * invStepSize * (float)(1 << shift));
+				int32_t val = t >= 0 ? t : -t;
+				int32_t sign = t >= 0 ? 0 : (int32_t)0x80000000;
+				dest[i] = sign | val;
+			}
+			src += srcStride;
+			dest += w;
+		}
+	}
+} // namespace HWY_NAMESPACE
+} // namespace ojph
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace ojph
+{
+HWY_EXPORT(hwy_quantize_rev);
+HWY_EXPORT(hwy_quantize_irrev);
+
+void QuantizerOJPH::quantize(const int32_t* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+							 uint32_t h, bool reversible, float invStepSize, int32_t shift)
+{
+	if(reversible)
+		HWY_DYNAMIC_DISPATCH(hwy_quantize_rev)(src, srcStride, dest, w, h, shift);
+	else
+		HWY_DYNAMIC_DISPATCH(hwy_quantize_irrev)((const float*)src, srcStride, dest, w, h,
+												 invStepSize, shift);
+}
+
 class sqrt_energy_gains
 {
   public:
@@ -303,3 +387,4 @@ bool QuantizerOJPH::write(grk::BufferedStream* stream)
 }
 
 } // namespace ojph
+#endif
@@ -64,6 +64,22 @@ struct QuantizerOJPH : public grk::Quantizer
 	void generate(uint32_t decomps, uint32_t max_bit_depth, bool color_transform,
 				  bool is_signed) override;
 	bool write(grk::BufferedStream* stream) override;
+	/**
+	 * Scale code block samples, quantizing them if irreversible, and convert
+	 * to the sign-magnitude layout expected by the HT block coder
+	 *
+	 * @param src top left sample of code block in tile buffer
+	 * (float samples if irreversible)
+	 * @param srcStride tile buffer stride
+	 * @param dest code block destination buffer, with stride equal to code block width
+	 * @param w code block width
+	 * @param h code block height
+	 * @param reversible true if code block is reversible
+	 * @param invStepSize inverse of quantization step size
+	 * @param shift left shift aligning most significant magnitude bit with bit 30
+	 */
+	static void quantize(const int32_t* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+						 uint32_t h, bool reversible, float invStepSize, int32_t shift);
 
   private:
 	uint32_t get_MAGBp() const;
@@ -20,18 +20,42 @@
 #include "coding/ojph_block_encoder.h"
 #include "ojph_mem.h"
 #include "T1OJPH.h"
+#include "QuantizerOJPH.h"
 
 #include "grk_includes.h"
+#include <hwy/targets.h>
 
 const uint8_t grk_cblk_dec_compressed_data_pad_ht = 8;
 
 namespace ojph
 {
+typedef bool (*DecodeCodeblockFn)(ui8* coded_data, ui32* decoded_data, ui32 missing_msbs,
+								  ui32 num_passes, ui32 lengths1, ui32 lengths2, ui32 width,
+								  ui32 height, ui32 stride, bool stripe_causal);
+// select SIMD block decoder if supported by the CPU
+static DecodeCodeblockFn selectDecoder(void)
+{
+#ifdef GRK_OJPH_X86_DECODERS
+	if(hwy::SupportedTargets() & HWY_SSSE3)
+		return local::ojph_decode_codeblock_ssse3;
+#endif
+	return local::ojph_decode_codeblock;
+}
+static const DecodeCodeblockFn decodeCodeblock = selectDecoder();
+
+// SIMD decoders write whole quad pairs and stripes, so decoded block
+// width is padded to 8 columns, and height to 4 rows
+static uint32_t decodeStride(uint32_t width)
+{
+	return (width + 7) & ~7U;
+}
+
 T1OJPH::T1OJPH(bool isCompressor, [[maybe_unused]] grk::TileCodingParams* tcp, uint32_t maxCblkW,
 			   uint32_t maxCblkH)
 	: coded_data_size(isCompressor ? 0 : (uint32_t)(maxCblkW * maxCblkH * sizeof(int32_t))),
 	  coded_data(isCompressor ? nullptr : new uint8_t[coded_data_size]),
-	  unencoded_data_size(maxCblkW * maxCblkH), unencoded_data(new int32_t[unencoded_data_size]),
+	  unencoded_data_size(decodeStride(maxCblkW) * ((maxCblkH + 3) & ~3U)),
+	  unencoded_data((int32_t*)grk::grk_aligned_malloc(unencoded_data_size * sizeof(int32_t))),
 	  allocator(new mem_fixed_allocator), elastic_alloc(new mem_elastic_allocator(1048576))
 {
 	if(!isCompressor)
@@ -40,7 +64,7 @@ T1OJPH::T1OJPH(bool isCompressor, [[maybe_unused]] grk::TileCodingParams* tcp, u
 T1OJPH::~T1OJPH()
 {
 	delete[] coded_data;
-	delete[] unencoded_data;
+	grk::grk_aligned_free(unencoded_data);
 	delete allocator;
 	delete elastic_alloc;
 }
@@ -50,47 +74,11 @@ void T1OJPH::preCompress([[maybe_unused]] grk::CompressBlockExec* block,
 	auto cblk = block->cblk;
 	uint16_t w = (uint16_t)cblk->width();
 	uint16_t h = (uint16_t)cblk->height();
-	uint32_t tile_width =
-		(tile->comps + block->compno)->getWindow()->getResWindowBufferHighestStride();
-	auto tileLineAdvance = tile_width - w;
-	uint32_t cblk_index = 0;
 	int32_t shift = 31 - (block->k_msbs + 1);
 
 	// convert to sign-magnitude
-	if(block->qmfbid == 1)
-	{
-		auto tiledp = block->tiledp;
-		for(auto j = 0U; j < h; ++j)
-		{
-			for(auto i = 0U; i < w; ++i)
-			{
-				int32_t temp = *tiledp++;
-				int32_t val = temp >= 0 ? temp : -temp;
-				int32_t sign = (int32_t)((temp >= 0) ? 0U : 0x80000000);
-				int32_t res = sign | (val << shift);
-				unencoded_data[cblk_index] = res;
-				cblk_index++;
-			}
-			tiledp += tileLineAdvance;
-		}
-	}
-	else
-	{
-		auto tiledp = (float*)block->tiledp;
-		for(auto j = 0U; j < h; ++j)
-		{
-			for(auto i = 0U; i < w; ++i)
-			{
-				int32_t t = (int32_t)((float)*tiledp++ * block->inv_step_ht * (float)(1 << shift));
-				int32_t val = t >= 0 ? t : -t;
-				int32_t sign = t >= 0 ? 0 : (int32_t)0x80000000;
-				int32_t res = sign | val;
-				unencoded_data[cblk_index] = res;
-				cblk_index++;
-			}
-			tiledp += tileLineAdvance;
-		}
-	}
+	QuantizerOJPH::quantize(block->tiledp, block->stride, unencoded_data, w, h, block->qmfbid == 1,
+							block->inv_step_ht, shift);
 }
 bool T1OJPH::compress(grk::CompressBlockExec* block)
 {
@@ -122,8 +110,11 @@ bool T1OJPH::decompress(grk::DecompressBlockExec* block)
 	auto cblk = block->cblk;
 	if(!cblk->area())
 		return true;
-	uint16_t stride = (uint16_t)cblk->width();
-	if(!cblk->seg_buffers.empty())
+	uint16_t stride = (uint16_t)decodeStride(cblk->width());
+	auto cache = block->codeblockCache;
+	if(!cblk->seg_buffers.empty() &&
+	   !(cache && cache->get(block->cacheKey(), block->cacheTag(), unencoded_data, cblk->width(),
+						   cblk->height(), stride)))
 	{
 		size_t total_seg_len = 2 * grk_cblk_dec_compressed_data_pad_ht + cblk->getSegBuffersLen();
 		if(coded_data_size < total_seg_len)
@@ -153,9 +144,9 @@ bool T1OJPH::decompress(grk::DecompressBlockExec* block)
 		bool rc = false;
 		if(num_passes && offset)
 		{
-			rc = ojph::local::ojph_decode_codeblock(
-				actual_coded_data, (uint32_t*)unencoded_data, block->k_msbs, (uint32_t)num_passes,
-				(uint32_t)offset, 0, cblk->width(), cblk->height(), stride, false);
+			rc = decodeCodeblock(actual_coded_data, (uint32_t*)unencoded_data, block->k_msbs,
+								 (uint32_t)num_passes, (uint32_t)offset, 0, cblk->width(),
+								 cblk->height(), stride, false);
 		}
 		else
 		{
@@ -166,6 +157,9 @@ bool T1OJPH::decompress(grk::DecompressBlockExec* block)
 			grk::Logger::logger_.error("Error in HT block coder");
 			return false;
 		}
+		if(cache)
+			cache->put(block->cacheKey(), block->cacheTag(), unencoded_data, cblk->width(),
+					   cblk->height(), stride);
 	}
 
 	block->tilec->postProcessHT(unencoded_data, block, stride);
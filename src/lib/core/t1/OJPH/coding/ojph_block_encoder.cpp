@@ -401,9 +401,9 @@ namespace ojph {
       ui32 pos;      //position of next writing within buf
       ui32 buf_size; //size of buffer, which we must not exceed
 
-      int max_bits;  //maximum number of bits that can be store in tmp
+      int max_bits;  //maximum number of bits that can be store in a byte
       int used_bits; //number of occupied bits in tmp
-      ui32 tmp;      //temporary storage of coded bits
+      ui64 tmp;      //temporary storage of coded bits
     };
 
     //////////////////////////////////////////////////////////////////////////
@@ -422,22 +422,31 @@ namespace ojph {
     static inline void
     ms_encode(ms_struct* msp, ui32 cwd, int cwd_len)
     {
-      while (cwd_len > 0)
+      //cwd holds no bits beyond cwd_len; bits are accumulated in tmp,
+      // which has room for a full codeword, and flushed a byte at a time
+      msp->tmp |= (ui64)cwd << msp->used_bits;
+      msp->used_bits += cwd_len;
+      while (msp->used_bits >= msp->max_bits)
       {
         if (msp->pos >= msp->buf_size)
           grk::Logger::logger_.error( "magnitude sign encoder's buffer is full");
-        int t = ojph_min(msp->max_bits - msp->used_bits, cwd_len);
-        msp->tmp |= (cwd & ((1U << t) - 1)) << msp->used_bits;
-        msp->used_bits += t;
-        cwd >>= t;
-        cwd_len -= t;
-        if (msp->used_bits >= msp->max_bits)
-        {
-          msp->buf[msp->pos++] = (ui8)msp->tmp;
-          msp->max_bits = (msp->tmp == 0xFF) ? 7 : 8;
-          msp->tmp = 0;
-          msp->used_bits = 0;
-        }
+        ui8 byte = (ui8)(msp->tmp & ((1U << msp->max_bits) - 1));
+        msp->buf[msp->pos++] = byte;
+        msp->tmp >>= msp->max_bits;
+        msp->used_bits -= msp->max_bits;
+        msp->max_bits = (byte == 0xFF) ? 7 : 8;
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    static inline void
+    ms_encode_quad(ms_struct* msp, const ui32* s, int rho, int U_q,
+                   ui16 tuple)
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        int m = ((rho >> i) & 1) ? U_q - ((tuple >> i) & 1) : 0;
+        ms_encode(msp, s[i] & ((1U << m) - 1), m);
       }
     }
 
@@ -508,185 +517,58 @@ namespace ojph {
       ui8* lep = e_val;     lep[0] = 0;
       ui8* lcxp = cx_val;   lcxp[0] = 0;
 
+      //quad info and magnitude-sign values for a pair of rows,
+      // see ojph_encode_quads; a row holds at most 512 quads
+      ui32 quad_info[512];
+      ui32 quad_s[4 * 512];
+
       //initial row of quads
-      int e_qmax[2] = {0,0}, e_q[8] = {0,0,0,0,0,0,0,0};
-      int rho[2] = {0,0};
+      ojph_encode_quads(buf, height > 1 ? buf + stride : NULL, width, p,
+                        quad_info, quad_s);
       int c_q0 = 0;
-      ui32 s[8] = {0,0,0,0,0,0,0,0}, val, t;
-      ui32 y = 0;
-      ui32 *sp = buf;
-      for (ui32 x = 0; x < width; x += 4)
+      const ui32 *qi = quad_info, *qs = quad_s;
+      for (ui32 x = 0; x < width; x += 4, qi += 2, qs += 8)
       {
-        //prepare two quads
-        t = sp[0];
-        val = t + t; //multiply by 2 and get rid of sign
-        val >>= p;  // 2 \mu_p + x
-        val &= ~1u; // 2 \mu_p
-        if (val)
-        {
-          rho[0] = 1;
-          e_q[0] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-          e_qmax[0] = e_q[0];
-          s[0] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-        }
-
-        t = height > 1 ? sp[stride] : 0;
-        ++sp;
-        val = t + t; //multiply by 2 and get rid of sign
-        val >>= p; // 2 \mu_p + x
-        val &= ~1u;// 2 \mu_p
-        if (val)
-        {
-          rho[0] += 2;
-          e_q[1] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-          e_qmax[0] = ojph_max(e_qmax[0], e_q[1]);
-          s[1] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-        }
-
-        if (x+1 < width)
-        {
-          t = sp[0];
-          val = t + t; //multiply by 2 and get rid of sign
-          val >>= p; // 2 \mu_p + x
-          val &= ~1u;// 2 \mu_p
-          if (val)
-          {
-            rho[0] += 4;
-            e_q[2] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-            e_qmax[0] = ojph_max(e_qmax[0], e_q[2]);
-            s[2] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-          }
-
-          t = height > 1 ? sp[stride] : 0;
-          ++sp;
-          val = t + t; //multiply by 2 and get rid of sign
-          val >>= p; // 2 \mu_p + x
-          val &= ~1u;// 2 \mu_p
-          if (val)
-          {
-            rho[0] += 8;
-            e_q[3] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-            e_qmax[0] = ojph_max(e_qmax[0], e_q[3]);
-            s[3] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-          }
-        }
-
-        int Uq0 = ojph_max(e_qmax[0], 1); //kappa_q = 1
+        int rho0 = (int)(qi[0] & 0xF);
+        int e_qmax0 = (int)((qi[0] >> 8) & 0xFF);
+        int Uq0 = ojph_max(e_qmax0, 1); //kappa_q = 1
         int u_q0 = Uq0 - 1, u_q1 = 0; //kappa_q = 1
 
-        int eps0 = 0;
-        if (u_q0 > 0)
-        {
-          eps0 |= (e_q[0] == e_qmax[0]);
-          eps0 |= (e_q[1] == e_qmax[0]) << 1;
-          eps0 |= (e_q[2] == e_qmax[0]) << 2;
-          eps0 |= (e_q[3] == e_qmax[0]) << 3;
-        }
-        lep[0] = ojph_max(lep[0], (ui8)e_q[1]); lep++;
-        lep[0] = (ui8)e_q[3];
-        lcxp[0] = (ui8)(lcxp[0] | (ui8)((rho[0] & 2) >> 1)); lcxp++;
-        lcxp[0] = (ui8)((rho[0] & 8) >> 3);
+        int eps0 = u_q0 > 0 ? (int)((qi[0] >> 4) & 0xF) : 0;
+        lep[0] = ojph_max(lep[0], (ui8)(qi[0] >> 16)); lep++;
+        lep[0] = (ui8)(qi[0] >> 24);
+        lcxp[0] = (ui8)(lcxp[0] | (ui8)((rho0 & 2) >> 1)); lcxp++;
+        lcxp[0] = (ui8)((rho0 & 8) >> 3);
 
-        ui16 tuple0 = vlc_tbl0[(c_q0 << 8) + (rho[0] << 4) + eps0];
+        ui16 tuple0 = vlc_tbl0[(c_q0 << 8) + (rho0 << 4) + eps0];
         vlc_encode(&vlc, tuple0 >> 8, (tuple0 >> 4) & 7);
 
         if (c_q0 == 0)
-            mel_encode(&mel, rho[0] != 0);
+            mel_encode(&mel, rho0 != 0);
 
-        int m = (rho[0] & 1) ? Uq0 - (tuple0 & 1) : 0;
-        ms_encode(&ms, s[0] & ((1U<<m)-1), m);
-        m = (rho[0] & 2) ? Uq0 - ((tuple0 & 2) >> 1) : 0;
-        ms_encode(&ms, s[1] & ((1U<<m)-1), m);
-        m = (rho[0] & 4) ? Uq0 - ((tuple0 & 4) >> 2) : 0;
-        ms_encode(&ms, s[2] & ((1U<<m)-1), m);
-        m = (rho[0] & 8) ? Uq0 - ((tuple0 & 8) >> 3) : 0;
-        ms_encode(&ms, s[3] & ((1U<<m)-1), m);
+        ms_encode_quad(&ms, qs, rho0, Uq0, tuple0);
 
+        int rho1 = 0;
         if (x+2 < width)
         {
-          t = sp[0];
-          val = t + t; //multiply by 2 and get rid of sign
-          val >>= p; // 2 \mu_p + x
-          val &= ~1u;// 2 \mu_p
-          if (val)
-          {
-            rho[1] = 1;
-            e_q[4] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-            e_qmax[1] = e_q[4];
-            s[4] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-          }
-
-          t = height > 1 ? sp[stride] : 0;
-          ++sp;
-          val = t + t; //multiply by 2 and get rid of sign
-          val >>= p; // 2 \mu_p + x
-          val &= ~1u;// 2 \mu_p
-          if (val)
-          {
-            rho[1] += 2;
-            e_q[5] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-            e_qmax[1] = ojph_max(e_qmax[1], e_q[5]);
-            s[5] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-          }
-
-          if (x+3 < width)
-          {
-            t = sp[0];
-            val = t + t; //multiply by 2 and get rid of sign
-            val >>= p; // 2 \mu_p + x
-            val &= ~1u;// 2 \mu_p
-            if (val)
-            {
-              rho[1] += 4;
-              e_q[6] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-              e_qmax[1] = ojph_max(e_qmax[1], e_q[6]);
-              s[6] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-            }
-
-            t = height > 1 ? sp[stride] : 0;
-            ++sp;
-            val = t + t; //multiply by 2 and get rid of sign
-            val >>= p; // 2 \mu_p + x
-            val &= ~1u;// 2 \mu_p
-            if (val)
-            {
-              rho[1] += 8;
-              e_q[7] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-              e_qmax[1] = ojph_max(e_qmax[1], e_q[7]);
-              s[7] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-            }
-          }
-
-          int c_q1 = (rho[0] >> 1) | (rho[0] & 1);
-          int Uq1 = ojph_max(e_qmax[1], 1); //kappa_q = 1
+          rho1 = (int)(qi[1] & 0xF);
+          int e_qmax1 = (int)((qi[1] >> 8) & 0xFF);
+          int c_q1 = (rho0 >> 1) | (rho0 & 1);
+          int Uq1 = ojph_max(e_qmax1, 1); //kappa_q = 1
           u_q1 = Uq1 - 1; //kappa_q = 1
 
-          int eps1 = 0;
-          if (u_q1 > 0)
-          {
-            eps1 |= (e_q[4] == e_qmax[1]);
-            eps1 |= (e_q[5] == e_qmax[1]) << 1;
-            eps1 |= (e_q[6] == e_qmax[1]) << 2;
-            eps1 |= (e_q[7] == e_qmax[1]) << 3;
-          }
-          lep[0] = ojph_max(lep[0], (ui8)e_q[5]); lep++;
-          lep[0] = (ui8)e_q[7];
-          lcxp[0] |= (ui8)(lcxp[0] | (ui8)((rho[1] & 2) >> 1)); lcxp++;
-          lcxp[0] = (ui8)((rho[1] & 8) >> 3);
-          ui16 tuple1 = vlc_tbl0[(c_q1 << 8) + (rho[1] << 4) + eps1];
+          int eps1 = u_q1 > 0 ? (int)((qi[1] >> 4) & 0xF) : 0;
+          lep[0] = ojph_max(lep[0], (ui8)(qi[1] >> 16)); lep++;
+          lep[0] = (ui8)(qi[1] >> 24);
+          lcxp[0] = (ui8)(lcxp[0] | (ui8)((rho1 & 2) >> 1)); lcxp++;
+          lcxp[0] = (ui8)((rho1 & 8) >> 3);
+          ui16 tuple1 = vlc_tbl0[(c_q1 << 8) + (rho1 << 4) + eps1];
           vlc_encode(&vlc, tuple1 >> 8, (tuple1 >> 4) & 7);
 
           if (c_q1 == 0)
-            mel_encode(&mel, rho[1] != 0);
-
-          int m = (rho[1] & 1) ? Uq1 - (tuple1 & 1) : 0;
-          ms_encode(&ms, s[4] & ((1U<<m)-1), m);
-          m = (rho[1] & 2) ? Uq1 - ((tuple1 & 2) >> 1) : 0;
-          ms_encode(&ms, s[5] & ((1U<<m)-1), m);
-          m = (rho[1] & 4) ? Uq1 - ((tuple1 & 4) >> 2) : 0;
-          ms_encode(&ms, s[6] & ((1U<<m)-1), m);
-          m = (rho[1] & 8) ? Uq1 - ((tuple1 & 8) >> 3) : 0;
-          ms_encode(&ms, s[7] & ((1U<<m)-1), m);
+            mel_encode(&mel, rho1 != 0);
+
+          ms_encode_quad(&ms, qs + 4, rho1, Uq1, tuple1);
         }
 
         if (u_q0 > 0 && u_q1 > 0)
@@ -714,15 +596,12 @@ namespace ojph {
         }
 
         //prepare for next iteration
-        c_q0 = (rho[1] >> 1) | (rho[1] & 1);
-        s[0] = s[1] = s[2] = s[3] = s[4] = s[5] = s[6] = s[7] = 0;
-        e_q[0]=e_q[1]=e_q[2]=e_q[3]=e_q[4]=e_q[5]=e_q[6]=e_q[7]=0;
-        rho[0] = rho[1] = 0; e_qmax[0] = e_qmax[1] = 0;
+        c_q0 = (rho1 >> 1) | (rho1 & 1);
       }
 
       lep[1] = 0;
 
-      for (y = 2; y < height; y += 2)
+      for (ui32 y = 2; y < height; y += 2)
       {
         lep = e_val;
         int max_e = ojph_max(lep[0], lep[1]) - 1;
@@ -731,184 +610,58 @@ namespace ojph {
         c_q0 = lcxp[0] + (lcxp[1] << 2);
         lcxp[0] = 0;
 
-        sp = buf + y * stride;
-        for (ui32 x = 0; x < width; x += 4)
+        ui32 *sp = buf + y * stride;
+        ojph_encode_quads(sp, y + 1 < height ? sp + stride : NULL, width, p,
+                          quad_info, quad_s);
+        qi = quad_info;
+        qs = quad_s;
+        for (ui32 x = 0; x < width; x += 4, qi += 2, qs += 8)
         {
-          //prepare two quads
-          t = sp[0];
-          val = t + t; //multiply by 2 and get rid of sign
-          val >>= p; // 2 \mu_p + x
-          val &= ~1u;// 2 \mu_p
-          if (val)
-          {
-            rho[0] = 1;
-            e_q[0] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-            e_qmax[0] = e_q[0];
-            s[0] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-          }
-
-          t = y + 1 < height ? sp[stride] : 0;
-          ++sp;
-          val = t + t; //multiply by 2 and get rid of sign
-          val >>= p; // 2 \mu_p + x
-          val &= ~1u;// 2 \mu_p
-          if (val)
-          {
-            rho[0] += 2;
-            e_q[1] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-            e_qmax[0] = ojph_max(e_qmax[0], e_q[1]);
-            s[1] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-          }
-
-          if (x+1 < width)
-          {
-            t = sp[0];
-            val = t + t; //multiply by 2 and get rid of sign
-            val >>= p; // 2 \mu_p + x
-            val &= ~1u;// 2 \mu_p
-            if (val)
-            {
-              rho[0] += 4;
-              e_q[2] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-              e_qmax[0] = ojph_max(e_qmax[0], e_q[2]);
-              s[2] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-            }
-
-            t = y + 1 < height ? sp[stride] : 0;
-            ++sp;
-            val = t + t; //multiply by 2 and get rid of sign
-            val >>= p; // 2 \mu_p + x
-            val &= ~1u;// 2 \mu_p
-            if (val)
-            {
-              rho[0] += 8;
-              e_q[3] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-              e_qmax[0] = ojph_max(e_qmax[0], e_q[3]);
-              s[3] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-            }
-          }
-
-          int kappa = (rho[0] & (rho[0]-1)) ? ojph_max(1,max_e) : 1;
-          int Uq0 = ojph_max(e_qmax[0], kappa);
+          int rho0 = (int)(qi[0] & 0xF);
+          int e_qmax0 = (int)((qi[0] >> 8) & 0xFF);
+          int kappa = (rho0 & (rho0-1)) ? ojph_max(1,max_e) : 1;
+          int Uq0 = ojph_max(e_qmax0, kappa);
           int u_q0 = Uq0 - kappa, u_q1 = 0;
 
-          int eps0 = 0;
-          if (u_q0 > 0)
-          {
-            eps0 |= (e_q[0] == e_qmax[0]);
-            eps0 |= (e_q[1] == e_qmax[0]) << 1;
-            eps0 |= (e_q[2] == e_qmax[0]) << 2;
-            eps0 |= (e_q[3] == e_qmax[0]) << 3;
-          }
-          lep[0] = ojph_max(lep[0], (ui8)e_q[1]); lep++;
+          int eps0 = u_q0 > 0 ? (int)((qi[0] >> 4) & 0xF) : 0;
+          lep[0] = ojph_max(lep[0], (ui8)(qi[0] >> 16)); lep++;
           max_e = ojph_max(lep[0], lep[1]) - 1;
-          lep[0] = (ui8)e_q[3];
-          lcxp[0] = (ui8)(lcxp[0] | (ui8)((rho[0] & 2) >> 1)); lcxp++;
+          lep[0] = (ui8)(qi[0] >> 24);
+          lcxp[0] = (ui8)(lcxp[0] | (ui8)((rho0 & 2) >> 1)); lcxp++;
           int c_q1 = lcxp[0] + (lcxp[1] << 2);
-          lcxp[0] = (ui8)((rho[0] & 8) >> 3);
-          ui16 tuple0 = vlc_tbl1[(c_q0 << 8) + (rho[0] << 4) + eps0];
+          lcxp[0] = (ui8)((rho0 & 8) >> 3);
+          ui16 tuple0 = vlc_tbl1[(c_q0 << 8) + (rho0 << 4) + eps0];
           vlc_encode(&vlc, tuple0 >> 8, (tuple0 >> 4) & 7);
 
           if (c_q0 == 0)
-              mel_encode(&mel, rho[0] != 0);
+              mel_encode(&mel, rho0 != 0);
 
-          int m = (rho[0] & 1) ? Uq0 - (tuple0 & 1) : 0;
-          ms_encode(&ms, s[0] & ((1U<<m)-1), m);
-          m = (rho[0] & 2) ? Uq0 - ((tuple0 & 2) >> 1) : 0;
-          ms_encode(&ms, s[1] & ((1U<<m)-1), m);
-          m = (rho[0] & 4) ? Uq0 - ((tuple0 & 4) >> 2) : 0;
-          ms_encode(&ms, s[2] & ((1U<<m)-1), m);
-          m = (rho[0] & 8) ? Uq0 - ((tuple0 & 8) >> 3) : 0;
-          ms_encode(&ms, s[3] & ((1U<<m)-1), m);
+          ms_encode_quad(&ms, qs, rho0, Uq0, tuple0);
 
+          int rho1 = 0;
           if (x+2 < width)
           {
-            t = sp[0];
-            val = t + t; //multiply by 2 and get rid of sign
-            val >>= p; // 2 \mu_p + x
-            val &= ~1u;// 2 \mu_p
-            if (val)
-            {
-              rho[1] = 1;
-              e_q[4] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-              e_qmax[1] = e_q[4];
-              s[4] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-            }
-
-            t = y + 1 < height ? sp[stride] : 0;
-            ++sp;
-            val = t + t; //multiply by 2 and get rid of sign
-            val >>= p; // 2 \mu_p + x
-            val &= ~1u;// 2 \mu_p
-            if (val)
-            {
-              rho[1] += 2;
-              e_q[5] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-              e_qmax[1] = ojph_max(e_qmax[1], e_q[5]);
-              s[5] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-            }
-
-            if (x+3 < width)
-            {
-              t = sp[0];
-              val = t + t; //multiply by 2 and get rid of sign
-              val >>= p; // 2 \mu_p + x
-              val &= ~1u;// 2 \mu_p
-              if (val)
-              {
-                rho[1] += 4;
-                e_q[6] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-                e_qmax[1] = ojph_max(e_qmax[1], e_q[6]);
-                s[6] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-              }
-
-              t = y + 1 < height ? sp[stride] : 0;
-              ++sp;
-              val = t + t; //multiply by 2 and get rid of sign
-              val >>= p; // 2 \mu_p + x
-              val &= ~1u;// 2 \mu_p
-              if (val)
-              {
-                rho[1] += 8;
-                e_q[7] = 32 - (int)count_leading_zeros(--val); //2\mu_p - 1
-                e_qmax[1] = ojph_max(e_qmax[1], e_q[7]);
-                s[7] = --val + (t >> 31); //v_n = 2(\mu_p-1) + s_n
-              }
-            }
-
-            kappa = (rho[1] & (rho[1]-1)) ? ojph_max(1,max_e) : 1;
-            c_q1 |= ((rho[0] & 4) >> 1) | ((rho[0] & 8) >> 2);
-            int Uq1 = ojph_max(e_qmax[1], kappa);
+            rho1 = (int)(qi[1] & 0xF);
+            int e_qmax1 = (int)((qi[1] >> 8) & 0xFF);
+            kappa = (rho1 & (rho1-1)) ? ojph_max(1,max_e) : 1;
+            c_q1 |= ((rho0 & 4) >> 1) | ((rho0 & 8) >> 2);
+            int Uq1 = ojph_max(e_qmax1, kappa);
             u_q1 = Uq1 - kappa;
 
-            int eps1 = 0;
-            if (u_q1 > 0)
-            {
-              eps1 |= (e_q[4] == e_qmax[1]);
-              eps1 |= (e_q[5] == e_qmax[1]) << 1;
-              eps1 |= (e_q[6] == e_qmax[1]) << 2;
-              eps1 |= (e_q[7] == e_qmax[1]) << 3;
-            }
-            lep[0] = ojph_max(lep[0], (ui8)e_q[5]); lep++;
+            int eps1 = u_q1 > 0 ? (int)((qi[1] >> 4) & 0xF) : 0;
+            lep[0] = ojph_max(lep[0], (ui8)(qi[1] >> 16)); lep++;
             max_e = ojph_max(lep[0], lep[1]) - 1;
-            lep[0] = (ui8)e_q[7];
-            lcxp[0] = (ui8)(lcxp[0] | (ui8)((rho[1] & 2) >> 1)); lcxp++;
+            lep[0] = (ui8)(qi[1] >> 24);
+            lcxp[0] = (ui8)(lcxp[0] | (ui8)((rho1 & 2) >> 1)); lcxp++;
             c_q0 = lcxp[0] + (lcxp[1] << 2);
-            lcxp[0] = (ui8)((rho[1] & 8) >> 3);
-            ui16 tuple1 = vlc_tbl1[(c_q1 << 8) + (rho[1] << 4) + eps1];
+            lcxp[0] = (ui8)((rho1 & 8) >> 3);
+            ui16 tuple1 = vlc_tbl1[(c_q1 << 8) + (rho1 << 4) + eps1];
             vlc_encode(&vlc, tuple1 >> 8, (tuple1 >> 4) & 7);
 
             if (c_q1 == 0)
-              mel_encode(&mel, rho[1] != 0);
-
-            int m = (rho[1] & 1) ? Uq1 - (tuple1 & 1) : 0;
-            ms_encode(&ms, s[4] & ((1U<<m)-1), m);
-            m = (rho[1] & 2) ? Uq1 - ((tuple1 & 2) >> 1) : 0;
-            ms_encode(&ms, s[5] & ((1U<<m)-1), m);
-            m = (rho[1] & 4) ? Uq1 - ((tuple1 & 4) >> 2) : 0;
-            ms_encode(&ms, s[6] & ((1U<<m)-1), m);
-            m = (rho[1] & 8) ? Uq1 - ((tuple1 & 8) >> 3) : 0;
-            ms_encode(&ms, s[7] & ((1U<<m)-1), m);
+              mel_encode(&mel, rho1 != 0);
+
+            ms_encode_quad(&ms, qs + 4, rho1, Uq1, tuple1);
           }
 
           vlc_encode(&vlc, ulvc_cwd_pre[u_q0], ulvc_cwd_pre_len[u_q0]);
@@ -917,14 +670,10 @@ namespace ojph {
           vlc_encode(&vlc, ulvc_cwd_suf[u_q1], ulvc_cwd_suf_len[u_q1]);
 
           //prepare for next iteration
-          c_q0 |= ((rho[1] & 4) >> 1) | ((rho[1] & 8) >> 2);
-          s[0] = s[1] = s[2] = s[3] = s[4] = s[5] = s[6] = s[7] = 0;
-          e_q[0]=e_q[1]=e_q[2]=e_q[3]=e_q[4]=e_q[5]=e_q[6]=e_q[7]=0;
-          rho[0] = rho[1] = 0; e_qmax[0] = e_qmax[1] = 0;
+          c_q0 |= ((rho1 & 4) >> 1) | ((rho1 & 8) >> 2);
         }
       }
 
-
       terminate_mel_vlc(&mel, &vlc);
       ms_terminate(&ms);
 
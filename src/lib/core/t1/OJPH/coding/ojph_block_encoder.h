@@ -57,6 +57,16 @@ namespace ojph {
                             ui32* lengths, 
                             ojph::mem_elastic_allocator *elastic,
                             ojph::coded_lists *& coded);
+
+    //////////////////////////////////////////////////////////////////////////
+    // computes, for each quad in a pair of rows, rho, eps candidates,
+    // e_qmax and the exponents of the two bottom samples, packed as
+    // rho | eps << 4 | e_qmax << 8 | e_q[1] << 16 | e_q[3] << 24,
+    // together with the four magnitude-sign values v_n of the quad.
+    // row1 is null if the bottom row lies outside the code block
+    void
+      ojph_encode_quads(const ui32* row0, const ui32* row1, ui32 width,
+                        ui32 p, ui32* info, ui32* s);
   }
 }
 
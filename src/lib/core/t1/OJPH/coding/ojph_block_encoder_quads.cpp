@@ -0,0 +1,136 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// SIMD significance, exponent and magnitude-sign computation for the HT block encoder
+
+#include <cstring>
+#include "ojph_defs.h"
+#include "ojph_block_encoder.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "t1/OJPH/coding/ojph_block_encoder_quads.cpp"
+#include <hwy/foreach_target.h>
+#include <hwy/highway.h>
+HWY_BEFORE_NAMESPACE();
+namespace ojph
+{
+namespace HWY_NAMESPACE
+{
+	using namespace hwy::HWY_NAMESPACE;
+
+	/**
+	 * Exponent e_q = 32 - lzcnt(v - 1) of 2*mu_p, and magnitude-sign value
+	 * v_n = 2(mu_p - 1) + s_n, for sign-magnitude samples t.
+	 * Both are zero for insignificant samples.
+	 */
+	template<class D, class V>
+	HWY_INLINE void exponent(D du, V t, int p, V& e, V& s)
+	{
+		const RebindToSigned<D> di;
+		const RebindToFloat<D> df;
+		const auto one = Set(du, 1);
+		auto val = AndNot(one, ShiftRightSame(Add(t, t), p));
+		auto sig = Ne(val, Zero(du));
+		auto v = Sub(val, one);
+		// keep only bits without a set bit above them, so that conversion to float
+		// cannot round up to the next power of two
+		auto bits = AndNot(ShiftRight<1>(v), v);
+		auto f = BitCast(du, ConvertTo(df, BitCast(di, bits)));
+		auto exp = Sub(ShiftRight<23>(f), Set(du, 126));
+		exp = IfThenElse(RebindMask(du, Lt(BitCast(di, v), Zero(di))), Set(du, 32), exp);
+		e = IfThenElseZero(sig, exp);
+		s = IfThenElseZero(sig, Add(Sub(val, Set(du, 2)), ShiftRight<31>(t)));
+	}
+
+	/**
+	 * Process one vector of quads, reading two columns per quad from each row
+	 */
+	template<class D>
+	HWY_INLINE void quads(D du, const ui32* row0, const ui32* row1, int p, ui32* info, ui32* s)
+	{
+		using V = decltype(Zero(du));
+		V t[4];
+		LoadInterleaved2(du, row0, t[0], t[2]);
+		if(row1)
+			LoadInterleaved2(du, row1, t[1], t[3]);
+		else
+			t[1] = t[3] = Zero(du);
+
+		// samples are in quad scan order: top left, bottom left, top right, bottom right
+		V e[4], v[4];
+		for(uint32_t i = 0; i < 4; ++i)
+			exponent(du, t[i], p, e[i], v[i]);
+		StoreInterleaved4(v[0], v[1], v[2], v[3], du, s);
+
+		auto e_qmax = Max(Max(e[0], e[1]), Max(e[2], e[3]));
+		auto rho = Zero(du);
+		auto eps = Zero(du);
+		for(uint32_t i = 0; i < 4; ++i)
+		{
+			auto bit = Set(du, 1U << i);
+			rho = Or(rho, IfThenElseZero(Ne(e[i], Zero(du)), bit));
+			eps = Or(eps, IfThenElseZero(Eq(e[i], e_qmax), bit));
+		}
+		auto packed = Or(Or(rho, ShiftLeft<4>(eps)), ShiftLeft<8>(e_qmax));
+		packed = Or(packed, Or(ShiftLeft<16>(e[1]), ShiftLeft<24>(e[3])));
+		StoreU(packed, du, info);
+	}
+
+	void hwy_encode_quads(const ui32* row0, const ui32* row1, ui32 width, ui32 p, ui32* info,
+						  ui32* s)
+	{
+		const HWY_FULL(uint32_t) du;
+		const ui32 N = (ui32)Lanes(du);
+		const ui32 num_quads = (width + 1) >> 1;
+		ui32 q = 0;
+		for(; q + N <= num_quads && 2 * (q + N) <= width; q += N)
+			quads(du, row0 + 2 * q, row1 ? row1 + 2 * q : nullptr, (int)p, info + q, s + 4 * q);
+		if(q == num_quads)
+			return;
+
+		// partial vector : zero-pad columns beyond the code block width
+		constexpr size_t kMaxLanes = HWY_MAX_BYTES / sizeof(ui32);
+		HWY_ALIGN ui32 tail0[2 * kMaxLanes] = {0};
+		HWY_ALIGN ui32 tail1[2 * kMaxLanes] = {0};
+		HWY_ALIGN ui32 tailInfo[kMaxLanes];
+		HWY_ALIGN ui32 tailS[4 * kMaxLanes];
+		ui32 cols = width - 2 * q;
+		memcpy(tail0, row0 + 2 * q, cols * sizeof(ui32));
+		if(row1)
+			memcpy(tail1, row1 + 2 * q, cols * sizeof(ui32));
+		quads(du, tail0, row1 ? tail1 : nullptr, (int)p, tailInfo, tailS);
+		memcpy(info + q, tailInfo, (num_quads - q) * sizeof(ui32));
+		memcpy(s + 4 * q, tailS, 4 * (num_quads - q) * sizeof(ui32));
+	}
+} // namespace HWY_NAMESPACE
+} // namespace ojph
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace ojph
+{
+HWY_EXPORT(hwy_encode_quads);
+namespace local
+{
+	void ojph_encode_quads(const ui32* row0, const ui32* row1, ui32 width, ui32 p, ui32* info,
+						   ui32* s)
+	{
+		HWY_DYNAMIC_DISPATCH(hwy_encode_quads)(row0, row1, width, p, info, s);
+	}
+} // namespace local
+} // namespace ojph
+#endif
@@ -21,8 +21,123 @@
 
 #include "grk_includes.h"
 
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "t1/part1/Quantizer.cpp"
+#include <hwy/foreach_target.h>
+#include <hwy/highway.h>
+HWY_BEFORE_NAMESPACE();
 namespace grk
 {
+namespace HWY_NAMESPACE
+{
+	using namespace hwy::HWY_NAMESPACE;
+
+	uint32_t hwy_quantize_rev(int32_t* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+							  uint32_t h)
+	{
+		const HWY_FULL(int32_t) di;
+		const RebindToUnsigned<decltype(di)> du;
+		const size_t N = Lanes(di);
+		const auto vsign = Set(di, INT32_MIN);
+		auto vmax = Zero(du);
+		uint32_t maximum = 0;
+		for(uint32_t j = 0; j < h; ++j)
+		{
+			size_t i = 0;
+			for(; i + N <= w; i += N)
+			{
+				auto temp = ShiftLeft<T1_NMSEDEC_FRACBITS>(LoadU(di, src + i));
+				StoreU(temp, di, src + i);
+				auto mag = Abs(temp);
+				vmax = Max(vmax, BitCast(du, mag));
+				StoreU(Or(mag, IfThenElseZero(Ne(mag, temp), vsign)), di, dest + i);
+			}
+			for(; i < w; ++i)
+			{
+				int32_t temp = (src[i] *= (1 << T1_NMSEDEC_FRACBITS));
+				int32_t mag = temp * ((temp > 0) - (temp < 0));
+				if((uint32_t)mag > maximum)
+					maximum = (uint32_t)mag;
+				int32_t sgn = int32_t((uint32_t)(mag != temp) * 0x80000000);
+				dest[i] = sgn | mag;
+			}
+			src += srcStride;
+			dest += w;
+		}
+
+		return std::max(maximum, GetLane(MaxOfLanes(du, vmax)));
+	}
+
+	uint32_t hwy_quantize_irrev(const float* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+								uint32_t h, double invStepSize)
+	{
+		uint32_t maximum = 0;
+#if HWY_HAVE_FLOAT64
+		// samples are scaled in double precision, as in the scalar path,
+		// so vectors hold as many samples as there are double lanes
+		const HWY_FULL(double) dd;
+		const Rebind<float, decltype(dd)> df;
+		const Rebind<int32_t, decltype(dd)> di;
+		const RebindToUnsigned<decltype(di)> du;
+		const size_t N = Lanes(dd);
+		const auto vquant = Set(dd, invStepSize);
+		const auto vscale = Set(df, (float)(1 << T1_NMSEDEC_FRACBITS));
+		const auto vsign = Set(di, INT32_MIN);
+		auto vmax = Zero(du);
+#else
+		const size_t N = 0;
+#endif
+		for(uint32_t j = 0; j < h; ++j)
+		{
+			size_t i = 0;
+#if HWY_HAVE_FLOAT64
+			for(; i + N <= w; i += N)
+			{
+				auto scaled = DemoteTo(df, Mul(PromoteTo(dd, LoadU(df, src + i)), vquant));
+				auto temp = NearestInt(Mul(scaled, vscale));
+				auto mag = Abs(temp);
+				vmax = Max(vmax, BitCast(du, mag));
+				StoreU(Or(mag, IfThenElseZero(Ne(mag, temp), vsign)), di, dest + i);
+			}
+#endif
+			for(; i < w; ++i)
+			{
+				int32_t temp = (int32_t)grk_lrintf((float)(((double)src[i] * invStepSize)) *
+												   (1 << T1_NMSEDEC_FRACBITS));
+				int32_t mag = temp * ((temp > 0) - (temp < 0));
+				if((uint32_t)mag > maximum)
+					maximum = (uint32_t)mag;
+				int32_t sgn = int32_t((uint32_t)(mag != temp) * 0x80000000);
+				dest[i] = sgn | mag;
+			}
+			src += srcStride;
+			dest += w;
+		}
+#if HWY_HAVE_FLOAT64
+		maximum = std::max(maximum, GetLane(MaxOfLanes(du, vmax)));
+#endif
+
+		return maximum;
+	}
+} // namespace HWY_NAMESPACE
+} // namespace grk
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace grk
+{
+HWY_EXPORT(hwy_quantize_rev);
+HWY_EXPORT(hwy_quantize_irrev);
+
+uint32_t Quantizer::quantize(int32_t* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+							 uint32_t h, bool reversible, double invStepSize)
+{
+	if(reversible)
+		return HWY_DYNAMIC_DISPATCH(hwy_quantize_rev)(src, srcStride, dest, w, h);
+
+	return HWY_DYNAMIC_DISPATCH(hwy_quantize_irrev)((const float*)src, srcStride, dest, w, h,
+													 invStepSize);
+}
 Quantizer::Quantizer(bool reversible, uint8_t guard_bits)
 	: Sqcd((uint8_t)(guard_bits << 5)), num_decomps(0), isReversible(reversible)
 {
@@ -116,3 +231,4 @@ bool Quantizer::write([[maybe_unused]] BufferedStream* stream)
 }
 
 } // namespace grk
+#endif
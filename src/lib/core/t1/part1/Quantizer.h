@@ -47,6 +47,24 @@ struct Quantizer
 	virtual void generate(uint32_t decomps, uint32_t max_bit_depth, bool color_transform,
 						  bool is_signed);
 	virtual bool write(BufferedStream* stream);
+	/**
+	 * Scale code block samples, quantizing them if irreversible, and convert
+	 * to sign-magnitude for the Part 1 block coder.
+	 * Reversible samples are also scaled in place.
+	 *
+	 * @param src top left sample of code block in tile buffer
+	 * (float samples if irreversible)
+	 * @param srcStride tile buffer stride
+	 * @param dest code block destination buffer, with stride equal to code block width
+	 * @param w code block width
+	 * @param h code block height
+	 * @param reversible true if code block is reversible
+	 * @param invStepSize inverse of quantization step size
+	 *
+	 * @return maximum magnitude
+	 */
+	static uint32_t quantize(int32_t* src, uint32_t srcStride, int32_t* dest, uint32_t w,
+							 uint32_t h, bool reversible, double invStepSize);
 
   protected:
 	uint32_t get_num_guard_bits() const;
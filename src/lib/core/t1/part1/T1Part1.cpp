@@ -35,7 +35,6 @@ namespace t1_part1
 	}
 	bool T1Part1::preCompress(CompressBlockExec* block, uint32_t& maximum)
 	{
-		auto tile = block->tile;
 		auto cblk = block->cblk;
 		auto w = cblk->width();
 		auto h = cblk->height();
@@ -47,48 +46,9 @@ namespace t1_part1
 		}
 		if(!t1->alloc(w, h))
 			return false;
-		auto tileLineAdvance =
-			(tile->comps + block->compno)->getWindow()->getResWindowBufferHighestStride() - w;
-		uint32_t tileIndex = 0;
-		uint32_t cblk_index = 0;
-		maximum = 0;
-		auto uncompressedData = t1->getUncompressedData();
-		if(block->qmfbid == 1)
-		{
-			for(auto j = 0U; j < h; ++j)
-			{
-				for(auto i = 0U; i < w; ++i)
-				{
-					int32_t temp = (block->tiledp[tileIndex++] *= (1 << T1_NMSEDEC_FRACBITS));
-					int32_t mag = temp * ((temp > 0) - (temp < 0));
-					if((uint32_t)mag > maximum)
-						maximum = (uint32_t)mag;
-					int32_t sgn = int32_t((uint32_t)(mag != temp) * 0x80000000);
-					uncompressedData[cblk_index++] = sgn | mag;
-				}
-				tileIndex += tileLineAdvance;
-			}
-		}
-		else
-		{
-			auto tiledp = (float*)block->tiledp;
-			double quant = 1.0 / block->stepsize;
-			for(auto j = 0U; j < h; ++j)
-			{
-				for(auto i = 0U; i < w; ++i)
-				{
-					int32_t temp =
-						(int32_t)grk_lrintf((float)(((double)tiledp[tileIndex++] * quant)) *
-											(1 << T1_NMSEDEC_FRACBITS));
-					int32_t mag = temp * ((temp > 0) - (temp < 0));
-					if((uint32_t)mag > maximum)
-						maximum = (uint32_t)mag;
-					int32_t sgn = int32_t((uint32_t)(mag != temp) * 0x80000000);
-					uncompressedData[cblk_index++] = sgn | mag;
-				}
-				tileIndex += tileLineAdvance;
-			}
-		}
+		maximum = Quantizer::quantize(block->tiledp, block->stride, t1->getUncompressedData(), w, h,
+									  block->qmfbid == 1,
+									  block->qmfbid == 1 ? 1.0 : 1.0 / block->stepsize);
 
 		return true;
 	}
@@ -143,12 +103,25 @@ namespace t1_part1
 	bool T1Part1::decompress(DecompressBlockExec* block)
 	{
 		auto cblk = block->cblk;
-		cblk->alloc2d(true);
-		t1->attachUncompressedData(cblk->getBuffer(), cblk->width(), cblk->height());
+		if(!t1->allocDecompress(cblk->width(), cblk->height()))
+			return false;
+		auto uncompressedData = t1->getUncompressedData();
 		if(cblk->isClosed())
 		{
-			if(!cblk->seg_buffers.empty())
+			auto cache = block->codeblockCache;
+			if(!cblk->seg_buffers.empty() && cache &&
+			   cache->get(block->cacheKey(), block->cacheTag(), uncompressedData, cblk->width(),
+						   cblk->height(), cblk->width()))
+			{
+				cblk->setCacheState(GRK_CACHE_STATE_OPEN);
+			}
+			else if(!cblk->seg_buffers.empty())
 			{
+				// resume from decoder state of a decompression with fewer layers
+				std::vector<uint8_t> state;
+				if(cache)
+					cache->getResumable(block->cacheKey(), uncompressedData, cblk->width(),
+										cblk->height(), cblk->width(), state);
 				size_t totalSegLen =
 					cblk->getSegBuffersLen() + grk_cblk_dec_compressed_data_pad_right;
 				t1->allocCompressedData(totalSegLen);
@@ -159,15 +132,21 @@ namespace t1_part1
 					memcpy(compressedData + offset, b->buf, b->len);
 					offset += b->len;
 				}
-				bool ret = t1->decompress_cblk(cblk, compressedData, block->bandOrientation,
-											   block->cblk_sty);
+				bool saveState = cache && block->moreLayers;
+				bool ret =
+					t1->decompress_cblk(cblk, compressedData, block->bandOrientation,
+										block->cblk_sty, &state, saveState ? &state : nullptr);
 				cblk->setCacheState(ret ? GRK_CACHE_STATE_OPEN : GRK_CACHE_STATE_ERROR);
 				if(!ret)
 					return false;
+				if(cache)
+					cache->put(block->cacheKey(), block->cacheTag(), uncompressedData,
+							   cblk->width(), cblk->height(), cblk->width(),
+							   saveState ? &state : nullptr);
 			}
 		}
 
-		block->tilec->postProcess(t1->getUncompressedData(), block);
+		block->tilec->postProcess(uncompressedData, block);
 		cblk->release();
 
 		return true;
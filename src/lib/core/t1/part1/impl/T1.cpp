@@ -330,6 +330,17 @@ void T1::attachUncompressedData(int32_t* data, uint32_t width, uint32_t height)
 	uncompressedData = data;
 	alloc(width, height);
 }
+bool T1::allocDecompress(uint32_t width, uint32_t height)
+{
+	if(!ownsUncompressedData)
+		deallocUncompressedData();
+	size_t len = (size_t)width * height * sizeof(int32_t);
+	if(!allocUncompressedData(len))
+		return false;
+	memset(uncompressedData, 0, len);
+
+	return alloc(width, height);
+}
 bool T1::alloc(uint32_t width, uint32_t height)
 {
 	if(width == 0 || height == 0)
@@ -1257,8 +1268,28 @@ void T1::dec_refpass_mqc(int32_t bpno)
 	if(w == 64 && h == 64)
 		dec_refpass_mqc_internal(bpno, 64, 64, 66) else dec_refpass_mqc_internal(bpno, w, h, w + 2U)
 }
+bool T1::restoreDecompressState(DecompressCodeblock* cblk, const std::vector<uint8_t>& state,
+								T1DecompressState* header)
+{
+	if(state.size() != sizeof(T1DecompressState) + flagssize * sizeof(grk_flag))
+		return false;
+	memcpy(header, state.data(), sizeof(T1DecompressState));
+	if(header->numSegments == 0 || header->numSegments > cblk->getNumSegments())
+		return false;
+	auto seg = cblk->getSegment(header->numSegments - 1);
+	if(seg->numpasses < header->numPasses || seg->len < header->segmentLength)
+		return false;
+	// resuming within the final segment requires the MQ decoder registers
+	bool grown = seg->numpasses > header->numPasses || seg->len > header->segmentLength;
+	if(grown && !header->canResumeSegment)
+		return false;
+	memcpy(flags, state.data() + sizeof(T1DecompressState), flagssize * sizeof(grk_flag));
+
+	return true;
+}
 bool T1::decompress_cblk(DecompressCodeblock* cblk, uint8_t* compressedData, uint8_t orientation,
-						 uint32_t cblksty)
+						 uint32_t cblksty, const std::vector<uint8_t>* resumeState,
+						 std::vector<uint8_t>* saveState)
 {
 	auto mqc = &coder;
 	uint32_t cblkdataindex = 0;
@@ -1274,20 +1305,67 @@ bool T1::decompress_cblk(DecompressCodeblock* cblk, uint8_t* compressedData, uin
 	uint32_t passtype = 2;
 	mqc_resetstates(mqc);
 
-	for(uint32_t segno = 0; segno < cblk->getNumSegments(); ++segno)
+	uint32_t firstSegment = 0;
+	// number of passes already decoded in first segment
+	uint32_t firstPass = 0;
+	T1DecompressState header;
+	if(resumeState && !resumeState->empty())
+	{
+		if(restoreDecompressState(cblk, *resumeState, &header))
+		{
+			firstSegment = header.numSegments - 1;
+			firstPass = header.numPasses;
+			bpno_plus_one = header.bpnoPlusOne;
+			passtype = header.passType;
+			memcpy(mqc->ctxs, header.ctxs, sizeof(mqc->ctxs));
+			for(uint32_t segno = 0; segno < firstSegment; ++segno)
+				cblkdataindex += cblk->getSegment(segno)->len;
+			// final segment is complete : resume at start of next segment
+			auto seg = cblk->getSegment(firstSegment);
+			if(seg->numpasses == firstPass && seg->len == header.segmentLength)
+			{
+				cblkdataindex += seg->len;
+				firstSegment++;
+				firstPass = 0;
+			}
+		}
+		else
+		{
+			// decompress from the start
+			memset(uncompressedData, 0, (size_t)w * h * sizeof(int32_t));
+		}
+	}
+	uint32_t segno = firstSegment;
+	uint32_t passno = 0;
+	uint8_t type = T1_TYPE_MQ;
+	for(; segno < cblk->getNumSegments(); ++segno)
 	{
 		auto seg = cblk->getSegment(segno);
-		/* BYPASS mode */
-		uint8_t type = ((bpno_plus_one <= ((int32_t)(cblk->numbps)) - 4) && (passtype < 2) &&
-						(cblksty & GRK_CBLKSTY_LAZY))
-						   ? T1_TYPE_RAW
-						   : T1_TYPE_MQ;
-		if(type == T1_TYPE_RAW)
-			mqc_raw_init_dec(mqc, compressedData + cblkdataindex, seg->len);
+		passno = 0;
+		if(firstPass && segno == firstSegment)
+		{
+			type = header.type;
+			mqc_resume_dec(mqc, compressedData + cblkdataindex, seg->len, header.bpOffset);
+			mqc->a = header.a;
+			mqc->c = header.c;
+			mqc->ct = header.ct;
+			mqc_setcurctx(mqc, header.curctx);
+			passno = firstPass;
+		}
 		else
-			mqc_init_dec(mqc, compressedData + cblkdataindex, seg->len);
+		{
+			/* BYPASS mode */
+			type = ((bpno_plus_one <= ((int32_t)(cblk->numbps)) - 4) && (passtype < 2) &&
+					(cblksty & GRK_CBLKSTY_LAZY))
+					   ? T1_TYPE_RAW
+					   : T1_TYPE_MQ;
+			if(type == T1_TYPE_RAW)
+				mqc_raw_init_dec(mqc, compressedData + cblkdataindex, seg->len);
+			else
+				mqc_init_dec(mqc, compressedData + cblkdataindex, seg->len);
+		}
 		cblkdataindex += seg->len;
-		for(uint32_t passno = 0; (passno < seg->numpasses) && (bpno_plus_one >= 1); ++passno)
+		for(; (passno < seg->numpasses) && (bpno_plus_one >= 1); ++passno)
 		{
 			switch(passtype)
 			{
@@ -1329,6 +1407,35 @@ bool T1::decompress_cblk(DecompressCodeblock* cblk, uint8_t* compressedData, uin
 			grk::Logger::logger_.warn("PTERM check failure: %u synthesized 0xFF markers read",
 									  mqc->end_of_byte_stream_counter);
 	}
+	if(saveState)
+	{
+		saveState->clear();
+		// no segment was decoded
+		if(segno == firstSegment)
+			return true;
+		auto seg = cblk->getSegment(segno - 1);
+		memset(&header, 0, sizeof(header));
+		header.numSegments = segno;
+		header.numPasses = passno;
+		header.segmentLength = seg->len;
+		// decoder has only read bytes of the segment : it can resume from the same
+		// position once the segment grows
+		header.canResumeSegment =
+			type == T1_TYPE_MQ && mqc->end_of_byte_stream_counter == 0 && mqc->bp < mqc->end;
+		header.bpOffset = (uint32_t)(mqc->bp - mqc->start);
+		header.bpnoPlusOne = bpno_plus_one;
+		header.passType = passtype;
+		header.type = type;
+		header.a = mqc->a;
+		header.c = mqc->c;
+		header.ct = mqc->ct;
+		memcpy(header.ctxs, mqc->ctxs, sizeof(header.ctxs));
+		header.curctx = (uint32_t)(mqc->curctx - mqc->ctxs);
+		saveState->resize(sizeof(T1DecompressState) + flagssize * sizeof(grk_flag));
+		memcpy(saveState->data(), &header, sizeof(T1DecompressState));
+		memcpy(saveState->data() + sizeof(T1DecompressState), flags,
+			   flagssize * sizeof(grk_flag));
+	}
 
 	return true;
 }
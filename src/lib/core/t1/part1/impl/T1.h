@@ -28,13 +28,53 @@ namespace grk
 typedef uint32_t grk_flag;
 struct DecompressCodeblock;
 
+/**
+ * Decoder state after the final decoded coding pass of a code block,
+ * from which decompression resumes when more coding passes are available.
+ * Serialized state is followed by the code block flags.
+ */
+struct T1DecompressState
+{
+	// number of segments decoded
+	uint32_t numSegments;
+	// number of passes decoded in final segment
+	uint32_t numPasses;
+	// length of final segment
+	uint32_t segmentLength;
+	// true if MQ decoder can resume within final segment, once it has grown
+	bool canResumeSegment;
+	// offset of MQ decoder position from start of final segment
+	uint32_t bpOffset;
+	int32_t bpnoPlusOne;
+	uint32_t passType;
+	uint8_t type;
+	uint32_t a;
+	uint32_t c;
+	uint32_t ct;
+	const mqc_state* ctxs[MQC_NUMCTXS];
+	uint32_t curctx;
+};
+
 struct T1
 {
 	T1(bool isCompressor, uint32_t maxCblkW, uint32_t maxCblkH);
 	~T1();
 
+	/**
+	 * Decompress code block
+	 *
+	 * @param cblk code block
+	 * @param compressedData concatenated segments
+	 * @param orientation band orientation
+	 * @param cblksty code block style
+	 * @param resumeState optional decoder state of a previous decompression of
+	 * fewer coding passes, restored together with its coefficients by the caller.
+	 * If state can't be resumed, code block is decompressed from the start.
+	 * @param saveState optional storage for decoder state after final pass
+	 */
 	bool decompress_cblk(DecompressCodeblock* cblk, uint8_t* compressedData, uint8_t orientation,
-						 uint32_t cblksty);
+						 uint32_t cblksty, const std::vector<uint8_t>* resumeState,
+						 std::vector<uint8_t>* saveState);
 	void code_block_enc_deallocate(cblk_enc* p_code_block);
 	bool alloc(uint32_t w, uint32_t h);
 	double compress_cblk(cblk_enc* cblk, uint32_t max, uint8_t orientation, uint16_t compno,
@@ -44,6 +84,11 @@ struct T1
 
 	int32_t* getUncompressedData(void);
 	void attachUncompressedData(int32_t* data, uint32_t w, uint32_t h);
+	/**
+	 * Allocate zeroed decompress buffer owned by this T1, which is re-used
+	 * by all code blocks that it decompresses
+	 */
+	bool allocDecompress(uint32_t w, uint32_t h);
 	void allocCompressedData(size_t len);
 	uint8_t* getCompressedDataBuffer(void);
 	static double getnorm(uint32_t level, uint8_t orientation, bool reversible);
@@ -73,6 +118,9 @@ struct T1
 	uint32_t flagssize;
 	bool compressor;
 
+	bool restoreDecompressState(DecompressCodeblock* cblk, const std::vector<uint8_t>& state,
+								T1DecompressState* header);
+
 	template<uint32_t w, uint32_t h, bool vsc>
 	void dec_clnpass(int32_t bpno);
 	void dec_clnpass(int32_t bpno, int32_t cblksty);
@@ -116,6 +116,19 @@ passes, so as to restore the bytes temporarily overwritten.
 */
 void mqc_init_dec(mqcoder* mqc, uint8_t* bp, uint32_t len);
 
+/**
+Resume MQ decoding of a segment, after segment has grown in length.
+
+Caller restores the registers and contexts of the decoder, which must not
+have read past the end of the shorter segment.
+
+@param mqc MQC handle
+@param bp Pointer to the start of the segment
+@param len Length of the segment
+@param offset offset of current position from start of segment
+*/
+void mqc_resume_dec(mqcoder* mqc, uint8_t* bp, uint32_t len, uint32_t offset);
+
 /**
 Initialize the decoder for RAW decoding.
 
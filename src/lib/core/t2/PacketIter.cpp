@@ -863,9 +863,11 @@ void PacketIter::init(PacketManager* packetMan, uint32_t pino, TileCodingParams*
 		switch(prog.progression)
 		{
 			case GRK_LRCP:
-				prog.layE = (std::min)(prog.layE, packetManager->getTileProcessor()
-													  ->getTileCodingParams()
-													  ->numLayersToDecompress);
+				// tiles that retain all layers must parse all layers
+				if(!packetManager->getTileProcessor()->retainsLayers())
+					prog.layE = (std::min)(prog.layE, packetManager->getTileProcessor()
+														  ->getTileCodingParams()
+														  ->numLayersToDecompress);
 				break;
 			case GRK_RLCP:
 				prog.resE = (std::min)(prog.resE, maxNumDecompositionResolutions);
@@ -902,7 +904,9 @@ void PacketIter::init(PacketManager* packetMan, uint32_t pino, TileCodingParams*
 }
 bool PacketIter::isWholeTile(void)
 {
-	return compression_ || packetManager->getTileProcessor()->cp_->wholeTileDecompress_;
+	auto tp = packetManager->getTileProcessor();
+	// packet lengths are recorded for all packets in the tile
+	return compression_ || tp->cp_->wholeTileDecompress_ || tp->packetLengthCache.isRecording();
 }
 bool PacketIter::next(SparseBuffer* src)
 {
@@ -978,7 +982,7 @@ bool PacketIter::next_pcrl(SparseBuffer* src)
 			// windowed decode:
 			// bail out if we reach a precinct which is past the
 			// bottom, right hand corner of the tile window
-			if(singleProgression_)
+			if(singleProgression_ && !isWholeTile())
 			{
 				auto win = packetManager->getTileProcessor()->getUnreducedTileWindow();
 				if(!win.empty() && (y >= win.y1 || (win.y1 > 0 && y == win.y1 - 1 && x >= win.x1)))
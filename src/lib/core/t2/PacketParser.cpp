@@ -391,6 +391,7 @@ void PacketParser::readData(void)
 			uint32_t numPassesInPacket = cblk->getNumPassesInPacket(layno_);
 			do
 			{
+				uint8_t* segData = nullptr;
 				if(remainingTilePartBytes_ == 0)
 				{
 					Logger::logger_.warn("Packet data is truncated or packet header is corrupt :");
@@ -404,7 +405,10 @@ void PacketParser::readData(void)
 					// HT doesn't tolerate truncated code blocks since decoding runs both forward
 					// and reverse. So, in this case, we ignore the entire code block
 					if(tileProcessor_->cp_->tcps[0].isHT())
+					{
 						cblk->cleanUpSegBuffers();
+						cblk->contributions.clear();
+					}
 					seg->numBytesInPacket = 0;
 					seg->numpasses = 0;
 					break;
@@ -423,14 +427,19 @@ void PacketParser::readData(void)
 					// correct for truncated packet
 					if(seg->numBytesInPacket > remainingTilePartBytes_)
 						seg->numBytesInPacket = (uint32_t)remainingTilePartBytes_;
+					segData = data_ + offset;
 					cblk->seg_buffers.push_back(
-						new grk_buf8(data_ + offset, seg->numBytesInPacket, false));
+						new grk_buf8(segData, seg->numBytesInPacket, false));
 					offset += seg->numBytesInPacket;
 					cblk->compressedStream.len += seg->numBytesInPacket;
 					seg->len += seg->numBytesInPacket;
 					remainingTilePartBytes_ -= seg->numBytesInPacket;
 				}
 				seg->numpasses += seg->numPassesInPacket;
+				if(tileProcessor_->retainsLayers())
+					cblk->contributions.emplace_back(layno_, cblk->getNumSegments() - 1,
+													 seg->maxpasses, seg->numPassesInPacket,
+													 segData, seg->numBytesInPacket);
 				numPassesInPacket -= seg->numPassesInPacket;
 				if(numPassesInPacket > 0)
 					seg = cblk->nextSegment();
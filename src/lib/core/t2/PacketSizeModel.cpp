@@ -0,0 +1,198 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+/*
+ Length indicator increment for numpasses passes starting at first pass,
+ as calculated by T2Compress::compressHeader. Also returns number of
+ codeword segment length bits
+ */
+static uint8_t lengthIncrement(const CompressCodeblock* cblk, uint32_t firstPass,
+							   uint32_t numpasses, uint8_t lblock, uint32_t* lenBits)
+{
+	uint8_t increment = 0;
+	uint32_t len = 0;
+	uint32_t nump = 0;
+	uint32_t segments = 0;
+	uint32_t segmentBits = 0;
+	uint32_t lastPass = firstPass + numpasses - 1;
+	for(uint32_t passno = firstPass; passno <= lastPass; ++passno)
+	{
+		auto pass = cblk->passes + passno;
+		++nump;
+		len += pass->len;
+		if(pass->term || passno == lastPass)
+		{
+			increment = (uint8_t)std::max<int8_t>(
+				(int8_t)increment, int8_t(floorlog2(len) + 1 - (lblock + floorlog2(nump))));
+			segments++;
+			segmentBits += floorlog2(nump);
+			len = 0;
+			nump = 0;
+		}
+	}
+	*lenBits = segmentBits + segments * (uint32_t)(lblock + increment);
+
+	return increment;
+}
+static uint32_t numPassesBits(uint32_t n)
+{
+	if(n == 1)
+		return 1;
+	else if(n == 2)
+		return 2;
+	else if(n <= 5)
+		return 4;
+	else if(n <= 36)
+		return 9;
+
+	return 16;
+}
+
+PacketSizeModel::PacketSizeModel(TileProcessor* tileProcessor)
+	: layno_(0), packetOverhead_(0), previousBytes_(0), layerBytes_(0)
+{
+	auto tcp = tileProcessor->getTileCodingParams();
+	if(tcp->csty & J2K_CP_CSTY_SOP)
+		packetOverhead_ += 6;
+	if(tcp->csty & J2K_CP_CSTY_EPH)
+		packetOverhead_ += 2;
+	auto tile = tileProcessor->getTile();
+	for(uint16_t compno = 0; compno < tile->numcomps_; compno++)
+	{
+		auto tilec = tile->comps + compno;
+		for(uint8_t resno = 0; resno < tilec->numresolutions; resno++)
+		{
+			auto res = tilec->resolutions_ + resno;
+			auto firstPacket = (uint32_t)packets_.size();
+			packets_.resize(packets_.size() +
+							(uint64_t)res->precinctGridWidth * res->precinctGridHeight);
+			for(uint8_t bandIndex = 0; bandIndex < res->numTileBandWindows; bandIndex++)
+			{
+				auto band = res->tileBand + bandIndex;
+				for(auto prc : band->precincts)
+				{
+					uint64_t numCblks = prc->getNumCblks();
+					if(band->empty() || !numCblks)
+						continue;
+					// zero bit planes tag tree is shared by the precinct's blocks,
+					// so charge each block only its excess over the precinct minimum
+					uint8_t maxNumbps = 0;
+					for(uint64_t cblkno = 0; cblkno < numCblks; cblkno++)
+						maxNumbps = std::max(maxNumbps, prc->getCompressedBlockPtr(cblkno)->numbps);
+					for(uint64_t cblkno = 0; cblkno < numCblks; cblkno++)
+					{
+						BlockModel block;
+						block.cblk = prc->getCompressedBlockPtr(cblkno);
+						block.packet = firstPacket + (uint32_t)prc->precinctIndex;
+						block.imsbBits = 1U + maxNumbps - block.cblk->numbps;
+						block.numPasses = 0;
+						block.lblock = 0;
+						block.layerPasses = UINT_MAX;
+						block.layerBits = 0;
+						block.layerLen = 0;
+						blocks_.push_back(block);
+					}
+				}
+			}
+		}
+	}
+}
+void PacketSizeModel::beginLayer(uint16_t layno, uint64_t previousBytes)
+{
+	// commit final layers
+	for(; layno_ < layno; ++layno_)
+	{
+		for(auto& block : blocks_)
+		{
+			uint32_t numpasses = block.cblk->layers[layno_].numpasses;
+			if(!numpasses)
+				continue;
+			if(!block.lblock)
+				block.lblock = 3;
+			uint32_t lenBits;
+			block.lblock = (uint8_t)(block.lblock + lengthIncrement(block.cblk, block.numPasses,
+																	numpasses, block.lblock,
+																	&lenBits));
+			block.numPasses += numpasses;
+		}
+	}
+	for(auto& block : blocks_)
+	{
+		block.layerPasses = UINT_MAX;
+		block.layerBits = 0;
+		block.layerLen = 0;
+	}
+	layerBytes_ = 0;
+	for(auto& packet : packets_)
+	{
+		packet = {0, 0};
+		layerBytes_ += packetBytes(packet);
+	}
+	previousBytes_ = previousBytes;
+}
+uint32_t PacketSizeModel::headerBits(const BlockModel& block, uint32_t numpasses) const
+{
+	// inclusion bit, or inclusion tag tree bit for a block not yet included
+	uint32_t bits = 1;
+	if(!numpasses)
+		return bits;
+	uint8_t lblock = block.lblock;
+	if(!lblock)
+	{
+		bits += block.imsbBits;
+		lblock = 3;
+	}
+	bits += numPassesBits(numpasses);
+	uint32_t lenBits;
+	uint8_t increment = lengthIncrement(block.cblk, block.numPasses, numpasses, lblock, &lenBits);
+
+	// comma code
+	return bits + increment + 1U + lenBits;
+}
+uint64_t PacketSizeModel::packetBytes(const PacketModel& packet) const
+{
+	// one bit flags packet as non-empty
+	return packetOverhead_ + ((1 + packet.bits + 7) >> 3) + packet.len;
+}
+uint64_t PacketSizeModel::estimate(void)
+{
+	for(auto& block : blocks_)
+	{
+		auto layer = block.cblk->layers + layno_;
+		uint32_t numpasses = layer->numpasses;
+		if(numpasses == block.layerPasses)
+			continue;
+		uint32_t bits = headerBits(block, numpasses);
+		uint32_t len = numpasses ? layer->len : 0;
+		auto& packet = packets_[block.packet];
+		layerBytes_ -= packetBytes(packet);
+		packet.bits = packet.bits + bits - block.layerBits;
+		packet.len = packet.len + len - block.layerLen;
+		layerBytes_ += packetBytes(packet);
+		block.layerPasses = numpasses;
+		block.layerBits = bits;
+		block.layerLen = len;
+	}
+
+	return previousBytes_ + layerBytes_;
+}
+
+} // namespace grk
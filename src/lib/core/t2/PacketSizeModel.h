@@ -0,0 +1,159 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <type_traits>
+#include <cmath>
+
+namespace grk
+{
+struct TileProcessor;
+
+/**
+ * Incremental estimate of a tile's packet bytes, used by rate control to evaluate
+ * a layer threshold without simulating T2. Only code blocks whose pass count in the
+ * current layer changed since the last estimate are re-costed. Packet bodies,
+ * pass counts and length indicators are costed exactly; tag trees and bit stuffing
+ * are approximated, so the final threshold must still be checked by simulation.
+ */
+class PacketSizeModel
+{
+  public:
+	explicit PacketSizeModel(TileProcessor* tileProcessor);
+
+	/**
+	 * Start estimating layer layno. Layers below layno must be final.
+	 * @param layno layer to estimate
+	 * @param previousBytes exact bytes of all packets in layers below layno
+	 */
+	void beginLayer(uint16_t layno, uint64_t previousBytes);
+
+	/**
+	 * Estimate bytes of all packets up to and including the current layer,
+	 * as allocated in the code blocks' current layer
+	 */
+	uint64_t estimate(void);
+
+	/**
+	 * Bisect layer threshold against estimated bytes, then check the threshold with an
+	 * exact simulation, and repeat with the estimate corrected by the simulation's error.
+	 *
+	 * @param budget maximum bytes of all packets up to and including current layer
+	 * @param lowerBound lower threshold bound. Set to largest threshold estimated
+	 * to exceed budget
+	 * @param upperBound upper threshold bound. Set to smallest threshold found to fit budget
+	 * @param makeLayer forms current layer at threshold
+	 * @param estimate estimates bytes of all packets up to and including current layer
+	 * @param simulate simulates bytes of all packets up to and including current layer
+	 * @param allPacketBytes set to simulated bytes at upperBound
+	 * @return true if a threshold that fits budget was found. Otherwise, bounds are
+	 * narrowed to thresholds simulated so far, and the caller should fall back to
+	 * bisecting with simulation
+	 */
+	template<typename T, typename MAKE, typename ESTIMATE, typename SIMULATE>
+	static bool bisect(uint64_t budget, T& lowerBound, T& upperBound, MAKE makeLayer,
+					   ESTIMATE estimate, SIMULATE simulate, uint64_t* allPacketBytes)
+	{
+		const uint32_t maxRounds = 4;
+		auto same = [](T a, T b) {
+			if constexpr(std::is_integral_v<T>)
+				return a == b;
+			else
+				return fabs(a - b) < 0.001;
+		};
+		int64_t bias = 0;
+		T lower = lowerBound;
+		T upper = upperBound;
+		bool found = false;
+		for(uint32_t round = 0; round < maxRounds; ++round)
+		{
+			T l = lower;
+			T u = upper;
+			T prevthresh = 0;
+			for(uint32_t i = 0; i < 128; ++i)
+			{
+				T thresh = (T)((l + u) / 2);
+				if(i != 0 && same(prevthresh, thresh))
+					break;
+				prevthresh = thresh;
+				makeLayer(thresh);
+				if((int64_t)estimate() + bias > (int64_t)budget)
+					l = thresh;
+				else
+					u = thresh;
+			}
+			// upper has already been simulated
+			if(found && same(u, upper))
+				break;
+			makeLayer(u);
+			uint64_t bytes = 0;
+			if(!simulate(&bytes))
+				break;
+			bias = (int64_t)bytes - (int64_t)estimate();
+			if(bytes <= budget)
+			{
+				found = true;
+				*allPacketBytes = bytes;
+				lowerBound = l;
+				upper = u;
+			}
+			else
+			{
+				lower = u;
+			}
+		}
+		if(!found)
+			lowerBound = lower;
+		upperBound = upper;
+
+		return found;
+	}
+
+  private:
+	struct BlockModel
+	{
+		CompressCodeblock* cblk;
+		uint32_t packet;
+		uint32_t imsbBits;
+		// passes in final layers
+		uint32_t numPasses;
+		// length indicator bits after final layers
+		uint8_t lblock;
+		// cached cost of current layer
+		uint32_t layerPasses;
+		uint32_t layerBits;
+		uint32_t layerLen;
+	};
+	struct PacketModel
+	{
+		uint64_t bits;
+		uint64_t len;
+	};
+	uint32_t headerBits(const BlockModel& block, uint32_t numpasses) const;
+	uint64_t packetBytes(const PacketModel& packet) const;
+
+	std::vector<BlockModel> blocks_;
+	std::vector<PacketModel> packets_;
+	uint16_t layno_;
+	uint32_t packetOverhead_;
+	uint64_t previousBytes_;
+	uint64_t layerBytes_;
+};
+
+} // namespace grk
@@ -93,6 +93,7 @@ void T2Decompress::decompressPackets(uint16_t tile_no, SparseBuffer* src,
 		if(*stopProcessionPackets)
 			break;
 	}
+	tileProcessor->packetLengthCache.endRecording(!*stopProcessionPackets);
 }
 
 bool T2Decompress::processPacket(uint16_t compno, uint8_t resno, uint64_t precinctIndex,
@@ -106,7 +107,9 @@ bool T2Decompress::processPacket(uint16_t compno, uint8_t resno, uint64_t precin
 	auto tilec = tileProcessor->getTile()->comps + compno;
 	auto res = tilec->resolutions_ + resno;
 	auto tcp = tileProcessor->getTileCodingParams();
-	auto skip = layno >= tcp->numLayersToDecompress || resno >= tilec->numResolutionsToDecompress;
+	// retained code blocks receive all layers, and are truncated before T1
+	auto numLayers = tileProcessor->retainsLayers() ? tcp->max_layers_ : tcp->numLayersToDecompress;
+	auto skip = layno >= numLayers || resno >= tilec->numResolutionsToDecompress;
 	if(!skip && !tilec->isWholeTileDecoding())
 	{
 		skip = true;
@@ -155,6 +158,7 @@ bool T2Decompress::processPacket(uint16_t compno, uint8_t resno, uint64_t precin
 			throw;
 		}
 		packetLen = parser->numHeaderBytes() + parser->numSignalledDataBytes();
+		tileProcessor->packetLengthCache.record(packetLen);
 	}
 	try
 	{
@@ -88,6 +88,9 @@ struct ResWindow
 		uint8_t numDecomps =
 			(resno == 0) ? (uint8_t)(numresolutions - 1U) : (uint8_t)(numresolutions - resno);
 		grk_rect32 resWindowPadded;
+		bandWindowsBoundsPadded_.reserve(BAND_NUM_ORIENTATIONS);
+		bandWindowsBuffersPadded_.reserve(BAND_NUM_ORIENTATIONS);
+		bandWindowsBuffersPaddedREL_.reserve(BAND_NUM_ORIENTATIONS);
 		for(uint8_t orient = 0; orient < ((resno) > 0 ? BAND_NUM_ORIENTATIONS : 1); orient++)
 		{
 			// todo: should only need padding equal to FILTER_WIDTH, not 2*FILTER_WIDTH
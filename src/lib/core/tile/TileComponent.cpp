@@ -38,6 +38,10 @@ TileComponent::TileComponent()
 {}
 
 TileComponent::~TileComponent()
+{
+	release();
+}
+void TileComponent::release(void)
 {
 	if(resolutions_)
 	{
@@ -53,7 +57,11 @@ TileComponent::~TileComponent()
 			}
 		}
 		delete[] resolutions_;
+		resolutions_ = nullptr;
 	}
+	numresolutions = 0;
+	numResolutionsToDecompress = 0;
+	highestResolutionDecompressed = 0;
 	dealloc();
 }
 void TileComponent::dealloc(void)
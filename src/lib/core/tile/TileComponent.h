@@ -32,6 +32,10 @@ struct TileComponent : public grk_rect32
 	bool canCreateWindow(grk_rect32 unreducedTileCompOrImageCompWindow);
 	void createWindow(grk_rect32 unreducedTileCompOrImageCompWindow);
 	void dealloc(void);
+	/**
+	 * Release resolutions and windows, so that tile component can be initialized again
+	 */
+	void release(void);
 	bool init(TileProcessor* tileProcessor, grk_rect32 unreducedTileComp, uint8_t prec,
 			  TileComponentCodingParams* tccp);
 	bool subbandIntersectsAOI(uint8_t resno, eBandOrientation orient, const grk_rect32* aoi) const;
@@ -61,6 +61,8 @@ struct TileComponentWindowBase
 	{
 		assert(reducedNumResolutions > 0);
 		auto currentRes = unreducedTileComp;
+		resolution_.reserve(numresolutions);
+		resWindows.reserve(reducedNumResolutions);
 		for(uint8_t i = 0; i < numresolutions; ++i)
 		{
 			bool finalResolution = i == numresolutions - 1;
@@ -22,7 +22,8 @@
 namespace grk
 {
 TileProcessor::TileProcessor(uint16_t tileIndex, CodeStream* codeStream, BufferedStream* stream,
-							 bool isCompressor, StripCache* stripCache)
+							 bool isCompressor, StripCache* stripCache,
+							 CodeblockCache* codeblockCache)
 	: first_poc_tile_part_(true), tilePartCounter_(0), pino(0),
 	  headerImage(codeStream->getHeaderImage()),
 	  current_plugin_tile(codeStream->getCurrentPluginTile()), cp_(codeStream->getCodingParams()),
@@ -30,14 +31,77 @@ TileProcessor::TileProcessor(uint16_t tileIndex, CodeStream* codeStream, Buffere
 	  numProcessedPackets(0), numDecompressedPackets(0), tilePartDataLength(0),
 	  tileIndex_(tileIndex), stream_(stream),
 	  newTilePartProgressionPosition(cp_->coding_params_.enc_.newTilePartProgressionPosition),
-	  tcp_(cp_->tcps + tileIndex_), truncated(false), image_(nullptr), isCompressor_(isCompressor),
-	  preCalculatedTileLen(0), mct_(new mct(tile, headerImage, tcp_, stripCache))
+	  tcp_(cp_->tcps + tileIndex_), truncated(false), wholeTileDecompress_(true),
+	  layersRetained_(false), retainedTileData_(nullptr), image_(nullptr),
+	  isCompressor_(isCompressor),
+	  preCalculatedTileLen(0), mct_(new mct(tile, headerImage, tcp_, stripCache)),
+	  stripCache_(stripCache), codeblockCache_(codeblockCache)
 {}
 TileProcessor::~TileProcessor()
 {
+	releaseLayers();
 	release(GRK_TILE_CACHE_NONE);
+	delete tile;
 	delete scheduler_;
 	delete mct_;
+	for(auto w : waveletStreams_)
+		delete w;
+}
+void TileProcessor::recycle(uint16_t tileIndex)
+{
+	assert(!image_ && !scheduler_);
+	releaseLayers();
+	tileIndex_ = tileIndex;
+	tcp_ = cp_->tcps + tileIndex_;
+	restart();
+}
+void TileProcessor::restart(void)
+{
+	assert(!isCompressor_);
+	first_poc_tile_part_ = true;
+	tilePartCounter_ = 0;
+	pino = 0;
+	tilePartDataLength = 0;
+	preCalculatedTileLen = 0;
+	packetLengthCache.deleteMarkers();
+	mct_->setTileCodingParams(tcp_);
+	// retained code blocks keep the state of their T2 parse
+	if(layersRetained_)
+		return;
+	numProcessedPackets = 0;
+	numDecompressedPackets = 0;
+	truncated = false;
+	tile->release();
+}
+bool TileProcessor::retainsLayers(void)
+{
+	return layersRetained_;
+}
+void TileProcessor::releaseLayers(void)
+{
+	if(!layersRetained_)
+		return;
+	layersRetained_ = false;
+	delete retainedTileData_;
+	retainedTileData_ = nullptr;
+	tile->release();
+}
+bool TileProcessor::canReuseLayers(const GrkImage* outputImage)
+{
+	auto window = grk_rect32(outputImage->x0, outputImage->y0, outputImage->x1, outputImage->y1);
+	if(!(window == unreducedImageWindow))
+		return false;
+	auto reduce = cp_->coding_params_.dec_.reduce_;
+	for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
+	{
+		auto tilec = tile->comps + compno;
+		auto numResolutions =
+			tilec->numresolutions < reduce ? 1 : (uint8_t)(tilec->numresolutions - reduce);
+		if(tilec->numResolutionsToDecompress != numResolutions)
+			return false;
+	}
+
+	return true;
 }
 uint64_t TileProcessor::getTilePartDataLength(void)
 {
@@ -147,6 +211,10 @@ Scheduler* TileProcessor::getScheduler(void)
 {
 	return scheduler_;
 }
+CodeblockCache* TileProcessor::getCodeblockCache(void)
+{
+	return codeblockCache_;
+}
 bool TileProcessor::isCompressor(void)
 {
 	return isCompressor_;
@@ -157,6 +225,14 @@ void TileProcessor::generateImage(GrkImage* src_image, Tile* src_tile)
 		grk_object_unref(&image_->obj);
 	image_ = src_image->duplicate(src_tile);
 }
+bool TileProcessor::generateImage(GrkImage* src_image)
+{
+	if(image_)
+		grk_object_unref(&image_->obj);
+	image_ = src_image->duplicate();
+
+	return image_ != nullptr;
+}
 GrkImage* TileProcessor::getImage(void)
 {
 	return image_;
@@ -171,9 +247,12 @@ void TileProcessor::release(GRK_TILE_CACHE_STRATEGY strategy)
 		image_ = nullptr;
 	}
 
-	// delete tile components
-	delete tile;
-	tile = nullptr;
+	// release tile components; tile structure is kept for recycling,
+	// and code blocks are kept if they hold all layers
+	if(layersRetained_)
+		deallocBuffers();
+	else
+		tile->release();
 }
 PacketTracker* TileProcessor::getPacketTracker(void)
 {
@@ -218,6 +297,9 @@ bool TileProcessor::init(void)
 		Logger::logger_.error("tiles require at least one resolution");
 		return false;
 	}
+	// tile components are re-used, or re-initialized by decompressT2T1
+	if(layersRetained_)
+		return true;
 
 	for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
 	{
@@ -310,6 +392,10 @@ void TileProcessor::deallocBuffers()
 	}
 }
 bool TileProcessor::doCompress(void)
+{
+	return compressT1() && prepareTileParts();
+}
+bool TileProcessor::compressT1(void)
 {
 	uint32_t state = grk_plugin_get_debug_state();
 #ifdef PLUGIN_DEBUG_ENCODE
@@ -342,10 +428,19 @@ bool TileProcessor::doCompress(void)
 		}
 		t1_encode();
 	}
-	// 1. create PLT marker if required
+
+	return true;
+}
+void TileProcessor::createPacketLengthMarkers(void)
+{
 	packetLengthCache.deleteMarkers();
 	if(cp_->coding_params_.enc_.writePLT)
 		packetLengthCache.createMarkers(stream_);
+}
+bool TileProcessor::prepareTileParts(void)
+{
+	// 1. create PLT marker if required
+	createPacketLengthMarkers();
 	// 2. rate control
 	uint32_t allPacketBytes = 0;
 	bool rc = rateAllocate(&allPacketBytes, false);
@@ -362,7 +457,12 @@ bool TileProcessor::doCompress(void)
 		}
 	}
 	packetTracker_.clear();
+	preCalculateTileLen(allPacketBytes);
 
+	return true;
+}
+void TileProcessor::preCalculateTileLen(uint32_t allPacketBytes)
+{
 	if(canPreCalculateTileLen())
 	{
 		// SOT marker
@@ -383,7 +483,6 @@ bool TileProcessor::doCompress(void)
 		// calculate packets length
 		preCalculatedTileLen += allPacketBytes;
 	}
-	return true;
 }
 bool TileProcessor::canWritePocMarker(void)
 {
@@ -410,6 +509,10 @@ bool TileProcessor::writeTilePartT2(uint32_t* tileBytesWritten)
 	// write tile packets
 	return encodeT2(tileBytesWritten);
 }
+bool TileProcessor::isWholeTileDecompress(void)
+{
+	return wholeTileDecompress_;
+}
 /** Returns whether a tile component should be fully decompressed,
  * taking into account win_* members.
  *
@@ -432,10 +535,25 @@ bool TileProcessor::isWholeTileDecompress(uint16_t compno)
 			  ((tilec->x1 - dims.x1) >> shift) == 0 && ((tilec->y1 - dims.y1) >> shift) == 0)));
 }
 
-bool TileProcessor::decompressT2T1(GrkImage* outputImage)
+bool TileProcessor::decompressT2T1(GrkImage* outputImage, bool retainLayers)
 {
 	auto tcp = getTileCodingParams();
-	if(!tcp->compressedTileData_)
+	// retained code blocks can only be re-used for the same region and resolutions
+	bool reuseLayers = layersRetained_ && canReuseLayers(outputImage);
+	if(layersRetained_ && !reuseLayers)
+	{
+		releaseLayers();
+		if(!init())
+			return false;
+	}
+	if(reuseLayers)
+	{
+		// compressed data has been read again from the code stream, but
+		// code blocks still point into the retained copy
+		delete tcp->compressedTileData_;
+		tcp->compressedTileData_ = nullptr;
+	}
+	else if(!tcp->compressedTileData_)
 	{
 		Logger::logger_.error("Decompress: Tile %u has no compressed data", getIndex());
 		return false;
@@ -451,17 +569,21 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 
 	// T2
 	// optimization for regions that are close to largest decompressed resolution
+	wholeTileDecompress_ = true;
 	for(uint16_t compno = 0; compno < headerImage->numcomps; compno++)
 	{
 		if(!isWholeTileDecompress(compno))
 		{
+			wholeTileDecompress_ = false;
 			cp_->wholeTileDecompress_ = false;
 			break;
 		}
 	}
-	bool doT2 = !current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_T2);
+	bool doT2 = !reuseLayers &&
+				(!current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_T2));
 	if(doT2)
 	{
+		layersRetained_ = retainLayers && !current_plugin_tile;
 		auto t2 = std::make_unique<T2Decompress>(this);
 		t2->decompressPackets(tileIndex_, tcp->compressedTileData_, &truncated);
 		// synch plugin with T2 data
@@ -547,10 +669,16 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 						}
 					}
 				}
-				ExecSingleton::get()->run(taskflow).wait();
+				ExecSingleton::run(taskflow);
 				delete[] tasks;
 			}
 		}
+		// code blocks point into compressed tile data
+		if(layersRetained_)
+		{
+			retainedTileData_ = tcp->compressedTileData_;
+			tcp->compressedTileData_ = nullptr;
+		}
 	}
 	// T1
 	if(doT1)
@@ -561,6 +689,8 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 		if(doPostT1 && needsMctDecompress())
 			mctPostProc = scheduler_->getPrePostProc();
 		uint16_t mctComponentCount = 0;
+		// post processing writes single tile strips to the strip cache
+		bool stripsIngested = false;
 
 		for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
 		{
@@ -609,17 +739,33 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 							mct_->decompress_dc_shift_rev(dcPostProc, compno);
 						else
 							mct_->decompress_dc_shift_irrev(dcPostProc, compno);
+						stripsIngested = tile->numcomps_ == 1;
 					}
 				}
 			}
 		}
 		// sanity check on MCT scheduling
-		if(doPostT1 && mctComponentCount == 3 && mctPostProc && !mctDecompress(mctPostProc))
-			return false;
-		if(!scheduler_->run())
+		if(doPostT1 && mctComponentCount == 3 && mctPostProc)
+		{
+			if(!mctDecompress(mctPostProc))
+				return false;
+			stripsIngested = tcp_->mct != 2;
+		}
+		if(!scheduler_->run() || !mct_->isSuccessful())
 			return false;
 		delete scheduler_;
 		scheduler_ = nullptr;
+		if(doPostT1 && !stripsIngested && stripCache_->isInitialized() &&
+		   !stripCache_->isMultiTile())
+		{
+			auto height = tile->comps->getWindow()->getResWindowBufferHighestSimple().height_;
+			for(uint32_t y = 0; y < height; y += outputImage->rowsPerStrip)
+			{
+				auto yEnd = std::min<uint32_t>(y + outputImage->rowsPerStrip, height);
+				if(!stripCache_->ingestStrip(ExecSingleton::threadId(), tile, y, yEnd))
+					return false;
+			}
+		}
 	}
 	// 4. post T1
 	bool doPost =
@@ -788,22 +934,31 @@ bool TileProcessor::mct_encode()
 }
 bool TileProcessor::dwt_encode()
 {
-	bool rc = true;
-	for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
+	if(ExecSingleton::get()->num_workers() == 1)
 	{
-		auto tile_comp = tile->comps + compno;
-		auto tccp = tcp_->tccps + compno;
-		WaveletFwdImpl w;
-		if(!w.compress(tile_comp, tccp->qmfbid))
+		bool rc = true;
+		for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
 		{
-			rc = false;
-			continue;
+			WaveletFwdImpl w;
+			if(!w.compress(tile->comps + compno, (tcp_->tccps + compno)->qmfbid))
+				rc = false;
 		}
+		return rc;
 	}
-	return rc;
+	// all components and levels run in one graph, together with T1
+	createCompressScheduler();
+
+	return ((CompressScheduler*)scheduler_)->scheduleWavelet();
 }
 void TileProcessor::t1_encode()
 {
+	createCompressScheduler();
+	scheduler_->schedule(0);
+}
+void TileProcessor::createCompressScheduler(void)
+{
+	if(scheduler_)
+		return;
 	const double* mct_norms;
 	uint16_t mct_numcomps = 0U;
 	auto tcp = tcp_;
@@ -824,7 +979,6 @@ void TileProcessor::t1_encode()
 	}
 
 	scheduler_ = new CompressScheduler(tile, needsRateControl(), tcp, mct_norms, mct_numcomps);
-	scheduler_->schedule(0);
 }
 bool TileProcessor::encodeT2(uint32_t* tileBytesWritten)
 {
@@ -966,6 +1120,89 @@ bool TileProcessor::preCompressTile()
 
 	return true;
 }
+bool TileProcessor::preCompressTileRows(void)
+{
+	tilePartCounter_ = 0;
+	first_poc_tile_part_ = true;
+	if(!init())
+		return false;
+	createCompressScheduler();
+	tile->distortion = 0;
+	auto scheduler = (CompressScheduler*)scheduler_;
+	for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
+	{
+		auto tilec = tile->comps + compno;
+		auto stream = new WaveletFwdStream(
+			tilec, (tcp_->tccps + compno)->qmfbid,
+			[scheduler, compno](uint8_t resno, uint8_t bandIndex, uint32_t y0, int32_t* strip,
+								uint32_t stride) {
+				return scheduler->scheduleBlockRow(compno, resno, bandIndex, y0, strip, stride);
+			});
+		waveletStreams_.push_back(stream);
+		if(!stream->init())
+		{
+			Logger::logger_.error("Error allocating wavelet buffers for tile %u", tileIndex_);
+			return false;
+		}
+	}
+
+	return true;
+}
+bool TileProcessor::compressTileRows(const int32_t* const* rows, uint32_t stride, uint32_t numRows)
+{
+	bool mct = tcp_->mct == 1 && needsMctDecompress();
+	uint32_t width = tile->comps->width();
+	for(uint32_t j = 0; j < numRows; ++j)
+	{
+		int32_t* mctRows[3];
+		for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
+		{
+			auto tilec = tile->comps + compno;
+			auto tccp = tcp_->tccps + compno;
+			auto src = rows[compno] + (size_t)j * stride + (tilec->x0 - headerImage->x0);
+			auto dest = waveletStreams_[compno]->nextRow();
+			if(mct && compno < 3)
+			{
+				// dc shift is applied by the multi-component transform
+				memcpy(dest, src, width * sizeof(int32_t));
+				mctRows[compno] = dest;
+			}
+			else if(tccp->qmfbid == 1)
+			{
+				for(uint32_t i = 0; i < width; ++i)
+					dest[i] = src[i] - tccp->dc_level_shift_;
+			}
+			else
+			{
+				auto floatDest = (float*)dest;
+				for(uint32_t i = 0; i < width; ++i)
+					floatDest[i] = (float)(src[i] - tccp->dc_level_shift_);
+			}
+		}
+		if(mct)
+		{
+			if(tcp_->tccps->qmfbid == 0)
+				mct_->compress_irrev(mctRows, width);
+			else
+				mct_->compress_rev(mctRows, width);
+		}
+		for(auto w : waveletStreams_)
+		{
+			if(!w->pushRow())
+				return false;
+		}
+	}
+
+	return true;
+}
+bool TileProcessor::postCompressTileRows(void)
+{
+	for(auto w : waveletStreams_)
+		delete w;
+	waveletStreams_.clear();
+
+	return prepareTileParts();
+}
 /**
  * Assume that source stride  == source width == destination width
  */
@@ -1137,6 +1374,38 @@ bool TileProcessor::cacheTilePartPackets(CodeStreamDecompress* codeStream)
 	return true;
 }
 // RATE CONTROL ////////////////////////////////////////////
+bool TileProcessor::canModelPacketSize(void)
+{
+	// per component size limits are only enforced by simulation
+	auto enc_params = &cp_->coding_params_.enc_;
+	return enc_params->allocationByRateDistortion_ && !enc_params->allocationByFixedQuality_ &&
+		   !enc_params->max_comp_size_;
+}
+bool TileProcessor::beginModelLayer(PacketSizeModel& model, uint16_t layno,
+									bool& previousBytesKnown, uint64_t& previousBytes)
+{
+	if(!previousBytesKnown)
+	{
+		if(!simulateLayers(layno, &previousBytes))
+			return false;
+		previousBytesKnown = true;
+	}
+	model.beginLayer(layno, previousBytes);
+
+	return true;
+}
+bool TileProcessor::simulateLayers(uint16_t numLayers, uint64_t* allPacketBytes)
+{
+	auto t2 = T2Compress(this);
+	uint32_t bytes = 0;
+	if(!t2.compressPacketsSimulate(tileIndex_, numLayers, &bytes, UINT_MAX,
+								   newTilePartProgressionPosition, packetLengthCache.getMarkers(),
+								   false, false))
+		return false;
+	*allPacketBytes = bytes;
+
+	return true;
+}
 bool TileProcessor::rateAllocate(uint32_t* allPacketBytes, bool disableRateControl)
 {
 	// rate control by rate/distortion or fixed quality
@@ -1258,17 +1527,11 @@ bool TileProcessor::makeLayerFeasible(uint32_t layno, uint16_t thresh, bool fina
 /*
  Hybrid rate control using bisect algorithm with optimal truncation points
  */
-bool TileProcessor::pcrdBisectFeasible(uint32_t* allPacketBytes, bool disableRateControl)
+void TileProcessor::prepareFeasible(bool single_lossless, RateInfo& rateInfo, double& maxSE)
 {
-	bool single_lossless = tcp_->max_layers_ == 1 && !layerNeedsRateControl(0);
-	const double K = 1;
-	double maxSE = 0;
-	auto tcp = tcp_;
 	uint32_t state = grk_plugin_get_debug_state();
-	RateInfo rateInfo;
 	uint64_t numPacketsPerLayer = 0;
 	uint64_t numCodeBlocks = 0;
-	bool debug = false;
 	for(uint16_t compno = 0; compno < tile->numcomps_; compno++)
 	{
 		auto tilec = &tile->comps[compno];
@@ -1312,6 +1575,16 @@ bool TileProcessor::pcrdBisectFeasible(uint32_t* allPacketBytes, bool disableRat
 					 (double)numpix;
 		}
 	} /* compno */
+}
+bool TileProcessor::pcrdBisectFeasible(uint32_t* allPacketBytes, bool disableRateControl)
+{
+	bool single_lossless = tcp_->max_layers_ == 1 && !layerNeedsRateControl(0);
+	const double K = 1;
+	double maxSE = 0;
+	auto tcp = tcp_;
+	RateInfo rateInfo;
+	bool debug = false;
+	prepareFeasible(single_lossless, rateInfo, maxSE);
 	auto t2 = T2Compress(this);
 	if(single_lossless)
 	{
@@ -1328,6 +1601,12 @@ bool TileProcessor::pcrdBisectFeasible(uint32_t* allPacketBytes, bool disableRat
 	double cumulativeDistortion[maxCompressLayersGRK];
 	uint32_t upperBound = max_slope;
 	uint32_t maxLayerLength = UINT_MAX;
+	std::unique_ptr<PacketSizeModel> model;
+	if(canModelPacketSize())
+		model = std::make_unique<PacketSizeModel>(this);
+	// exact bytes of layers preceding current layer
+	bool previousBytesKnown = true;
+	uint64_t previousBytes = 0;
 	for(uint16_t layno = 0; layno < tcp->max_layers_; layno++)
 	{
 		uint32_t lowerBound = min_slope;
@@ -1336,13 +1615,27 @@ bool TileProcessor::pcrdBisectFeasible(uint32_t* allPacketBytes, bool disableRat
 							 : UINT_MAX;
 		if(layerNeedsRateControl(layno))
 		{
+			bool found = false;
+			if(model && maxLayerLength != UINT_MAX &&
+			   beginModelLayer(*model, layno, previousBytesKnown, previousBytes))
+			{
+				found = PacketSizeModel::bisect(
+					maxLayerLength, lowerBound, upperBound,
+					[this, layno](uint32_t thresh) {
+						makeLayerFeasible(layno, (uint16_t)thresh, false);
+					},
+					[&model]() { return model->estimate(); },
+					[this, layno](uint64_t* bytes) { return simulateLayers(layno + 1U, bytes); },
+					&previousBytes);
+			}
+			previousBytesKnown = found;
 			// thresh from previous iteration - starts off uninitialized
 			// used to bail out if difference with current thresh is small enough
 			uint32_t prevthresh = 0;
 			double distortionTarget =
 				tile->distortion - ((K * maxSE) / pow(10.0, tcp->distortion[layno] / 10.0));
 
-			for(uint32_t i = 0; i < 128; ++i)
+			for(uint32_t i = 0; i < 128 && !found; ++i)
 			{
 				uint32_t thresh = (lowerBound + upperBound) >> 1;
 				if(prevthresh != 0 && prevthresh == thresh)
@@ -1392,6 +1685,7 @@ bool TileProcessor::pcrdBisectFeasible(uint32_t* allPacketBytes, bool disableRat
 		else
 		{
 			makeLayerFinal(layno);
+			previousBytesKnown = false;
 		}
 	}
 
@@ -1404,6 +1698,43 @@ bool TileProcessor::pcrdBisectFeasible(uint32_t* allPacketBytes, bool disableRat
 	// assert(!disableRateControl || rc);
 	return rc;
 }
+uint16_t TileProcessor::prepareImageRateControl(void)
+{
+	createPacketLengthMarkers();
+	RateInfo rateInfo;
+	double maxSE = 0;
+	prepareFeasible(false, rateInfo, maxSE);
+
+	return rateInfo.getMinimumThresh();
+}
+bool TileProcessor::formLayer(uint16_t layno, uint16_t thresh, bool finalAttempt,
+							  uint64_t* allPacketBytes)
+{
+	if(layerNeedsRateControl(layno))
+		makeLayerFeasible(layno, thresh, finalAttempt);
+	else
+		makeLayerFinal(layno);
+
+	return !allPacketBytes || simulateLayers((uint16_t)(layno + 1U), allPacketBytes);
+}
+bool TileProcessor::finishImageRateControl(void)
+{
+	// final simulation will generate correct PLT lengths
+	// and correct tile length
+	uint32_t allPacketBytes = 0;
+	auto t2 = T2Compress(this);
+	if(!t2.compressPacketsSimulate(tileIndex_, tcp_->max_layers_, &allPacketBytes, UINT_MAX,
+								   newTilePartProgressionPosition,
+								   packetLengthCache.getMarkers(), true, false))
+	{
+		Logger::logger_.error("Unable to perform rate control on tile %d", tileIndex_);
+		return false;
+	}
+	packetTracker_.clear();
+	preCalculateTileLen(allPacketBytes);
+
+	return true;
+}
 /*
  Simple bisect algorithm to calculate optimal layer truncation points
  */
@@ -1494,6 +1825,12 @@ bool TileProcessor::pcrdBisectSimple(uint32_t* allPacketBytes, bool disableRateC
 	double cumulativeDistortion[maxCompressLayersGRK];
 	double upperBound = max_slope;
 	uint32_t maxLayerLength = UINT_MAX;
+	std::unique_ptr<PacketSizeModel> model;
+	if(canModelPacketSize())
+		model = std::make_unique<PacketSizeModel>(this);
+	// exact bytes of layers preceding current layer
+	bool previousBytesKnown = true;
+	uint64_t previousBytes = 0;
 	for(uint16_t layno = 0; layno < tcp_->max_layers_; layno++)
 	{
 		maxLayerLength = (!disableRateControl && tcp->rates[layno] > 0.0f)
@@ -1510,8 +1847,20 @@ bool TileProcessor::pcrdBisectSimple(uint32_t* allPacketBytes, bool disableRateC
 			double prevthresh = -1;
 			double distortionTarget =
 				tile->distortion - ((K * maxSE) / pow(10.0, tcp_->distortion[layno] / 10.0));
-			double thresh;
-			for(uint32_t i = 0; i < 128; ++i)
+			double thresh = 0;
+			bool found = false;
+			if(model && upperBound != -1 && maxLayerLength != UINT_MAX &&
+			   beginModelLayer(*model, layno, previousBytesKnown, previousBytes))
+			{
+				found = PacketSizeModel::bisect(
+					maxLayerLength, lowerBound, upperBound,
+					[this, layno](double t) { makeLayerSimple(layno, t, false); },
+					[&model]() { return model->estimate(); },
+					[this, layno](uint64_t* bytes) { return simulateLayers(layno + 1U, bytes); },
+					&previousBytes);
+			}
+			previousBytesKnown = found;
+			for(uint32_t i = 0; i < 128 && !found; ++i)
 			{
 				// thresh is half-way between lower and upper bound
 				thresh = (upperBound == -1) ? lowerBound : (lowerBound + upperBound) / 2;
@@ -1741,6 +2090,11 @@ Tile::~Tile()
 {
 	delete[] comps;
 }
+void Tile::release(void)
+{
+	for(uint16_t compno = 0; compno < numcomps_; ++compno)
+		comps[compno].release();
+}
 PacketTracker::PacketTracker() : bits(nullptr), numcomps_(0), numres_(0), numprec_(0), numlayers_(0)
 {}
 PacketTracker::~PacketTracker()
@@ -40,6 +40,7 @@ struct Tile : public grk_rect32
 	Tile();
 	explicit Tile(uint16_t numcomps);
 	virtual ~Tile();
+	void release(void);
 	uint16_t numcomps_;
 	TileComponent* comps;
 	double distortion;
@@ -73,27 +74,124 @@ struct PacketTracker
  */
 
 class mct;
+class RateInfo;
+class PacketSizeModel;
 
 struct TileProcessor
 {
 	explicit TileProcessor(uint16_t index, CodeStream* codeStream, BufferedStream* stream,
-						   bool isCompressor, StripCache* stripCache);
+						   bool isCompressor, StripCache* stripCache,
+						   CodeblockCache* codeblockCache);
 	~TileProcessor();
 	bool init(void);
 	bool createWindowBuffers(const GrkImage* outputImage);
 	void deallocBuffers();
 	bool preCompressTile(void);
+	/**
+	 * Prepare to compress the tile from rows pushed in order, top to bottom,
+	 * without buffering the whole tile
+	 */
+	bool preCompressTileRows(void);
+	/**
+	 * Compress the next rows of the tile
+	 *
+	 * @param rows one pointer per component, to the first image sample of the first row
+	 * @param stride stride of rows, in samples
+	 * @param numRows number of rows
+	 */
+	bool compressTileRows(const int32_t* const* rows, uint32_t stride, uint32_t numRows);
+	/**
+	 * Finish compressing a tile once all of its rows have been pushed
+	 */
+	bool postCompressTileRows(void);
 	bool canWritePocMarker(void);
 	bool writeTilePartT2(uint32_t* tileBytesWritten);
 	bool doCompress(void);
-	bool decompressT2T1(GrkImage* outputImage);
+	/**
+	 * Transform and block code the tile, leaving rate control and
+	 * preparation of tile parts to image-wide rate control
+	 */
+	bool compressT1(void);
+	/**
+	 * Image-wide rate control: calculate feasible truncation points of all code blocks
+	 *
+	 * @return minimum feasible slope in tile
+	 */
+	uint16_t prepareImageRateControl(void);
+	/**
+	 * Image-wide rate control: form layer from the passes whose slope exceeds thresh,
+	 * or from all remaining passes if layer has no rate target
+	 *
+	 * @param layno layer number; layers are formed in order
+	 * @param thresh slope threshold
+	 * @param finalAttempt true if layer is final
+	 * @param allPacketBytes if not null, set to bytes of all packets up to and including layno
+	 */
+	bool formLayer(uint16_t layno, uint16_t thresh, bool finalAttempt, uint64_t* allPacketBytes);
+	/**
+	 * Image-wide rate control: prepare tile parts once all layers are final
+	 */
+	bool finishImageRateControl(void);
+	/**
+	 * Check if rate control can estimate packet bytes with a PacketSizeModel
+	 */
+	bool canModelPacketSize(void);
+	/**
+	 * Simulate T2 compression of all packets in layers below numLayers
+	 *
+	 * @param numLayers number of layers
+	 * @param allPacketBytes set to bytes of simulated packets
+	 */
+	bool simulateLayers(uint16_t numLayers, uint64_t* allPacketBytes);
+	bool layerNeedsRateControl(uint32_t layno);
+	/**
+	 * Decompress tile
+	 *
+	 * @param outputImage output image
+	 * @param retainLayers if true, code blocks hold the packets of all quality layers
+	 * after decompression, so that the same region can be decompressed again
+	 * with a different number of layers without parsing the tile's packets
+	 */
+	bool decompressT2T1(GrkImage* outputImage, bool retainLayers);
 	bool ingestUncompressedData(uint8_t* p_src, uint64_t src_length);
 	bool needsRateControl();
 	void ingestImage();
 	bool cacheTilePartPackets(CodeStreamDecompress* codeStream);
 	void generateImage(GrkImage* src_image, Tile* src_tile);
+	/**
+	 * Retain copy of decompressed image
+	 *
+	 * @param src_image decompressed image
+	 *
+	 * @return true if successful
+	 */
+	bool generateImage(GrkImage* src_image);
 	GrkImage* getImage(void);
 	void release(GRK_TILE_CACHE_STRATEGY strategy);
+	/**
+	 * Prepare released decompress tile processor for another tile,
+	 * re-using its tile structure
+	 *
+	 * @param tileIndex index of new tile
+	 */
+	void recycle(uint16_t tileIndex);
+	/**
+	 * Reset tile part parsing state of decompress tile processor,
+	 * so that its tile can be parsed again from the code stream
+	 */
+	void restart(void);
+	/**
+	 * @return true if the most recent decompress of this tile took the whole tile path
+	 */
+	bool isWholeTileDecompress(void);
+	/**
+	 * @return true if code blocks hold the packets of all quality layers
+	 */
+	bool retainsLayers(void);
+	/**
+	 * Release code blocks holding the packets of all quality layers
+	 */
+	void releaseLayers(void);
 	void setCorruptPacket(void);
 	PacketTracker* getPacketTracker(void);
 	grk_rect32 getUnreducedTileWindow(void);
@@ -106,6 +204,7 @@ struct TileProcessor
 	void incrementIndex(void);
 	Tile* getTile(void);
 	Scheduler* getScheduler(void);
+	CodeblockCache* getCodeblockCache(void);
 	bool isCompressor(void);
 
 	/** Compression Only
@@ -135,6 +234,7 @@ struct TileProcessor
 
   private:
 	bool isWholeTileDecompress(uint16_t compno);
+	bool canReuseLayers(const GrkImage* outputImage);
 	bool needsMctDecompress(uint16_t compno);
 	bool needsMctDecompress(void);
 	bool mctDecompress(FlowComponent* flow);
@@ -142,13 +242,19 @@ struct TileProcessor
 	bool mct_encode();
 	bool dwt_encode();
 	void t1_encode();
+	void createCompressScheduler(void);
+	void createPacketLengthMarkers(void);
+	bool prepareTileParts(void);
+	void preCalculateTileLen(uint32_t allPacketBytes);
 	bool encodeT2(uint32_t* packet_bytes_written);
 	bool rateAllocate(uint32_t* allPacketBytes, bool disableRateControl);
-	bool layerNeedsRateControl(uint32_t layno);
 	bool makeSingleLosslessLayer();
 	void makeLayerFinal(uint32_t layno);
 	bool pcrdBisectSimple(uint32_t* p_data_written, bool disableRateControl);
 	void makeLayerSimple(uint32_t layno, double thresh, bool finalAttempt);
+	void prepareFeasible(bool single_lossless, RateInfo& rateInfo, double& maxSE);
+	bool beginModelLayer(PacketSizeModel& model, uint16_t layno, bool& previousBytesKnown,
+						 uint64_t& previousBytes);
 	bool pcrdBisectFeasible(uint32_t* p_data_written, bool disableRateControl);
 	bool makeLayerFeasible(uint32_t layno, uint16_t thresh, bool finalAttempt);
 
@@ -170,11 +276,22 @@ struct TileProcessor
 	// coding/decoding parameters for this tile
 	TileCodingParams* tcp_;
 	bool truncated;
+	// Decompressing only
+	bool wholeTileDecompress_;
+	// Decompressing only - code blocks hold the packets of all quality layers,
+	// which point into retained compressed tile data
+	bool layersRetained_;
+	SparseBuffer* retainedTileData_;
 	GrkImage* image_;
 	bool isCompressor_;
 	grk_rect32 unreducedImageWindow;
 	uint32_t preCalculatedTileLen;
 	mct* mct_;
+	StripCache* stripCache_;
+	CodeblockCache* codeblockCache_;
+	// Compressing only - forward wavelet transforms of tile components
+	// whose rows are pushed incrementally
+	std::vector<WaveletFwdStream*> waveletStreams_;
 };
 
 } // namespace grk
@@ -29,7 +29,7 @@ void grk_read(const uint8_t* buffer, TYPE* value, uint32_t numBytes);
 // buffered stream
 BufferedStream::BufferedStream(uint8_t* buffer, size_t buffer_size, bool is_input)
 	: user_data_(nullptr), free_user_data_fn_(nullptr), user_data_length_(0), read_fn_(nullptr),
-	  zero_copy_read_fn_(nullptr), write_fn_(nullptr), seek_fn_(nullptr),
+	  zero_copy_read_fn_(nullptr), write_fn_(nullptr), seek_fn_(nullptr), prefetch_fn_(nullptr),
 	  status_(is_input ? GROK_STREAM_STATUS_INPUT : GROK_STREAM_STATUS_OUTPUT), buf_(nullptr),
 	  buffered_bytes_(0), read_bytes_seekable_(0), stream_offset_(0), format_(GRK_CODEC_UNK)
 {
@@ -85,6 +85,10 @@ void BufferedStream::setSeekFunction(grk_stream_seek_fn fn)
 {
 	seek_fn_ = fn;
 }
+void BufferedStream::setPrefetchFunction(grk_stream_prefetch_fn fn)
+{
+	prefetch_fn_ = fn;
+}
 // note: passing in nullptr for buffer will execute a zero-copy read
 size_t BufferedStream::read(uint8_t* buffer, size_t p_size)
 {
@@ -474,6 +478,18 @@ bool BufferedStream::hasSeek(void)
 {
 	return seek_fn_ != nullptr;
 }
+bool BufferedStream::hasPrefetch(void)
+{
+	return prefetch_fn_ != nullptr;
+}
+void BufferedStream::prefetch(uint64_t offset, uint64_t len)
+{
+	if(!prefetch_fn_ || offset >= user_data_length_)
+		return;
+	len = std::min<uint64_t>(len, user_data_length_ - offset);
+	if(len)
+		prefetch_fn_(offset, len, user_data_);
+}
 
 bool BufferedStream::isMemStream()
 {
@@ -47,6 +47,7 @@ struct BufferedStream
 	void setZeroCopyReadFunction(grk_stream_zero_copy_read_fn fn);
 	void setWriteFunction(grk_stream_write_fn fn);
 	void setSeekFunction(grk_stream_seek_fn fn);
+	void setPrefetchFunction(grk_stream_prefetch_fn fn);
 	/**
 	 * Reads some bytes from the stream.
 	 * @param		buffer	pointer to the data buffer
@@ -111,6 +112,15 @@ struct BufferedStream
 	 * Check if stream is seekable.
 	 */
 	bool hasSeek();
+	/**
+	 * Start asynchronous read-ahead of a byte range, if supported by the stream.
+	 * The stream position is not changed.
+	 *
+	 * @param		offset		absolute offset of range
+	 * @param		len			length of range
+	 */
+	void prefetch(uint64_t offset, uint64_t len);
+	bool hasPrefetch();
 	bool supportsZeroCopy();
 	uint8_t* getZeroCopyPtr();
 
@@ -191,6 +201,10 @@ struct BufferedStream
 	 * Pointer to actual seek function (if available).
 	 */
 	grk_stream_seek_fn seek_fn_;
+	/**
+	 * Pointer to prefetch function (if available).
+	 */
+	grk_stream_prefetch_fn prefetch_fn_;
 	/**
 	 * Stream status flags
 	 */
@@ -243,7 +243,7 @@ void GrkImage::copyHeader(GrkImage* dest)
 
 	if(dest->comps)
 	{
-		all_components_data_free();
+		dest->all_components_data_free();
 		delete[] dest->comps;
 		dest->comps = nullptr;
 	}
@@ -327,8 +327,8 @@ bool GrkImage::supportsStripCache(CodingParams* cp)
 	}
 	else
 	{
-		// only mono supported
-		if(numcomps > 1)
+		// mono, or three components interleaved directly from the inverse MCT
+		if(numcomps > 1 && (numcomps != 3 || cp->tcps->mct != 1))
 			return false;
 	}
 
@@ -432,8 +432,13 @@ void GrkImage::postReadHeader(CodingParams* cp)
 					grk::PlanarToInterleaved<int32_t>::getPackedBytes(ncmp, decompressWidth, prec);
 				break;
 		}
-		rowsPerStrip = hasMultipleTiles ? ceildivpow2(cp->t_height, cp->coding_params_.dec_.reduce_)
-										: singleTileRowsPerStrip;
+		auto& dec = cp->coding_params_.dec_;
+		if(hasMultipleTiles)
+			rowsPerStrip = ceildivpow2(cp->t_height, dec.reduce_);
+		else if(dec.streamingBandHeight_)
+			rowsPerStrip = ceildivpow2(dec.streamingBandHeight_, dec.reduce_);
+		else
+			rowsPerStrip = singleTileRowsPerStrip;
 	}
 	if(rowsPerStrip > height())
 		rowsPerStrip = height();
@@ -949,6 +954,40 @@ GrkImage* GrkImage::duplicate(const Tile* src)
 	return destImage;
 }
 
+/**
+ * Create new image with copy of image data
+ *
+ * @return new GrkImage if successful, otherwise nullptr
+ *
+ */
+GrkImage* GrkImage::duplicate(void)
+{
+	auto destImage = new GrkImage();
+	copyHeader(destImage);
+	for(uint16_t compno = 0; compno < numcomps; ++compno)
+	{
+		auto srcComp = comps + compno;
+		auto destComp = destImage->comps + compno;
+		if(!srcComp->data)
+			continue;
+		if(!allocData(destComp))
+		{
+			grk_object_unref(&destImage->obj);
+			return nullptr;
+		}
+		auto src = srcComp->data;
+		auto dest = destComp->data;
+		for(uint32_t j = 0; j < srcComp->h; ++j)
+		{
+			memcpy(dest, src, srcComp->w * sizeof(int32_t));
+			src += srcComp->stride;
+			dest += destComp->stride;
+		}
+	}
+
+	return destImage;
+}
+
 void GrkImage::transferDataFrom(const Tile* tile_src_data)
 {
 	for(uint16_t compno = 0; compno < numcomps; compno++)
@@ -981,8 +1020,9 @@ bool GrkImage::compositeInterleaved(const Tile* src, uint32_t yBegin, uint32_t y
 	auto srcComp = src->comps;
 	auto destComp = comps;
 	grk_rect32 destWin;
-	grk_rect32 srcWin(srcComp->x0, srcComp->y0 + yBegin, srcComp->x0 + srcComp->width(),
-					  srcComp->y0 + yEnd);
+	// strip rows are at the highest decompressed resolution
+	auto res = srcComp->resolutions_ + srcComp->highestResolutionDecompressed;
+	grk_rect32 srcWin(res->x0, res->y0 + yBegin, res->x1, res->y0 + yEnd);
 
 	if(!generateCompositeBounds(srcWin, 0, &destWin))
 	{
@@ -1016,8 +1056,8 @@ bool GrkImage::compositeInterleaved(const Tile* src, uint32_t yBegin, uint32_t y
 	auto destx0 =
 		grk::PlanarToInterleaved<int32_t>::getPackedBytes(src->numcomps_, destWin.x0, prec);
 	auto destIndex = (uint64_t)destWin.y0 * destStride + (uint64_t)destx0;
-	auto iter = InterleaverFactory<int32_t>::makeInterleaver(
-		prec == 16 && decompressFormat != GRK_FMT_TIF ? packer16BitBE : prec);
+	auto packer = prec == 16 && decompressFormat != GRK_FMT_TIF ? packer16BitBE : prec;
+	auto iter = makeInterleaver(packer, src->numcomps_);
 	if(!iter)
 		return false;
 	int32_t const* planes[grk::maxNumPackComponents];
@@ -1080,7 +1120,7 @@ bool GrkImage::compositeInterleaved(const GrkImage* src)
 	auto destx0 =
 		grk::PlanarToInterleaved<int32_t>::getPackedBytes(src->numcomps, destWin.x0, prec);
 	auto destIndex = (uint64_t)destWin.y0 * destStride + (uint64_t)destx0;
-	auto iter = InterleaverFactory<int32_t>::makeInterleaver(prec == 16 ? packer16BitBE : prec);
+	auto iter = makeInterleaver(prec == 16 ? packer16BitBE : prec, src->numcomps);
 	if(!iter)
 		return false;
 	int32_t const* planes[grk::maxNumPackComponents];
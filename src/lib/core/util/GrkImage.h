@@ -73,6 +73,7 @@ class GrkImage : public grk_image
 	void transferDataTo(GrkImage* dest);
 	void transferDataFrom(const Tile* tile_src_data);
 	GrkImage* duplicate(const Tile* tile_src);
+	GrkImage* duplicate(void);
 	bool composite(const GrkImage* src);
 	bool compositeInterleaved(const GrkImage* src);
 	bool compositeInterleaved(const Tile* src, uint32_t yBegin, uint32_t yEnd);
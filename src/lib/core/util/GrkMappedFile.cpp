@@ -202,6 +202,18 @@ static void mem_map_free(void* user_data)
 	}
 }
 
+static void mem_map_prefetch([[maybe_unused]] uint64_t offset, [[maybe_unused]] uint64_t len,
+							 [[maybe_unused]] void* user_data)
+{
+#ifndef _WIN32
+	auto memStream = (MemStream*)user_data;
+	// madvise requires a page-aligned address
+	auto pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+	auto begin = (offset / pageSize) * pageSize;
+	madvise(memStream->buf + begin, (size_t)(offset + len - begin), MADV_WILLNEED);
+#endif
+}
+
 grk_stream* create_mapped_file_read_stream(const char* fname)
 {
 	grk_handle fd = open_fd(fname, "r");
@@ -242,6 +254,7 @@ grk_stream* create_mapped_file_read_stream(const char* fname)
 	auto stream = streamImpl->getWrapper();
 	grk_stream_set_user_data(stream, memStream, (grk_stream_free_user_data_fn)mem_map_free);
 	set_up_mem_stream(stream, memStream->len, true);
+	grk_stream_set_prefetch_function(stream, mem_map_prefetch);
 
 	return stream;
 }
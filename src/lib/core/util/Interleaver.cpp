@@ -0,0 +1,210 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "util/Interleaver.cpp"
+#include <hwy/foreach_target.h>
+#include <hwy/highway.h>
+HWY_BEFORE_NAMESPACE();
+namespace grk
+{
+namespace HWY_NAMESPACE
+{
+	using namespace hwy::HWY_NAMESPACE;
+
+	/**
+	 * Interleave one row of up to four planes into dest, truncating
+	 * each adjusted sample to T, and optionally swapping its bytes
+	 */
+	template<typename T, bool SWAP, class DI>
+	HWY_INLINE void interleave_row(DI di, int32_t* const* src, uint32_t numPlanes, T* dest,
+								   uint32_t width, int32_t adjust)
+	{
+		const Rebind<T, DI> dt;
+		const size_t N = Lanes(di);
+		const auto vadjust = Set(di, adjust);
+		const auto vmask = Set(di, (int32_t)std::numeric_limits<T>::max());
+		auto load = [&](uint32_t k, size_t j) {
+			auto v = DemoteTo(dt, And(Add(LoadU(di, src[k] + j), vadjust), vmask));
+			if constexpr(SWAP)
+				v = Or(ShiftLeft<8>(v), ShiftRight<8>(v));
+			return v;
+		};
+		size_t j = 0;
+		for(; j + N <= width; j += N, dest += N * numPlanes)
+		{
+			switch(numPlanes)
+			{
+				case 1:
+					StoreU(load(0, j), dt, dest);
+					break;
+				case 2:
+					StoreInterleaved2(load(0, j), load(1, j), dt, dest);
+					break;
+				case 3:
+					StoreInterleaved3(load(0, j), load(1, j), load(2, j), dt, dest);
+					break;
+				default:
+					StoreInterleaved4(load(0, j), load(1, j), load(2, j), load(3, j), dt, dest);
+					break;
+			}
+		}
+		for(; j < width; ++j)
+		{
+			for(uint32_t k = 0; k < numPlanes; ++k)
+			{
+				auto val = (T)(src[k][j] + adjust);
+				if constexpr(SWAP)
+					val = (T)((val << 8) | (val >> 8));
+				memcpy(dest++, &val, sizeof(T));
+			}
+		}
+	}
+
+	/**
+	 * Pack len samples of B bits, most significant bit first. Each 128 bit block
+	 * packs eight samples into B bytes, which are stored with an overlapping 16 byte store
+	 */
+	template<uint32_t B>
+	HWY_INLINE void pack_bits(const uint16_t* src, uint64_t len, uint8_t* dest)
+	{
+		static_assert(B == 10 || B == 12);
+		uint64_t i = 0;
+#if HWY_TARGET != HWY_SCALAR
+		const Full128<uint16_t> d16;
+		const Full128<uint64_t> d64;
+		const Full128<uint8_t> d8;
+		// lane bytes in big endian order
+		HWY_ALIGN static constexpr uint8_t kBytes10[16] = {4,  3,  2,  1, 0, 12, 11, 10,
+														   9,  8,  0,  0, 0, 0,  0,  0};
+		HWY_ALIGN static constexpr uint8_t kBytes12[16] = {5,  4,  3,  2,  1, 0, 13, 12,
+														   11, 10, 9,  8,  0, 0, 0,  0};
+		const auto bytes = Load(d8, B == 10 ? kBytes10 : kBytes12);
+		const auto mask = Set(d64, ((uint64_t)1 << B) - 1);
+		// at least eight more samples must follow, so that the store stays within the row
+		for(; i + 16 <= len; i += 8, dest += B)
+		{
+			auto x = BitCast(d64, LoadU(d16, src + i));
+			auto w = ShiftLeft<3 * B>(And(x, mask));
+			w = Or(w, ShiftLeft<2 * B>(And(ShiftRight<16>(x), mask)));
+			w = Or(w, ShiftLeft<B>(And(ShiftRight<32>(x), mask)));
+			w = Or(w, And(ShiftRight<48>(x), mask));
+			StoreU(TableLookupBytes(BitCast(d8, w), bytes), d8, dest);
+		}
+#endif
+		uint32_t acc = 0;
+		uint32_t numBits = 0;
+		for(; i < len; ++i)
+		{
+			acc = (acc << B) | (src[i] & ((1U << B) - 1));
+			numBits += B;
+			while(numBits >= 8)
+			{
+				numBits -= 8;
+				*dest++ = (uint8_t)(acc >> numBits);
+			}
+			acc &= (1U << numBits) - 1;
+		}
+		if(numBits)
+			*dest = (uint8_t)(acc << (8 - numBits));
+	}
+
+	static void hwy_interleave(int32_t** src, uint32_t numPlanes, uint8_t* dest, uint32_t width,
+							   uint32_t srcStride, uint64_t destStride, uint32_t h, int32_t adjust,
+							   uint8_t packer)
+	{
+		const HWY_FULL(int32_t) di;
+		std::vector<uint16_t> samples;
+		if(packer == 10 || packer == 12)
+			samples.resize((size_t)width * numPlanes);
+		for(uint32_t i = 0; i < h; ++i)
+		{
+			switch(packer)
+			{
+				case 8:
+					interleave_row<uint8_t, false>(di, src, numPlanes, dest, width, adjust);
+					break;
+				case 10:
+					interleave_row<uint16_t, false>(di, src, numPlanes, samples.data(), width,
+													adjust);
+					pack_bits<10>(samples.data(), samples.size(), dest);
+					break;
+				case 12:
+					interleave_row<uint16_t, false>(di, src, numPlanes, samples.data(), width,
+													adjust);
+					pack_bits<12>(samples.data(), samples.size(), dest);
+					break;
+				case 16:
+					interleave_row<uint16_t, false>(di, src, numPlanes, (uint16_t*)dest, width,
+													adjust);
+					break;
+				default:
+					interleave_row<uint16_t, true>(di, src, numPlanes, (uint16_t*)dest, width,
+												   adjust);
+					break;
+			}
+			dest += destStride;
+			for(uint32_t k = 0; k < numPlanes; ++k)
+				src[k] += srcStride;
+		}
+	}
+} // namespace HWY_NAMESPACE
+} // namespace grk
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace grk
+{
+HWY_EXPORT(hwy_interleave);
+
+InterleaverHwy::InterleaverHwy(uint8_t packer) : packer_(packer) {}
+void InterleaverHwy::interleave(int32_t** src, const uint32_t numPlanes, uint8_t* dest,
+								const uint32_t srcWidth, const uint32_t srcStride,
+								const uint64_t destStride, const uint32_t h, const int32_t adjust)
+{
+	assert(isSupported(packer_, (uint16_t)numPlanes));
+	HWY_DYNAMIC_DISPATCH(hwy_interleave)
+	(src, numPlanes, dest, srcWidth, srcStride, destStride, h, adjust, packer_);
+}
+bool InterleaverHwy::isSupported(uint8_t packer, uint16_t numPlanes)
+{
+	if(numPlanes == 0 || numPlanes > 4)
+		return false;
+	switch(packer)
+	{
+		case 8:
+		case 10:
+		case 12:
+		case 16:
+		case packer16BitBE:
+			return true;
+		default:
+			return false;
+	}
+}
+PlanarToInterleaved<int32_t>* makeInterleaver(uint8_t packer, uint16_t numPlanes)
+{
+	if(InterleaverHwy::isSupported(packer, numPlanes))
+		return new InterleaverHwy(packer);
+
+	return InterleaverFactory<int32_t>::makeInterleaver(packer);
+}
+
+} // namespace grk
+#endif
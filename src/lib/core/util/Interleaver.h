@@ -0,0 +1,47 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace grk
+{
+/**
+ * Vectorized interleaver for 8, 10, 12 and 16 bit (little or big endian) packing
+ * of up to four planes. Output is identical to the scalar packers in packer.h
+ */
+class InterleaverHwy : public PlanarToInterleaved<int32_t>
+{
+  public:
+	explicit InterleaverHwy(uint8_t packer);
+	void interleave(int32_t** src, const uint32_t numPlanes, uint8_t* dest,
+					const uint32_t srcWidth, const uint32_t srcStride, const uint64_t destStride,
+					const uint32_t h, const int32_t adjust) override;
+	static bool isSupported(uint8_t packer, uint16_t numPlanes);
+
+  private:
+	uint8_t packer_;
+};
+
+/**
+ * Create interleaver for packer, falling back to the scalar packers
+ * when there is no vectorized one for packer and numPlanes
+ */
+PlanarToInterleaved<int32_t>* makeInterleaver(uint8_t packer, uint16_t numPlanes);
+
+} // namespace grk
@@ -0,0 +1,220 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ */
+
+#include "grk_includes.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "wavelet/WaveletCommon.cpp"
+#include <hwy/foreach_target.h>
+#include <hwy/highway.h>
+HWY_BEFORE_NAMESPACE();
+namespace grk
+{
+namespace HWY_NAMESPACE
+{
+	using namespace hwy::HWY_NAMESPACE;
+
+	template<class D>
+	HWY_INLINE void step1_97(D d, float* data, uint32_t len, uint32_t width, float c)
+	{
+		const auto vc = Set(d, c);
+		const size_t N = Lanes(d);
+		for(uint32_t i = 0; i < len; ++i, data += 2 * width)
+		{
+			for(size_t k = 0; k < width; k += N)
+				StoreU(Mul(LoadU(d, data + k), vc), d, data + k);
+		}
+	}
+	template<class D>
+	HWY_INLINE void step2_97(D d, const float* dataPrev, float* data, uint32_t len,
+							 uint32_t lenMax, uint32_t width, float c)
+	{
+		auto vc = Set(d, c);
+		const size_t N = Lanes(d);
+		uint32_t imax = (std::min<uint32_t>)(len, lenMax);
+		for(uint32_t i = 0; i < imax; ++i)
+		{
+			auto dest = data - width;
+			for(size_t k = 0; k < width; k += N)
+			{
+				auto sum = Add(LoadU(d, dataPrev + k), LoadU(d, data + k));
+				StoreU(MulAdd(sum, vc, LoadU(d, dest + k)), d, dest + k);
+			}
+			dataPrev = data;
+			data += 2 * width;
+		}
+		if(lenMax < len)
+		{
+			assert(lenMax + 1 == len);
+			vc = Add(vc, vc);
+			auto dest = data - width;
+			for(size_t k = 0; k < width; k += N)
+				StoreU(MulAdd(LoadU(d, dataPrev + k), vc, LoadU(d, dest + k)), d, dest + k);
+		}
+	}
+
+	/**
+	 * Apply op to the vectors of a row, and then to the partial vector at its end
+	 * through zero-padded copies, so that every sample takes the same code path
+	 */
+	template<class D, typename T, class OP>
+	HWY_INLINE void lift_row(D d, T* dest, const T* a, const T* b, uint32_t len, OP op)
+	{
+		const size_t N = Lanes(d);
+		size_t k = 0;
+		for(; k + N <= len; k += N)
+			StoreU(op(LoadU(d, dest + k), LoadU(d, a + k), LoadU(d, b + k)), d, dest + k);
+		if(k == len)
+			return;
+		constexpr size_t kMaxLanes = HWY_MAX_BYTES / sizeof(T);
+		HWY_ALIGN T tailDest[kMaxLanes] = {0};
+		HWY_ALIGN T tailA[kMaxLanes] = {0};
+		HWY_ALIGN T tailB[kMaxLanes] = {0};
+		size_t rem = len - k;
+		memcpy(tailDest, dest + k, rem * sizeof(T));
+		memcpy(tailA, a + k, rem * sizeof(T));
+		memcpy(tailB, b + k, rem * sizeof(T));
+		Store(op(Load(d, tailDest), Load(d, tailA), Load(d, tailB)), d, tailDest);
+		memcpy(dest + k, tailDest, rem * sizeof(T));
+	}
+	static void hwy_dwt97_scale_row(float* dest, uint32_t len, float c)
+	{
+		const HWY_FULL(float) d;
+		const auto vc = Set(d, c);
+		lift_row(d, dest, dest, dest, len, [vc](auto x, auto, auto) { return Mul(x, vc); });
+	}
+	static void hwy_dwt97_lift_row(float* dest, const float* a, const float* b, uint32_t len,
+								   float c)
+	{
+		const HWY_FULL(float) d;
+		const auto vc = Set(d, c);
+		lift_row(d, dest, a, b, len,
+				 [vc](auto x, auto va, auto vb) { return MulAdd(Add(va, vb), vc, x); });
+	}
+	static void hwy_dwt53_lift_row_l(int32_t* dest, const int32_t* a, const int32_t* b,
+									 uint32_t len)
+	{
+		const HWY_FULL(int32_t) d;
+		const auto two = Set(d, 2);
+		lift_row(d, dest, a, b, len, [two](auto x, auto va, auto vb) {
+			return Sub(x, ShiftRight<2>(Add(Add(va, vb), two)));
+		});
+	}
+	static void hwy_dwt53_lift_row_h(int32_t* dest, const int32_t* a, const int32_t* b,
+									 uint32_t len)
+	{
+		const HWY_FULL(int32_t) d;
+		lift_row(d, dest, a, b, len,
+				 [](auto x, auto va, auto vb) { return Add(x, ShiftRight<1>(Add(va, vb))); });
+	}
+	static void hwy_dwt53_fwd_lift_row_h(int32_t* dest, const int32_t* a, const int32_t* b,
+										 uint32_t len)
+	{
+		const HWY_FULL(int32_t) d;
+		lift_row(d, dest, a, b, len,
+				 [](auto x, auto va, auto vb) { return Sub(x, ShiftRight<1>(Add(va, vb))); });
+	}
+	static void hwy_dwt53_fwd_lift_row_l(int32_t* dest, const int32_t* a, const int32_t* b,
+										 uint32_t len)
+	{
+		const HWY_FULL(int32_t) d;
+		const auto two = Set(d, 2);
+		lift_row(d, dest, a, b, len, [two](auto x, auto va, auto vb) {
+			return Add(x, ShiftRight<2>(Add(Add(va, vb), two)));
+		});
+	}
+
+	// use the widest vector that evenly divides the element width
+	// (element width is always a multiple of 4)
+	static void hwy_dwt97_step1(float* data, uint32_t len, uint32_t width, float c)
+	{
+		const HWY_FULL(float) df;
+		const HWY_CAPPED(float, 8) d8;
+		const HWY_CAPPED(float, 4) d4;
+		if(width % Lanes(df) == 0)
+			step1_97(df, data, len, width, c);
+		else if(width % Lanes(d8) == 0)
+			step1_97(d8, data, len, width, c);
+		else
+			step1_97(d4, data, len, width, c);
+	}
+	static void hwy_dwt97_step2(const float* dataPrev, float* data, uint32_t len, uint32_t lenMax,
+								uint32_t width, float c)
+	{
+		const HWY_FULL(float) df;
+		const HWY_CAPPED(float, 8) d8;
+		const HWY_CAPPED(float, 4) d4;
+		if(width % Lanes(df) == 0)
+			step2_97(df, dataPrev, data, len, lenMax, width, c);
+		else if(width % Lanes(d8) == 0)
+			step2_97(d8, dataPrev, data, len, lenMax, width, c);
+		else
+			step2_97(d4, dataPrev, data, len, lenMax, width, c);
+	}
+} // namespace HWY_NAMESPACE
+} // namespace grk
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace grk
+{
+HWY_EXPORT(hwy_dwt97_step1);
+HWY_EXPORT(hwy_dwt97_step2);
+HWY_EXPORT(hwy_dwt97_scale_row);
+HWY_EXPORT(hwy_dwt97_lift_row);
+HWY_EXPORT(hwy_dwt53_lift_row_l);
+HWY_EXPORT(hwy_dwt53_lift_row_h);
+HWY_EXPORT(hwy_dwt53_fwd_lift_row_h);
+HWY_EXPORT(hwy_dwt53_fwd_lift_row_l);
+
+void dwt97_step1(float* data, uint32_t len, uint32_t width, float c)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt97_step1)(data, len, width, c);
+}
+void dwt97_step2(const float* dataPrev, float* data, uint32_t len, uint32_t lenMax,
+				 uint32_t width, float c)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt97_step2)(dataPrev, data, len, lenMax, width, c);
+}
+void dwt97_scale_row(float* dest, uint32_t len, float c)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt97_scale_row)(dest, len, c);
+}
+void dwt97_lift_row(float* dest, const float* a, const float* b, uint32_t len, float c)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt97_lift_row)(dest, a, b, len, c);
+}
+void dwt53_lift_row_l(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt53_lift_row_l)(dest, a, b, len);
+}
+void dwt53_lift_row_h(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt53_lift_row_h)(dest, a, b, len);
+}
+void dwt53_fwd_lift_row_h(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt53_fwd_lift_row_h)(dest, a, b, len);
+}
+void dwt53_fwd_lift_row_l(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_dwt53_fwd_lift_row_l)(dest, a, b, len);
+}
+
+} // namespace grk
+#endif
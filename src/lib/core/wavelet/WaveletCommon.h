@@ -65,4 +65,32 @@ struct vec
 	T val[N];
 };
 
+/**
+ * 9/7 lifting steps on a line of interleaved low and high pass elements,
+ * where each element holds width floats (one per row or column processed in parallel).
+ * width must be a multiple of 4.
+ *
+ * step 1 scales len elements spaced two apart, starting at data, by c.
+ * step 2 updates the elements preceding data with c times the sum of their neighbours
+ */
+void dwt97_step1(float* data, uint32_t len, uint32_t width, float c);
+void dwt97_step2(const float* dataPrev, float* data, uint32_t len, uint32_t lenMax,
+				 uint32_t width, float c);
+
+/**
+ * Lifting on whole rows, for the line-based vertical pass. Each function updates
+ * len samples of dest in place, using the neighbouring rows a and b:
+ *
+ * dwt97_scale_row multiplies dest by c, dwt97_lift_row adds c * (a + b),
+ * dwt53_lift_row_l subtracts (a + b + 2) >> 2 and dwt53_lift_row_h adds (a + b) >> 1.
+ * The forward 5/3 steps dwt53_fwd_lift_row_h subtracts (a + b) >> 1
+ * and dwt53_fwd_lift_row_l adds (a + b + 2) >> 2
+ */
+void dwt97_scale_row(float* dest, uint32_t len, float c);
+void dwt97_lift_row(float* dest, const float* a, const float* b, uint32_t len, float c);
+void dwt53_lift_row_l(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len);
+void dwt53_lift_row_h(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len);
+void dwt53_fwd_lift_row_h(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len);
+void dwt53_fwd_lift_row_l(int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len);
+
 } // namespace grk
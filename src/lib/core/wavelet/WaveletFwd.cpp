@@ -24,16 +24,8 @@
 #include <sstream>
 namespace grk
 {
-template<typename T>
-struct dwt_line
-{
-	T* mem;
-	uint32_t dn; /* number of elements in high pass band */
-	uint32_t sn; /* number of elements in low pass band */
-	uint32_t parity; /* 0 = start on even coord, 1 = start on odd coord */
-};
-
 const uint32_t NB_ELTS_V8 = 8;
+const uint32_t NB_ELTS_V16 = 16;
 
 /* From table F.4 from the standard */
 static const float alpha = -1.586134342f;
@@ -165,69 +157,17 @@ void dwt97::encode_1_real(float* w, int32_t dn, int32_t sn, int32_t parity)
 	else
 		encode_step1_combined(w, (uint32_t)dn, (uint32_t)sn, grk_K, grk_invK);
 }
-template<typename T, typename DWT>
-struct encode_h_job
-{
-	dwt_line<T> h;
-	uint32_t rw; /* Width of the resolution to process */
-	uint32_t w; /* Width of tiledp */
-	T* GRK_RESTRICT tiledp;
-	uint32_t min_j;
-	uint32_t max_j;
-	DWT dwt;
-};
-
-template<typename T, typename DWT>
-void encode_h_func(encode_h_job<T, DWT>* job)
-{
-	uint32_t j;
-	for(j = job->min_j; j < job->max_j; j++)
-	{
-		T* GRK_RESTRICT aj = (T*)job->tiledp + j * job->w;
-		job->dwt.encode_and_deinterleave_h_one_row((T*)aj, (T*)job->h.mem, job->rw,
-												   job->h.parity == 0 ? true : false);
-	}
-	grk_aligned_free(job->h.mem);
-	delete job;
-}
-
-template<typename T, typename DWT>
-struct encode_v_job
-{
-	dwt_line<T> v;
-	uint32_t rh;
-	uint32_t w;
-	T* GRK_RESTRICT tiledp;
-	uint32_t min_j;
-	uint32_t max_j;
-	DWT dwt;
-};
-
-template<typename T, typename DWT>
-void encode_v_func(encode_v_job<T, DWT>* job)
-{
-	uint32_t j;
-	for(j = job->min_j; j + NB_ELTS_V8 - 1 < job->max_j; j += NB_ELTS_V8)
-		job->dwt.encode_and_deinterleave_v((T*)job->tiledp + j, (T*)job->v.mem, job->rh,
-										   job->v.parity == 0, job->w, NB_ELTS_V8);
-	if(j < job->max_j)
-		job->dwt.encode_and_deinterleave_v((T*)job->tiledp + j, (T*)job->v.mem, job->rh,
-										   job->v.parity == 0, job->w, job->max_j - j);
-	grk_aligned_free(job->v.mem);
-	delete job;
-}
-
-/** Fetch up to cols <= NB_ELTS_V8 for each line, and put them in tmpOut */
-/* that has a NB_ELTS_V8 interleave factor. */
-template<typename T>
+/** Fetch up to cols <= NB_ELTS for each line, and put them in tmpOut */
+/* that has a NB_ELTS interleave factor. */
+template<typename T, uint32_t NB_ELTS>
 void fetch_cols_vertical_pass(const T* array, T* tmp, uint32_t height, uint32_t stride_width,
 							  uint32_t cols)
 {
-	if(cols == NB_ELTS_V8)
+	if(cols == NB_ELTS)
 	{
 		uint32_t k;
 		for(k = 0; k < height; ++k)
-			memcpy(tmp + NB_ELTS_V8 * k, array + k * stride_width, NB_ELTS_V8 * sizeof(T));
+			memcpy(tmp + NB_ELTS * k, array + k * stride_width, NB_ELTS * sizeof(T));
 	}
 	else
 	{
@@ -236,144 +176,46 @@ void fetch_cols_vertical_pass(const T* array, T* tmp, uint32_t height, uint32_t
 		{
 			uint32_t c;
 			for(c = 0; c < cols; c++)
-				tmp[NB_ELTS_V8 * k + c] = array[c + k * stride_width];
-			for(; c < NB_ELTS_V8; c++)
-				tmp[NB_ELTS_V8 * k + c] = 0;
+				tmp[NB_ELTS * k + c] = array[c + k * stride_width];
+			for(; c < NB_ELTS; c++)
+				tmp[NB_ELTS * k + c] = 0;
 		}
 	}
 }
 
-/* Deinterleave result of forward transform, where cols <= NB_ELTS_V8 */
-/* and src contains NB_ELTS_V8 consecutive values for up to NB_ELTS_V8 */
+/* Deinterleave result of forward transform, where cols <= NB_ELTS */
+/* and src contains NB_ELTS consecutive values for up to NB_ELTS */
 /* columns. */
-template<typename T>
+template<typename T, uint32_t NB_ELTS>
 void deinterleave_v_cols(const T* GRK_RESTRICT src, T* GRK_RESTRICT dst, uint32_t dn, uint32_t sn,
 						 uint32_t stride_width, uint32_t parity, uint32_t cols)
 {
 	int64_t i = sn;
 	T* GRK_RESTRICT destPtr = dst;
-	const T* GRK_RESTRICT srcPtr = src + parity * NB_ELTS_V8;
-	uint32_t c;
+	const T* GRK_RESTRICT srcPtr = src + parity * NB_ELTS;
 
 	for(uint32_t k = 0; k < 2; k++)
 	{
 		while(i--)
 		{
-			if(cols == NB_ELTS_V8)
-			{
-				memcpy(destPtr, srcPtr, NB_ELTS_V8 * sizeof(T));
-			}
+			if(cols == NB_ELTS)
+				memcpy(destPtr, srcPtr, NB_ELTS * sizeof(T));
 			else
-			{
-				c = 0;
-				switch(cols)
-				{
-					case 7:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 6:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 5:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 4:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 3:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 2:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					default:
-						destPtr[c] = srcPtr[c];
-						break;
-				}
-			}
+				memcpy(destPtr, srcPtr, cols * sizeof(T));
 			destPtr += stride_width;
-			srcPtr += 2 * NB_ELTS_V8;
+			srcPtr += 2 * NB_ELTS;
 		}
 
 		destPtr = dst + (size_t)sn * (size_t)stride_width;
-		srcPtr = src + (1 - parity) * NB_ELTS_V8;
+		srcPtr = src + (1 - parity) * NB_ELTS;
 		i = dn;
 	}
 }
-void dwt97::grk_v8dwt_encode_step1(float* fw, uint32_t end, const float cst)
+WaveletFwdImpl::WaveletFwdImpl(void) : flow_(nullptr) {}
+WaveletFwdImpl::~WaveletFwdImpl()
 {
-	uint32_t i;
-#ifdef __SSE__
-	__m128* vw = (__m128*)fw;
-	const __m128 vcst = _mm_set1_ps(cst);
-	for(i = 0; i < end; ++i)
-	{
-		vw[0] = _mm_mul_ps(vw[0], vcst);
-		vw[1] = _mm_mul_ps(vw[1], vcst);
-		vw += 2 * (NB_ELTS_V8 * sizeof(float) / sizeof(__m128));
-	}
-#else
-	uint32_t c;
-	for(i = 0; i < end; ++i)
-	{
-		for(c = 0; c < NB_ELTS_V8; c++)
-			fw[i * 2 * NB_ELTS_V8 + c] *= cst;
-	}
-#endif
-}
-
-void dwt97::grk_v8dwt_encode_step2(float* fl, float* fw, uint32_t end, uint32_t m, float cst)
-{
-	uint32_t i;
-	uint32_t imax = std::min<uint32_t>(end, m);
-#ifdef __SSE__
-	__m128* vw = (__m128*)fw;
-	__m128 vcst = _mm_set1_ps(cst);
-	if(imax > 0)
-	{
-		__m128* vl = (__m128*)fl;
-		vw[-2] = _mm_add_ps(vw[-2], _mm_mul_ps(_mm_add_ps(vl[0], vw[0]), vcst));
-		vw[-1] = _mm_add_ps(vw[-1], _mm_mul_ps(_mm_add_ps(vl[1], vw[1]), vcst));
-		vw += 2 * (NB_ELTS_V8 * sizeof(float) / sizeof(__m128));
-		i = 1;
-
-		for(; i < imax; ++i)
-		{
-			vw[-2] = _mm_add_ps(vw[-2], _mm_mul_ps(_mm_add_ps(vw[-4], vw[0]), vcst));
-			vw[-1] = _mm_add_ps(vw[-1], _mm_mul_ps(_mm_add_ps(vw[-3], vw[1]), vcst));
-			vw += 2 * (NB_ELTS_V8 * sizeof(float) / sizeof(__m128));
-		}
-	}
-	if(m < end)
-	{
-		assert(m + 1 == end);
-		vcst = _mm_add_ps(vcst, vcst);
-		vw[-2] = _mm_add_ps(vw[-2], _mm_mul_ps(vw[-4], vcst));
-		vw[-1] = _mm_add_ps(vw[-1], _mm_mul_ps(vw[-3], vcst));
-	}
-#else
-	uint32_t c;
-	const int64_t NB_ELTS = (int64_t)NB_ELTS_V8;
-	if(imax > 0)
-	{
-		for(c = 0; c < NB_ELTS; c++)
-			fw[-1 * NB_ELTS + c] += (fl[0 * NB_ELTS + c] + fw[0 * NB_ELTS + c]) * cst;
-		fw += 2 * NB_ELTS;
-		i = 1;
-		for(; i < imax; ++i)
-		{
-			for(c = 0; c < NB_ELTS; c++)
-				fw[-1 * NB_ELTS + c] += (fw[-2 * NB_ELTS + c] + fw[0 * NB_ELTS + c]) * cst;
-			fw += 2 * NB_ELTS;
-		}
-	}
-	if(m < end)
-	{
-		assert(m + 1 == end);
-		for(c = 0; c < NB_ELTS; c++)
-			fw[-1 * NB_ELTS + c] += (2 * fw[-2 * NB_ELTS + c]) * cst;
-	}
-#endif
+	for(auto s : scratch_)
+		grk_aligned_free(s);
 }
 /* <summary>                            */
 /* Forward 5-3 wavelet transform in 2-D. */
@@ -384,7 +226,6 @@ bool WaveletFwdImpl::encode_procedure(TileComponent* tilec)
 	if(tilec->numresolutions == 1U)
 		return true;
 
-	// const int num_threads = grk_thread_pool_get_thread_count(tp);
 	uint32_t stride = tilec->getWindow()->getResWindowBufferHighestSimple().stride_;
 	T* GRK_RESTRICT tiledp = (T*)tilec->getWindow()->getResWindowBufferHighestSimple().buf_;
 
@@ -392,187 +233,93 @@ bool WaveletFwdImpl::encode_procedure(TileComponent* tilec)
 	auto currentRes = tilec->resolutions_ + maxNumResolutions;
 	auto lastRes = currentRes - 1;
 
+	const uint32_t vertPassWidth = DWT::vertPassWidth;
 	size_t dataSize = max_resolution(tilec->resolutions_, tilec->numresolutions);
 	/* overflow check */
-	if(dataSize > (SIZE_MAX / (NB_ELTS_V8 * sizeof(int32_t))))
+	if(dataSize > (SIZE_MAX / (vertPassWidth * sizeof(int32_t))))
 	{
 		Logger::logger_.error("Forward wavelet overflow");
 		return false;
 	}
-	dataSize *= NB_ELTS_V8 * sizeof(int32_t);
-	auto bj = (T*)grk_aligned_malloc(dataSize);
-	/* dataSize is equal to 0 when numresolutions == 1 but bj is not used */
-	/* in that case, so do not error out */
-	if(dataSize != 0 && !bj)
-		return false;
-	int32_t i = maxNumResolutions;
-	uint32_t num_threads = ExecSingleton::get()->num_workers() > 1 ? 2 : 1;
-	DWT dwt;
-	while(i--)
+	dataSize *= vertPassWidth * sizeof(int32_t);
+	uint32_t numThreads = flow_ ? (uint32_t)ExecSingleton::get()->num_workers() : 1;
+	scratch_.resize(numThreads, nullptr);
+	for(auto& s : scratch_)
+	{
+		s = grk_aligned_malloc(dataSize);
+		if(!s)
+		{
+			Logger::logger_.error("Out of memory");
+			return false;
+		}
+	}
+	for(uint8_t resno = maxNumResolutions; resno > 0; --resno)
 	{
 		// width of the resolution level computed
 		uint32_t rw = (uint32_t)(currentRes->x1 - currentRes->x0);
 		// height of the resolution level computed
 		uint32_t rh = (uint32_t)(currentRes->y1 - currentRes->y0);
-		// width of the resolution level once lower than computed one
-		uint32_t rw1 = (uint32_t)(lastRes->x1 - lastRes->x0);
-		// height of the resolution level once lower than computed one
-		uint32_t rh1 = (uint32_t)(lastRes->y1 - lastRes->y0);
 
 		/* 0 = non inversion on horizontal filtering 1 = inversion between low-pass and high-pass
 		 * filtering */
-		uint32_t parity_row = currentRes->x0 & 1;
+		bool evenRow = (currentRes->x0 & 1) == 0;
 		/* 0 = non inversion on vertical filtering 1 = inversion between low-pass and high-pass
 		 * filtering   */
-		uint32_t parity_col = currentRes->y0 & 1;
-
-		uint32_t sn = rh1;
-		uint32_t dn = (uint32_t)(rh - rh1);
-
-		bool rc = true;
+		bool evenCol = (currentRes->y0 & 1) == 0;
 
-		/* Perform vertical pass */
-		if(num_threads <= 1 || rw < 2 * NB_ELTS_V8)
-		{
+		auto vert = [this, tiledp, stride, rh, evenCol](uint32_t colMin, uint32_t colMax) {
+			DWT dwt;
+			auto bj = (T*)scratch_[ExecSingleton::threadId()];
 			uint32_t j;
-			for(j = 0; j + NB_ELTS_V8 - 1 < rw; j += NB_ELTS_V8)
-				dwt.encode_and_deinterleave_v((T*)tiledp + j, bj, rh, parity_col == 0, stride,
-											  NB_ELTS_V8);
-			if(j < rw)
-				dwt.encode_and_deinterleave_v((T*)tiledp + j, bj, rh, parity_col == 0, stride,
-											  rw - j);
-		}
-		else
+			for(j = colMin; j + vertPassWidth - 1 < colMax; j += vertPassWidth)
+				dwt.encode_and_deinterleave_v(tiledp + j, bj, rh, evenCol, stride, vertPassWidth);
+			if(j < colMax)
+				dwt.encode_and_deinterleave_v(tiledp + j, bj, rh, evenCol, stride, colMax - j);
+		};
+		auto horiz = [this, tiledp, stride, rw, evenRow](uint32_t rowMin, uint32_t rowMax) {
+			DWT dwt;
+			auto bj = (T*)scratch_[ExecSingleton::threadId()];
+			for(uint32_t j = rowMin; j < rowMax; j++)
+				dwt.encode_and_deinterleave_h_one_row(tiledp + (size_t)j * stride, bj, rw, evenRow);
+		};
+		currentRes = lastRes;
+		--lastRes;
+		if(numThreads == 1)
 		{
-			uint32_t num_jobs = (uint32_t)num_threads;
-			uint32_t step_j;
-
-			if(rw < num_jobs)
-				num_jobs = rw;
-			step_j = ((rw / num_jobs) / NB_ELTS_V8) * NB_ELTS_V8;
-			tf::Taskflow taskflow;
-			tf::Task* node = nullptr;
-			if(num_jobs > 1)
-			{
-				node = new tf::Task[num_jobs];
-				for(uint64_t j = 0; j < num_jobs; j++)
-					node[j] = taskflow.placeholder();
-			}
-			for(uint32_t j = 0; j < num_jobs; j++)
-			{
-				auto job = new encode_v_job<T, DWT>();
-				job->v.mem = (T*)grk_aligned_malloc(dataSize);
-				if(!job->v.mem)
-				{
-					delete job;
-					grk_aligned_free(bj);
-					rc = false;
-					break;
-				}
-				job->v.dn = dn;
-				job->v.sn = sn;
-				job->v.parity = parity_col;
-				job->rh = rh;
-				job->w = stride;
-				job->tiledp = tiledp;
-				job->min_j = j * step_j;
-				job->max_j = (j + 1 == num_jobs) ? rw : (j + 1) * step_j;
-				if(node)
-				{
-					node[j].work([job] {
-						encode_v_func<T>(job);
-						return 0;
-					});
-				}
-				else
-				{
-					encode_v_func<T>(job);
-				}
-			}
-			if(node)
-			{
-				ExecSingleton::get()->run(taskflow).wait();
-				delete[] node;
-			}
-			if(!rc)
-				return false;
+			vert(0, rw);
+			horiz(0, rh);
+			continue;
 		}
 
-		sn = rw1;
-		dn = (uint32_t)(rw - rw1);
-
-		/* Perform horizontal pass */
-		if(num_threads <= 1 || rh <= 1)
+		// partition whole column groups, and rows, across all workers
+		auto resFlow = flow_->getResFlow((uint8_t)(resno - 1));
+		uint32_t numGroups = (rw + vertPassWidth - 1) / vertPassWidth;
+		uint32_t numJobs = std::min(numThreads, numGroups);
+		for(uint32_t j = 0; j < numJobs; ++j)
 		{
-			uint32_t j;
-			for(j = 0; j < rh; j++)
-			{
-				T* GRK_RESTRICT aj = (T*)(tiledp) + j * stride;
-				dwt.encode_and_deinterleave_h_one_row(aj, bj, rw, parity_row == 0 ? true : false);
-			}
+			uint32_t colMin = (uint32_t)((uint64_t)numGroups * j / numJobs) * vertPassWidth;
+			uint32_t colMax = std::min(
+				rw, (uint32_t)((uint64_t)numGroups * (j + 1) / numJobs) * vertPassWidth);
+			resFlow->waveletVert_->nextTask().work(
+				[vert, colMin, colMax] { vert(colMin, colMax); });
 		}
-		else
+		numJobs = std::min(numThreads, rh);
+		for(uint32_t j = 0; j < numJobs; ++j)
 		{
-			uint32_t num_jobs = (uint32_t)num_threads;
-			uint32_t step_j;
-
-			if(rh < num_jobs)
-				num_jobs = rh;
-			step_j = (rh / num_jobs);
-			tf::Taskflow taskflow;
-			tf::Task* node = nullptr;
-			if(num_jobs > 1)
-			{
-				node = new tf::Task[num_jobs];
-				for(uint64_t j = 0; j < num_jobs; j++)
-					node[j] = taskflow.placeholder();
-			}
-			for(uint32_t j = 0; j < num_jobs; j++)
-			{
-				auto job = new encode_h_job<T, DWT>();
-				job->h.mem = (T*)grk_aligned_malloc(dataSize);
-				if(!job->h.mem)
-				{
-					delete job;
-					grk_aligned_free(bj);
-					rc = false;
-					break;
-				}
-				job->h.dn = dn;
-				job->h.sn = sn;
-				job->h.parity = parity_row;
-				job->rw = rw;
-				job->w = stride;
-				job->tiledp = tiledp;
-				job->min_j = j * step_j;
-				job->max_j = (j + 1U) * step_j; // this can overflow
-				if(j == (num_jobs - 1U))
-				{ // this will take care of the overflow
-					job->max_j = rh;
-				}
-				if(node)
-					node[j].work([job] { encode_h_func<T, DWT>(job); });
-				else
-					encode_h_func<T, DWT>(job);
-			}
-			if(node)
-			{
-				ExecSingleton::get()->run(taskflow).wait();
-				delete[] node;
-			}
-			if(!rc)
-				return false;
+			auto rowMin = (uint32_t)((uint64_t)rh * j / numJobs);
+			auto rowMax = (uint32_t)((uint64_t)rh * (j + 1) / numJobs);
+			resFlow->waveletHoriz_->nextTask().work(
+				[horiz, rowMin, rowMax] { horiz(rowMin, rowMax); });
 		}
-		currentRes = lastRes;
-		--lastRes;
 	}
 
-	grk_aligned_free(bj);
 	return true;
 }
 
-bool WaveletFwdImpl::compress(TileComponent* tile_comp, uint8_t qmfbid)
+bool WaveletFwdImpl::compress(TileComponent* tile_comp, uint8_t qmfbid, ImageComponentFlow* flow)
 {
+	flow_ = (flow && ExecSingleton::get()->num_workers() > 1) ? flow : nullptr;
+
 	return (qmfbid == 1) ? encode_procedure<int32_t, dwt53>(tile_comp)
 						 : encode_procedure<float, dwt97>(tile_comp);
 }
@@ -589,7 +336,7 @@ void dwt53::encode_and_deinterleave_v(int32_t* arrayIn, int32_t* tmpIn, uint32_t
 	const uint32_t sn = (height + (even ? 1 : 0)) >> 1;
 	const uint32_t dn = height - sn;
 
-	fetch_cols_vertical_pass<int32_t>(arrayIn, tmpIn, height, stride_width, cols);
+	fetch_cols_vertical_pass<int32_t, NB_ELTS_V8>(arrayIn, tmpIn, height, stride_width, cols);
 
 #define GRK_Sc(i) tmp[((i) << 1) * NB_ELTS_V8 + c]
 #define GRK_Dc(i) tmp[((1 + ((i) << 1))) * NB_ELTS_V8 + c]
@@ -798,10 +545,8 @@ void dwt53::encode_and_deinterleave_v(int32_t* arrayIn, int32_t* tmpIn, uint32_t
 	}
 #endif
 
-	if(cols == NB_ELTS_V8)
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, NB_ELTS_V8);
-	else
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, cols);
+	deinterleave_v_cols<int32_t, NB_ELTS_V8>(tmp, array, dn, sn, stride_width, even ? 0 : 1,
+											 cols);
 }
 
 /** Process one line for the horizontal pass of the 5x3 forward transform */
@@ -854,7 +599,7 @@ void dwt53::encode_and_deinterleave_h_one_row(int32_t* rowIn, int32_t* tmpIn, ui
 }
 
 /* Forward 9-7 transform, for the vertical pass, processing cols columns */
-/* where cols <= NB_ELTS_V8 */
+/* where cols <= NB_ELTS_V16 */
 void dwt97::encode_and_deinterleave_v(float* arrayIn, float* tmpIn, uint32_t height, bool even,
 									  uint32_t stride_width, uint32_t cols)
 {
@@ -867,7 +612,7 @@ void dwt97::encode_and_deinterleave_v(float* arrayIn, float* tmpIn, uint32_t hei
 	if(height == 1)
 		return;
 
-	fetch_cols_vertical_pass(arrayIn, tmpIn, height, stride_width, cols);
+	fetch_cols_vertical_pass<float, NB_ELTS_V16>(arrayIn, tmpIn, height, stride_width, cols);
 	if(even)
 	{
 		a = 0;
@@ -878,21 +623,18 @@ void dwt97::encode_and_deinterleave_v(float* arrayIn, float* tmpIn, uint32_t hei
 		a = 1;
 		b = 0;
 	}
-	grk_v8dwt_encode_step2(tmp + a * NB_ELTS_V8, tmp + (b + 1) * NB_ELTS_V8, dn,
-						   std::min<uint32_t>(dn, sn - b), alpha);
-	grk_v8dwt_encode_step2(tmp + b * NB_ELTS_V8, tmp + (a + 1) * NB_ELTS_V8, sn,
-						   std::min<uint32_t>(sn, dn - a), beta);
-	grk_v8dwt_encode_step2(tmp + a * NB_ELTS_V8, tmp + (b + 1) * NB_ELTS_V8, dn,
-						   std::min<uint32_t>(dn, sn - b), gamma);
-	grk_v8dwt_encode_step2(tmp + b * NB_ELTS_V8, tmp + (a + 1) * NB_ELTS_V8, sn,
-						   std::min<uint32_t>(sn, dn - a), delta);
-	grk_v8dwt_encode_step1(tmp + b * NB_ELTS_V8, (uint32_t)dn, grk_K);
-	grk_v8dwt_encode_step1(tmp + a * NB_ELTS_V8, (uint32_t)sn, grk_invK);
-
-	if(cols == NB_ELTS_V8)
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, NB_ELTS_V8);
-	else
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, cols);
+	dwt97_step2(tmp + a * NB_ELTS_V16, tmp + (b + 1) * NB_ELTS_V16, dn,
+				std::min<uint32_t>(dn, sn - b), NB_ELTS_V16, alpha);
+	dwt97_step2(tmp + b * NB_ELTS_V16, tmp + (a + 1) * NB_ELTS_V16, sn,
+				std::min<uint32_t>(sn, dn - a), NB_ELTS_V16, beta);
+	dwt97_step2(tmp + a * NB_ELTS_V16, tmp + (b + 1) * NB_ELTS_V16, dn,
+				std::min<uint32_t>(dn, sn - b), NB_ELTS_V16, gamma);
+	dwt97_step2(tmp + b * NB_ELTS_V16, tmp + (a + 1) * NB_ELTS_V16, sn,
+				std::min<uint32_t>(sn, dn - a), NB_ELTS_V16, delta);
+	dwt97_step1(tmp + b * NB_ELTS_V16, dn, NB_ELTS_V16, grk_K);
+	dwt97_step1(tmp + a * NB_ELTS_V16, sn, NB_ELTS_V16, grk_invK);
+
+	deinterleave_v_cols<float, NB_ELTS_V16>(tmp, array, dn, sn, stride_width, even ? 0 : 1, cols);
 }
 
 /** Process one line for the horizontal pass of the 9x7 forward transform */
@@ -909,4 +651,223 @@ void dwt97::encode_and_deinterleave_h_one_row(float* rowIn, float* tmpIn, uint32
 	deinterleave_h(tmp, row, dn, sn, even ? 0 : 1);
 }
 
+WaveletFwdStream::WaveletFwdStream(TileComponent* tilec, uint8_t qmfbid, BlockRowHandler handler)
+	: tilec_(tilec), qmfbid_(qmfbid), numSteps_(qmfbid == 1 ? 2 : 4), ringSize_(numSteps_ + 3U),
+	  handler_(handler), tmp_(nullptr), nextInputRow_(tilec->y0)
+{}
+WaveletFwdStream::~WaveletFwdStream()
+{
+	for(auto& level : levels_)
+		grk_aligned_free(level.rows);
+	for(auto& strip : bands_)
+		grk_aligned_free(strip.buf);
+	grk_aligned_free(tmp_);
+}
+bool WaveletFwdStream::init(void)
+{
+	uint8_t numres = tilec_->numresolutions;
+	levels_.resize(numres);
+	bands_.resize(3U * numres - 2U);
+	for(uint8_t resno = 0; resno < numres; ++resno)
+	{
+		auto res = tilec_->resolutions_ + resno;
+		if(resno > 0)
+		{
+			auto level = &levels_[resno];
+			level->bounds = *res;
+			level->stride = grk_make_aligned_width(std::max<uint32_t>(res->width(), 1));
+			size_t len = (size_t)ringSize_ * level->stride * sizeof(int32_t);
+			level->rows = (int32_t*)grk_aligned_malloc(len);
+			if(!level->rows)
+				return false;
+			memset(level->rows, 0, len);
+			for(auto& p : level->progress)
+				p = res->y0;
+			level->nextEmit = res->y0;
+		}
+		for(uint8_t bandIndex = 0; bandIndex < res->numTileBandWindows; ++bandIndex)
+		{
+			auto tileBand = res->tileBand + bandIndex;
+			auto strip = band(resno, bandIndex);
+			strip->bounds = *tileBand;
+			strip->buf = nullptr;
+			if(tileBand->empty() || tileBand->precincts.empty())
+				continue;
+			uint8_t expn = (uint8_t)tileBand->precincts.front()->getCblkExpn().y;
+			strip->cblkExpnY = expn;
+			strip->stride = grk_make_aligned_width(tileBand->width());
+			strip->y0 = tileBand->y0;
+			strip->y1 = std::min<uint32_t>(tileBand->y1, ((tileBand->y0 >> expn) + 1) << expn);
+			size_t len = ((size_t)1 << expn) * strip->stride * sizeof(int32_t);
+			strip->buf = (int32_t*)grk_aligned_malloc(len);
+			if(!strip->buf)
+				return false;
+			memset(strip->buf, 0, len);
+		}
+	}
+	auto highest = tilec_->resolutions_ + numres - 1;
+	tmp_ = (int32_t*)grk_aligned_malloc(
+		grk_make_aligned_width(std::max<uint32_t>(highest->width(), 1)) * sizeof(int32_t));
+
+	return tmp_ != nullptr;
+}
+int32_t* WaveletFwdStream::levelRow(Level* level, uint32_t y)
+{
+	return level->rows + (size_t)(y % ringSize_) * level->stride;
+}
+WaveletFwdStream::BandStrip* WaveletFwdStream::band(uint8_t resno, uint8_t bandIndex)
+{
+	return &bands_[resno == 0 ? 0 : 3U * resno - 2U + bandIndex];
+}
+int32_t* WaveletFwdStream::nextRow(void)
+{
+	uint8_t top = (uint8_t)(tilec_->numresolutions - 1);
+	if(top == 0)
+		return bandRow(band(0, 0), nextInputRow_);
+	auto level = &levels_[top];
+	assert(level->progress[0] - level->nextEmit < ringSize_);
+
+	return levelRow(level, level->progress[0]);
+}
+bool WaveletFwdStream::pushRow(void)
+{
+	uint8_t top = (uint8_t)(tilec_->numresolutions - 1);
+	uint32_t y = nextInputRow_++;
+
+	return top == 0 ? bandRowDone(0, 0, y) : push(top);
+}
+bool WaveletFwdStream::push(uint8_t resno)
+{
+	auto level = &levels_[resno];
+	auto p = level->progress;
+	uint32_t y0 = level->bounds.y0;
+	uint32_t y1 = level->bounds.y1;
+	p[0]++;
+	if(y1 - y0 == 1)
+	{
+		for(uint8_t k = 1; k <= numSteps_; ++k)
+			p[k] = p[0];
+	}
+	for(uint8_t k = 0; k < numSteps_; ++k)
+	{
+		while(p[k + 1] < p[k])
+		{
+			uint32_t y = p[k + 1];
+			// even steps lift high pass (odd) rows, and odd steps lift low pass (even) rows
+			if((y ^ k) & 1)
+			{
+				bool hasNext = y + 1 < y1;
+				if(hasNext && y + 1 >= p[k])
+					break;
+				auto prev = (y > y0) ? levelRow(level, y - 1) : nullptr;
+				auto next = hasNext ? levelRow(level, y + 1) : nullptr;
+				// symmetric extension at level boundaries
+				lift(k, levelRow(level, y), prev ? prev : next, next ? next : prev,
+					 level->bounds.width());
+			}
+			p[k + 1]++;
+		}
+	}
+	// a row can only be transformed horizontally once its successor
+	// no longer needs it for lifting
+	uint32_t done = p[numSteps_];
+	while(level->nextEmit < done && (level->nextEmit + 1 < done || done == y1))
+	{
+		if(!emit(resno, level->nextEmit))
+			return false;
+		level->nextEmit++;
+	}
+
+	return true;
+}
+void WaveletFwdStream::lift(uint8_t step, int32_t* dest, const int32_t* a, const int32_t* b,
+							uint32_t len)
+{
+	static const float coefficients97[] = {alpha, beta, gamma, delta};
+	if(qmfbid_ == 1)
+	{
+		if(step == 0)
+			dwt53_fwd_lift_row_h(dest, a, b, len);
+		else
+			dwt53_fwd_lift_row_l(dest, a, b, len);
+	}
+	else
+	{
+		dwt97_lift_row((float*)dest, (const float*)a, (const float*)b, len, coefficients97[step]);
+	}
+}
+bool WaveletFwdStream::emit(uint8_t resno, uint32_t y)
+{
+	auto level = &levels_[resno];
+	auto row = levelRow(level, y);
+	uint32_t width = level->bounds.width();
+	bool low = !(y & 1);
+	bool even = !(level->bounds.x0 & 1);
+	uint32_t sn = (width + (even ? 1 : 0)) >> 1;
+	if(qmfbid_ == 1)
+	{
+		// a lone high pass row is doubled
+		if(level->bounds.height() == 1 && !low)
+		{
+			for(uint32_t i = 0; i < width; ++i)
+				row[i] *= 2;
+		}
+		dwt53 dwt;
+		dwt.encode_and_deinterleave_h_one_row(row, tmp_, width, even);
+	}
+	else
+	{
+		if(level->bounds.height() > 1)
+			dwt97_scale_row((float*)row, width, low ? grk_invK : grk_K);
+		dwt97 dwt;
+		dwt.encode_and_deinterleave_h_one_row((float*)row, (float*)tmp_, width, even);
+	}
+	if(!low)
+		return writeBandRow(resno, 1, y >> 1, row) && writeBandRow(resno, 2, y >> 1, row + sn);
+	if(resno == 1)
+	{
+		if(!writeBandRow(0, 0, y >> 1, row))
+			return false;
+	}
+	else
+	{
+		auto next = &levels_[resno - 1];
+		assert(next->progress[0] == y >> 1);
+		assert(next->progress[0] - next->nextEmit < ringSize_);
+		memcpy(levelRow(next, next->progress[0]), row, sn * sizeof(int32_t));
+		if(!push((uint8_t)(resno - 1)))
+			return false;
+	}
+
+	return writeBandRow(resno, 0, y >> 1, row + sn);
+}
+int32_t* WaveletFwdStream::bandRow(BandStrip* strip, uint32_t y)
+{
+	assert(y >= strip->y0 && y < strip->y1);
+
+	return strip->buf + (size_t)(y - strip->y0) * strip->stride;
+}
+bool WaveletFwdStream::bandRowDone(uint8_t resno, uint8_t bandIndex, uint32_t y)
+{
+	auto strip = band(resno, bandIndex);
+	if(y + 1 < strip->y1)
+		return true;
+	if(!handler_(resno, bandIndex, strip->y0, strip->buf, strip->stride))
+		return false;
+	strip->y0 = strip->y1;
+	strip->y1 = std::min<uint32_t>(strip->bounds.y1, strip->y0 + (1U << strip->cblkExpnY));
+
+	return true;
+}
+bool WaveletFwdStream::writeBandRow(uint8_t resno, uint8_t bandIndex, uint32_t y,
+									const int32_t* src)
+{
+	auto strip = band(resno, bandIndex);
+	if(!strip->buf)
+		return true;
+	memcpy(bandRow(strip, y), src, strip->bounds.width() * sizeof(int32_t));
+
+	return bandRowDone(resno, bandIndex, y);
+}
+
 } // namespace grk
@@ -25,6 +25,9 @@ namespace grk
 class dwt53
 {
   public:
+	// number of columns processed together by the vertical pass
+	static constexpr uint32_t vertPassWidth = 8;
+
 	void encode_and_deinterleave_v(int32_t* arrayIn, int32_t* tmpIn, uint32_t height, bool even,
 								   uint32_t stride_width, uint32_t cols);
 
@@ -35,14 +38,14 @@ class dwt53
 class dwt97
 {
   public:
+	static constexpr uint32_t vertPassWidth = 16;
+
 	void encode_and_deinterleave_v(float* arrayIn, float* tmpIn, uint32_t height, bool even,
 								   uint32_t stride_width, uint32_t cols);
 
 	void encode_and_deinterleave_h_one_row(float* rowIn, float* tmpIn, uint32_t width, bool even);
 
   private:
-	void grk_v8dwt_encode_step1(float* fw, uint32_t end, const float cst);
-	void grk_v8dwt_encode_step2(float* fl, float* fw, uint32_t end, uint32_t m, float cst);
 	void encode_step2(float* fl, float* fw, uint32_t end, uint32_t m, float c);
 
 	void encode_step1_combined(float* fw, uint32_t iters_c1, uint32_t iters_c2, const float c1,
@@ -53,12 +56,98 @@ class dwt97
 class WaveletFwdImpl
 {
   public:
-	virtual ~WaveletFwdImpl() = default;
-	bool compress(TileComponent* tile_comp, uint8_t qmfbid);
+	WaveletFwdImpl(void);
+	virtual ~WaveletFwdImpl();
+	/**
+	 * Forward transform a tile component.
+	 *
+	 * If a flow is given and there are multiple workers, each level's vertical and
+	 * horizontal passes are partitioned across all workers, and scheduled in the wavelet
+	 * components of the level's resolution flow rather than run. The caller must then
+	 * graph and run the flow while this object is alive.
+	 */
+	bool compress(TileComponent* tile_comp, uint8_t qmfbid, ImageComponentFlow* flow = nullptr);
 
   private:
 	template<typename T, typename DWT>
 	bool encode_procedure(TileComponent* tilec);
+
+	ImageComponentFlow* flow_;
+	// per-worker scratch
+	std::vector<void*> scratch_;
+};
+
+/**
+ * Receives a row of code blocks of a subband once all of its samples are available.
+ * The strip holds band rows starting at band row y0, and starts at the band's first column.
+ */
+typedef std::function<bool(uint8_t resno, uint8_t bandIndex, uint32_t y0, int32_t* strip,
+						   uint32_t stride)>
+	BlockRowHandler;
+
+/**
+ * Forward wavelet transform of a tile component that consumes rows in order, top to bottom.
+ *
+ * Each level lifts a sliding window of a few rows. Rows that are final are transformed
+ * horizontally and split into the level's subbands, while their low pass half feeds the
+ * next level. Each subband collects one row of code blocks at a time, and hands it to
+ * the block row handler, so memory is proportional to the tile component width.
+ * Output is identical to WaveletFwdImpl.
+ */
+class WaveletFwdStream
+{
+  public:
+	WaveletFwdStream(TileComponent* tilec, uint8_t qmfbid, BlockRowHandler handler);
+	~WaveletFwdStream();
+	bool init(void);
+	/**
+	 * Get buffer for the next row of the highest resolution. The caller fills it with
+	 * dc shifted samples, which are floating point for the 9/7 transform.
+	 * The buffer is padded to a whole number of vectors.
+	 */
+	int32_t* nextRow(void);
+	/**
+	 * Transform the row returned by the last call to nextRow
+	 */
+	bool pushRow(void);
+
+  private:
+	struct Level
+	{
+		grk_rect32 bounds;
+		uint32_t stride;
+		int32_t* rows;
+		// progress[k] : end of rows that have passed the first k lifting steps
+		uint32_t progress[5];
+		uint32_t nextEmit;
+	};
+	struct BandStrip
+	{
+		grk_rect32 bounds;
+		uint32_t stride;
+		int32_t* buf;
+		uint8_t cblkExpnY;
+		uint32_t y0;
+		uint32_t y1;
+	};
+	int32_t* levelRow(Level* level, uint32_t y);
+	BandStrip* band(uint8_t resno, uint8_t bandIndex);
+	bool push(uint8_t resno);
+	void lift(uint8_t step, int32_t* dest, const int32_t* a, const int32_t* b, uint32_t len);
+	bool emit(uint8_t resno, uint32_t y);
+	int32_t* bandRow(BandStrip* strip, uint32_t y);
+	bool bandRowDone(uint8_t resno, uint8_t bandIndex, uint32_t y);
+	bool writeBandRow(uint8_t resno, uint8_t bandIndex, uint32_t y, const int32_t* src);
+
+	TileComponent* tilec_;
+	uint8_t qmfbid_;
+	uint8_t numSteps_;
+	uint32_t ringSize_;
+	BlockRowHandler handler_;
+	std::vector<Level> levels_;
+	std::vector<BandStrip> bands_;
+	int32_t* tmp_;
+	uint32_t nextInputRow_;
 };
 
 } // namespace grk
@@ -24,219 +24,9 @@
 #include <limits>
 #include <sstream>
 
-#undef HWY_TARGET_INCLUDE
-#define HWY_TARGET_INCLUDE "wavelet/WaveletReverse.cpp"
-#include <hwy/foreach_target.h>
-#include <hwy/highway.h>
-HWY_BEFORE_NAMESPACE();
 namespace grk
 {
-namespace HWY_NAMESPACE
-{
-	using namespace hwy::HWY_NAMESPACE;
-
-	static size_t hwy_num_lanes(void)
-	{
-		const HWY_FULL(int32_t) di;
-		return Lanes(di);
-	}
-
-#define HWY_PLL_COLS_53 (2 * Lanes(di))
-
-	static void hwy_decompress_v_final_memcpy_53(const int32_t* buf, const uint32_t height,
-												 int32_t* dest, const size_t strideDest)
-	{
-		const HWY_FULL(int32_t) di;
-		for(uint32_t i = 0; i < height; ++i)
-		{
-			StoreU(Load(di, buf + HWY_PLL_COLS_53 * i + 0), di, &dest[(size_t)i * strideDest + 0]);
-			StoreU(Load(di, buf + HWY_PLL_COLS_53 * i + Lanes(di)), di,
-				   dest + (size_t)i * strideDest + Lanes(di));
-		}
-	}
-	/** Vertical inverse 5x3 wavelet transform for 8 columns in SSE2, or
-	 * 16 in AVX2, when top-most pixel is on even coordinate */
-	static void hwy_decompress_v_parity_even_mcols_53(int32_t* buf, int32_t* bandL, /* even */
-													  const uint32_t hL, const size_t strideL,
-													  int32_t* bandH, /* odd */
-													  const uint32_t hH, const size_t strideH,
-													  int32_t* dest, const uint32_t strideDest)
-	{
-		const HWY_FULL(int32_t) di;
-		auto two = Set(di, 2);
-
-		const uint32_t total_height = hL + hH;
-		assert(total_height > 1);
-
-		/* Note: loads of input even/odd values must be done in a unaligned */
-		/* fashion. But stores in tmp can be done with aligned store, since */
-		/* the temporary buffer is properly aligned */
-		assert((size_t)buf % (sizeof(int32_t) * Lanes(di)) == 0);
-
-		auto s1n_0 = LoadU(di, bandL + 0);
-		auto s1n_1 = LoadU(di, bandL + Lanes(di));
-		auto d1n_0 = LoadU(di, bandH);
-		auto d1n_1 = LoadU(di, bandH + Lanes(di));
-
-		/* s0n = s1n - ((d1n + 1) >> 1); <==> */
-		/* s0n = s1n - ((d1n + d1n + 2) >> 2); */
-		auto s0n_0 = s1n_0 - ShiftRight<2>(d1n_0 + d1n_0 + two);
-		auto s0n_1 = s1n_1 - ShiftRight<2>(d1n_1 + d1n_1 + two);
-
-		uint32_t i = 0;
-		if(total_height > 3)
-		{
-			uint32_t j;
-			for(i = 0, j = 1; i < (total_height - 3); i += 2, j++)
-			{
-				auto d1c_0 = d1n_0;
-				auto s0c_0 = s0n_0;
-				auto d1c_1 = d1n_1;
-				auto s0c_1 = s0n_1;
-
-				s1n_0 = LoadU(di, bandL + j * strideL);
-				s1n_1 = LoadU(di, bandL + j * strideL + Lanes(di));
-				d1n_0 = LoadU(di, bandH + j * strideH);
-				d1n_1 = LoadU(di, bandH + j * strideH + Lanes(di));
-
-				/*s0n = s1n - ((d1c + d1n + 2) >> 2);*/
-				s0n_0 = s1n_0 - ShiftRight<2>(d1c_0 + d1n_0 + two);
-				s0n_1 = s1n_1 - ShiftRight<2>(d1c_1 + d1n_1 + two);
-
-				Store(s0c_0, di, buf + HWY_PLL_COLS_53 * (i + 0));
-				Store(s0c_1, di, buf + HWY_PLL_COLS_53 * (i + 0) + Lanes(di));
-
-				/* d1c + ((s0c + s0n) >> 1) */
-				Store(d1c_0 + ShiftRight<1>(s0c_0 + s0n_0), di,
-					  buf + HWY_PLL_COLS_53 * (i + 1) + 0);
-				Store(d1c_1 + ShiftRight<1>(s0c_1 + s0n_1), di,
-					  buf + HWY_PLL_COLS_53 * (i + 1) + Lanes(di));
-			}
-		}
-		Store(s0n_0, di, buf + HWY_PLL_COLS_53 * (i + 0) + 0);
-		Store(s0n_1, di, buf + HWY_PLL_COLS_53 * (i + 0) + Lanes(di));
-
-		if(total_height & 1)
-		{
-			s1n_0 = LoadU(di, bandL + (size_t)((total_height - 1) / 2) * strideL);
-			/* tmp_len_minus_1 = s1n - ((d1n + 1) >> 1); */
-			auto tmp_len_minus_1 = s1n_0 - ShiftRight<2>(d1n_0 + d1n_0 + two);
-			Store(tmp_len_minus_1, di, buf + HWY_PLL_COLS_53 * (total_height - 1));
-			/* d1n + ((s0n + tmp_len_minus_1) >> 1) */
-			Store(d1n_0 + ShiftRight<1>(s0n_0 + tmp_len_minus_1), di,
-				  buf + HWY_PLL_COLS_53 * (total_height - 2));
-
-			s1n_1 = LoadU(di, bandL + (size_t)((total_height - 1) / 2) * strideL + Lanes(di));
-			/* tmp_len_minus_1 = s1n - ((d1n + 1) >> 1); */
-			tmp_len_minus_1 = s1n_1 - ShiftRight<2>(d1n_1 + d1n_1 + two);
-			Store(tmp_len_minus_1, di, buf + HWY_PLL_COLS_53 * (total_height - 1) + Lanes(di));
-			/* d1n + ((s0n + tmp_len_minus_1) >> 1) */
-			Store(d1n_1 + ShiftRight<1>(s0n_1 + tmp_len_minus_1), di,
-				  buf + HWY_PLL_COLS_53 * (total_height - 2) + Lanes(di));
-		}
-		else
-		{
-			Store(d1n_0 + s0n_0, di, buf + HWY_PLL_COLS_53 * (total_height - 1) + 0);
-			Store(d1n_1 + s0n_1, di, buf + HWY_PLL_COLS_53 * (total_height - 1) + Lanes(di));
-		}
-		hwy_decompress_v_final_memcpy_53(buf, total_height, dest, strideDest);
-	}
-
-	/** Vertical inverse 5x3 wavelet transform for 8 columns in SSE2, or
-	 * 16 in AVX2, when top-most pixel is on odd coordinate */
-	static void hwy_decompress_v_parity_odd_mcols_53(int32_t* buf, int32_t* bandL,
-													 const uint32_t hL, const uint32_t strideL,
-													 int32_t* bandH, const uint32_t hH,
-													 const uint32_t strideH, int32_t* dest,
-													 const uint32_t strideDest)
-	{
-		const HWY_FULL(int32_t) di;
-		auto two = Set(di, 2);
-
-		const uint32_t total_height = hL + hH;
-		assert(total_height > 2);
-		/* Note: loads of input even/odd values must be done in a unaligned */
-		/* fashion. But stores in buf can be done with aligned store, since */
-		/* the temporary buffer is properly aligned */
-		assert((size_t)buf % (sizeof(int32_t) * Lanes(di)) == 0);
-
-		const int32_t* in_even = bandH;
-		const int32_t* in_odd = bandL;
-		auto s1_0 = LoadU(di, in_even + strideH);
-
-		/* in_odd[0] - ((in_even[0] + s1 + 2) >> 2); */
-		auto dc_0 = LoadU(di, in_odd + 0) - ShiftRight<2>(LoadU(di, in_even + 0) + s1_0 + two);
-		Store(LoadU(di, in_even + 0) + dc_0, di, buf + HWY_PLL_COLS_53 * 0);
-		auto s1_1 = LoadU(di, in_even + strideH + Lanes(di));
-
-		/* in_odd[0] - ((in_even[0] + s1 + 2) >> 2); */
-		auto dc_1 = LoadU(di, in_odd + Lanes(di)) -
-					ShiftRight<2>(LoadU(di, in_even + Lanes(di)) + s1_1 + two);
-		Store(LoadU(di, in_even + Lanes(di)) + dc_1, di, buf + HWY_PLL_COLS_53 * 0 + Lanes(di));
-
-		uint32_t i;
-		size_t j;
-		for(i = 1, j = 1; i < (total_height - 2 - !(total_height & 1)); i += 2, j++)
-		{
-			auto s2_0 = LoadU(di, in_even + (j + 1) * strideH);
-			auto s2_1 = LoadU(di, in_even + (j + 1) * strideH + Lanes(di));
-
-			/* dn = in_odd[j * stride] - ((s1 + s2 + 2) >> 2); */
-			auto dn_0 = LoadU(di, in_odd + j * strideL) - ShiftRight<2>(s1_0 + s2_0 + two);
-			auto dn_1 =
-				LoadU(di, in_odd + j * strideL + Lanes(di)) - ShiftRight<2>(s1_1 + s2_1 + two);
-
-			Store(dc_0, di, buf + HWY_PLL_COLS_53 * i);
-			Store(dc_1, di, buf + HWY_PLL_COLS_53 * i + Lanes(di));
-
-			/* buf[i + 1] = s1 + ((dn + dc) >> 1); */
-			Store(s1_0 + ShiftRight<1>(dn_0 + dc_0), di, buf + HWY_PLL_COLS_53 * (i + 1) + 0);
-			Store(s1_1 + ShiftRight<1>(dn_1 + dc_1), di,
-				  buf + HWY_PLL_COLS_53 * (i + 1) + Lanes(di));
-
-			dc_0 = dn_0;
-			s1_0 = s2_0;
-			dc_1 = dn_1;
-			s1_1 = s2_1;
-		}
-		Store(dc_0, di, buf + HWY_PLL_COLS_53 * i);
-		Store(dc_1, di, buf + HWY_PLL_COLS_53 * i + Lanes(di));
-
-		if(!(total_height & 1))
-		{
-			/*dn = in_odd[(len / 2 - 1) * stride] - ((s1 + 1) >> 1); */
-			auto dn_0 = LoadU(di, in_odd + (size_t)(total_height / 2 - 1) * strideL) -
-						ShiftRight<2>(s1_0 + s1_0 + two);
-			auto dn_1 = LoadU(di, in_odd + (size_t)(total_height / 2 - 1) * strideL + Lanes(di)) -
-						ShiftRight<2>(s1_1 + s1_1 + two);
-
-			/* buf[len - 2] = s1 + ((dn + dc) >> 1); */
-			Store(s1_0 + ShiftRight<1>(dn_0 + dc_0), di,
-				  buf + HWY_PLL_COLS_53 * (total_height - 2) + 0);
-			Store(s1_1 + ShiftRight<1>(dn_1 + dc_1), di,
-				  buf + HWY_PLL_COLS_53 * (total_height - 2) + Lanes(di));
-
-			Store(dn_0, di, buf + HWY_PLL_COLS_53 * (total_height - 1) + 0);
-			Store(dn_1, di, buf + HWY_PLL_COLS_53 * (total_height - 1) + Lanes(di));
-		}
-		else
-		{
-			Store(s1_0 + dc_0, di, buf + HWY_PLL_COLS_53 * (total_height - 1) + 0);
-			Store(s1_1 + dc_1, di, buf + HWY_PLL_COLS_53 * (total_height - 1) + Lanes(di));
-		}
-		hwy_decompress_v_final_memcpy_53(buf, total_height, dest, strideDest);
-	}
-
-} // namespace HWY_NAMESPACE
-} // namespace grk
-HWY_AFTER_NAMESPACE();
 
-#if HWY_ONCE
-namespace grk
-{
-HWY_EXPORT(hwy_num_lanes);
-HWY_EXPORT(hwy_decompress_v_parity_even_mcols_53);
-HWY_EXPORT(hwy_decompress_v_parity_odd_mcols_53);
 /* <summary>                             */
 /* Determine maximum computed resolution level for inverse wavelet transform */
 /* </summary>                            */
@@ -270,137 +60,19 @@ static const float dwt_delta = -0.443506852f; /*  -3633 */
 static const float K = 1.230174105f; /*  10078 */
 static const float twice_invK = 1.625732422f;
 
-// #undef __SSE__
-
-#ifdef __SSE__
-void WaveletReverse::decompress_step1_sse_97(Params97 d, const __m128 c)
-{
-	// process 4 floats at a time
-	auto mmData = (__m128*)d.data;
-	uint32_t i;
-	for(i = 0; i + 3 < d.len; i += 4, mmData += 8)
-	{
-		mmData[0] = _mm_mul_ps(mmData[0], c);
-		mmData[2] = _mm_mul_ps(mmData[2], c);
-		mmData[4] = _mm_mul_ps(mmData[4], c);
-		mmData[6] = _mm_mul_ps(mmData[6], c);
-	}
-	for(; i < d.len; ++i, mmData += 2)
-		mmData[0] = _mm_mul_ps(mmData[0], c);
-}
-#endif
-
-void WaveletReverse::decompress_step1_97(const Params97& d, const float c)
-{
-#ifdef __SSE__
-	decompress_step1_sse_97(d, _mm_set1_ps(c));
-#else
-	float* GRK_RESTRICT fw = (float*)d.data;
-
-	for(uint32_t i = 0; i < d.len; ++i, fw += 8)
-	{
-		fw[0] *= c;
-		fw[1] *= c;
-		fw[2] *= c;
-		fw[3] *= c;
-		;
-	}
-#endif
-}
-
-#ifdef __SSE__
-static void decompress_step2_sse_97(const Params97& d, __m128 c)
+static void decompress_step1_97(const Params97& d, const float c)
 {
-	__m128* GRK_RESTRICT vec_data = (__m128*)d.data;
-
-	uint32_t imax = (std::min<uint32_t>)(d.len, d.lenMax);
-
-	// initial tmp1 value is only necessary when
-	// absolute start of line is at 0
-	auto tmp1 = ((__m128*)d.dataPrev)[0];
-	uint32_t i = 0;
-	for(; i + 3 < imax; i += 4)
-	{
-		auto tmp2 = vec_data[-1];
-		auto tmp3 = vec_data[0];
-		auto tmp4 = vec_data[1];
-		auto tmp5 = vec_data[2];
-		auto tmp6 = vec_data[3];
-		auto tmp7 = vec_data[4];
-		auto tmp8 = vec_data[5];
-		auto tmp9 = vec_data[6];
-		vec_data[-1] = _mm_add_ps(tmp2, _mm_mul_ps(_mm_add_ps(tmp1, tmp3), c));
-		vec_data[1] = _mm_add_ps(tmp4, _mm_mul_ps(_mm_add_ps(tmp3, tmp5), c));
-		vec_data[3] = _mm_add_ps(tmp6, _mm_mul_ps(_mm_add_ps(tmp5, tmp7), c));
-		vec_data[5] = _mm_add_ps(tmp8, _mm_mul_ps(_mm_add_ps(tmp7, tmp9), c));
-		tmp1 = tmp9;
-		vec_data += 8;
-	}
-
-	for(; i < imax; ++i)
-	{
-		auto tmp2 = vec_data[-1];
-		auto tmp3 = vec_data[0];
-		vec_data[-1] = _mm_add_ps(tmp2, _mm_mul_ps(_mm_add_ps(tmp1, tmp3), c));
-		tmp1 = tmp3;
-		vec_data += 2;
-	}
-	if(d.lenMax < d.len)
-	{
-		assert(d.lenMax + 1 == d.len);
-		c = _mm_add_ps(c, c);
-		c = _mm_mul_ps(c, vec_data[-2]);
-		vec_data[-1] = _mm_add_ps(vec_data[-1], c);
-	}
+	dwt97_step1(d.data, d.len, d.width, c);
 }
-#endif
-
 static void decompress_step2_97(const Params97& d, float c)
 {
-#ifdef __SSE__
-	decompress_step2_sse_97(d, _mm_set1_ps(c));
-#else
-
-	float* dataPrev = (float*)d.dataPrev;
-	float* data = (float*)d.data;
-
-	uint32_t imax = (std::min<uint32_t>)(d.len, d.lenMax);
-	for(uint32_t i = 0; i < imax; ++i)
-	{
-		float tmp1_1 = dataPrev[0];
-		float tmp1_2 = dataPrev[1];
-		float tmp1_3 = dataPrev[2];
-		float tmp1_4 = dataPrev[3];
-		float tmp2_1 = data[-4];
-		float tmp2_2 = data[-3];
-		float tmp2_3 = data[-2];
-		float tmp2_4 = data[-1];
-		float tmp3_1 = data[0];
-		float tmp3_2 = data[1];
-		float tmp3_3 = data[2];
-		float tmp3_4 = data[3];
-		data[-4] = tmp2_1 + ((tmp1_1 + tmp3_1) * c);
-		data[-3] = tmp2_2 + ((tmp1_2 + tmp3_2) * c);
-		data[-2] = tmp2_3 + ((tmp1_3 + tmp3_3) * c);
-		data[-1] = tmp2_4 + ((tmp1_4 + tmp3_4) * c);
-		dataPrev = data;
-		data += 8;
-	}
-	if(d.lenMax < d.len)
-	{
-		assert(d.lenMax + 1 == d.len);
-		c += c;
-		data[-4] = data[-4] + dataPrev[0] * c;
-		data[-3] = data[-3] + dataPrev[1] * c;
-		data[-2] = data[-2] + dataPrev[2] * c;
-		data[-1] = data[-1] + dataPrev[3] * c;
-	}
-#endif
+	dwt97_step2(d.dataPrev, d.data, d.len, d.lenMax, d.width, c);
 }
 /* <summary>                             */
 /* Inverse 9-7 wavelet transform in 1-D. */
 /* </summary>                            */
-void WaveletReverse::decompress_step_97(dwt_data<vec4f>* GRK_RESTRICT dwt)
+template<typename T>
+void WaveletReverse::decompress_step_97(dwt_data<T>* GRK_RESTRICT dwt)
 {
 	if((!dwt->parity && dwt->dn_full == 0 && dwt->sn_full <= 1) ||
 	   (dwt->parity && dwt->sn_full == 0 && dwt->dn_full >= 1))
@@ -413,53 +85,34 @@ void WaveletReverse::decompress_step_97(dwt_data<vec4f>* GRK_RESTRICT dwt)
 	decompress_step2_97(makeParams97(dwt, true, false), dwt_beta);
 	decompress_step2_97(makeParams97(dwt, false, false), dwt_alpha);
 }
-void WaveletReverse::interleave_h_97(dwt_data<vec4f>* GRK_RESTRICT dwt,
+void WaveletReverse::interleave_h_97(dwt_data<vec16f>* GRK_RESTRICT dwt,
 									 grk_buf2d_simple<float> winL, grk_buf2d_simple<float> winH,
 									 uint32_t remaining_height)
 {
 	float* GRK_RESTRICT bi = (float*)(dwt->mem + dwt->parity);
 	uint32_t x0 = dwt->win_l.x0;
 	uint32_t x1 = dwt->win_l.x1;
-	const size_t vec4f_elts = vec4f::NUM_ELTS;
+	constexpr uint32_t elts = (uint32_t)vec16f::NUM_ELTS;
 	for(uint32_t k = 0; k < 2; ++k)
 	{
 		auto band = (k == 0) ? winL.buf_ : winH.buf_;
-		uint32_t stride = (k == 0) ? winL.stride_ : winH.stride_;
-		if(remaining_height >= vec4f_elts && ((size_t)band & 0x0f) == 0 &&
-		   ((size_t)bi & 0x0f) == 0 && (stride & 0x0f) == 0)
+		size_t stride = (k == 0) ? winL.stride_ : winH.stride_;
+		if(remaining_height >= elts)
 		{
 			/* Fast code path */
-			for(uint32_t i = x0; i < x1; ++i, bi += vec4f_elts * 2)
+			for(uint32_t i = x0; i < x1; ++i, bi += elts * 2)
 			{
-				uint32_t j = i;
-				bi[0] = band[j];
-				j += stride;
-				bi[1] = band[j];
-				j += stride;
-				bi[2] = band[j];
-				j += stride;
-				bi[3] = band[j];
+				for(uint32_t r = 0; r < elts; ++r)
+					bi[r] = band[i + r * stride];
 			}
 		}
 		else
 		{
 			/* Slow code path */
-			for(uint32_t i = x0; i < x1; ++i, bi += vec4f_elts * 2)
+			for(uint32_t i = x0; i < x1; ++i, bi += elts * 2)
 			{
-				uint32_t j = i;
-				bi[0] = band[j];
-				j += stride;
-				if(remaining_height == 1)
-					continue;
-				bi[1] = band[j];
-				j += stride;
-				if(remaining_height == 2)
-					continue;
-				bi[2] = band[j];
-				j += stride;
-				if(remaining_height == 3)
-					continue;
-				bi[3] = band[j];
+				for(uint32_t r = 0; r < remaining_height; ++r)
+					bi[r] = band[i + r * stride];
 			}
 		}
 		bi = (float*)(dwt->mem + 1 - dwt->parity);
@@ -467,52 +120,34 @@ void WaveletReverse::interleave_h_97(dwt_data<vec4f>* GRK_RESTRICT dwt,
 		x1 = dwt->win_h.x1;
 	}
 }
-void WaveletReverse::decompress_h_strip_97(dwt_data<vec4f>* GRK_RESTRICT horiz,
+void WaveletReverse::decompress_h_strip_97(dwt_data<vec16f>* GRK_RESTRICT horiz,
 										   const uint32_t resHeight, grk_buf2d_simple<float> winL,
 										   grk_buf2d_simple<float> winH,
 										   grk_buf2d_simple<float> winDest)
 {
 	float* GRK_RESTRICT dest = winDest.buf_;
-	const uint32_t strideDest = winDest.stride_;
-	uint32_t j;
-	const size_t vec4f_elts = vec4f::NUM_ELTS;
-	for(j = 0; j < (resHeight & (uint32_t)(~(vec4f_elts - 1))); j += vec4f_elts)
+	const size_t strideDest = winDest.stride_;
+	constexpr uint32_t elts = (uint32_t)vec16f::NUM_ELTS;
+	const uint32_t total = horiz->sn_full + horiz->dn_full;
+	for(uint32_t j = 0; j < resHeight; j += elts)
 	{
-		interleave_h_97(horiz, winL, winH, resHeight - j);
+		const uint32_t rows = (std::min<uint32_t>)(resHeight - j, elts);
+		interleave_h_97(horiz, winL, winH, rows);
 		decompress_step_97(horiz);
-		for(uint32_t k = 0; k < horiz->sn_full + horiz->dn_full; k++)
+		for(uint32_t r = 0; r < rows; ++r)
 		{
-			dest[k] = horiz->mem[k].val[0];
-			dest[k + (size_t)strideDest] = horiz->mem[k].val[1];
-			dest[k + (size_t)strideDest * 2] = horiz->mem[k].val[2];
-			dest[k + (size_t)strideDest * 3] = horiz->mem[k].val[3];
-		}
-		winL.buf_ += winL.stride_ << 2;
-		winH.buf_ += winH.stride_ << 2;
-		dest += strideDest << 2;
-	}
-	if(j < resHeight)
-	{
-		interleave_h_97(horiz, winL, winH, resHeight - j);
-		decompress_step_97(horiz);
-		for(uint32_t k = 0; k < horiz->sn_full + horiz->dn_full; k++)
-		{
-			switch(resHeight - j)
-			{
-				case 3:
-					dest[k + (strideDest << 1)] = horiz->mem[k].val[2];
-				/* FALLTHRU */
-				case 2:
-					dest[k + strideDest] = horiz->mem[k].val[1];
-				/* FALLTHRU */
-				case 1:
-					dest[k] = horiz->mem[k].val[0];
-			}
+			auto src = (float*)horiz->mem + r;
+			auto destRow = dest + r * strideDest;
+			for(uint32_t k = 0; k < total; k++)
+				destRow[k] = src[k * elts];
 		}
+		winL.buf_ += winL.stride_ * elts;
+		winH.buf_ += winH.stride_ * elts;
+		dest += strideDest * elts;
 	}
 }
 bool WaveletReverse::decompress_h_97(uint8_t res, uint32_t numThreads, size_t dataLength,
-									 dwt_data<vec4f>& GRK_RESTRICT horiz, const uint32_t resHeight,
+									 dwt_data<vec16f>& GRK_RESTRICT horiz, const uint32_t resHeight,
 									 grk_buf2d_simple<float> winL, grk_buf2d_simple<float> winH,
 									 grk_buf2d_simple<float> winDest)
 {
@@ -539,16 +174,13 @@ bool WaveletReverse::decompress_h_97(uint8_t res, uint32_t numThreads, size_t da
 		{
 			auto indexMin = j * incrPerJob;
 			auto indexMax = (j < (numTasks - 1U) ? (j + 1U) * incrPerJob : resHeight) - indexMin;
-			auto myhoriz = new dwt_data<vec4f>(horiz);
-			if(!myhoriz->alloc(dataLength))
-			{
-				Logger::logger_.error("Out of memory");
+			if(!allocScratch(scratchF_, dataLength))
 				return false;
-			}
-			resFlow->waveletHoriz_->nextTask().work([this, myhoriz, indexMax, winL, winH, winDest] {
-				decompress_h_strip_97(myhoriz, indexMax, winL, winH, winDest);
-				delete myhoriz;
-			});
+			resFlow->waveletHoriz_->nextTask().work(
+				[this, myhoriz = dwt_data<vec16f>(horiz), indexMax, winL, winH, winDest]() mutable {
+					myhoriz.mem = getScratch(scratchF_);
+					decompress_h_strip_97(&myhoriz, indexMax, winL, winH, winDest);
+				});
 			winL.incY_IN_PLACE(incrPerJob);
 			winH.incY_IN_PLACE(incrPerJob);
 			winDest.incY_IN_PLACE(incrPerJob);
@@ -556,104 +188,145 @@ bool WaveletReverse::decompress_h_97(uint8_t res, uint32_t numThreads, size_t da
 	}
 	return true;
 }
-void WaveletReverse::interleave_v_97(dwt_data<vec4f>* GRK_RESTRICT dwt,
-									 grk_buf2d_simple<float> winL, grk_buf2d_simple<float> winH,
-									 uint32_t nb_elts_read)
+/**********************************************************************************
+ *
+ * Line-based vertical pass
+ *
+ * L rows sit above H rows in the resolution buffer. Rows are lifted in place,
+ * top to bottom, on a sliding window of a few rows, and then moved to their
+ * interleaved positions. Lifting rows rather than gathered columns keeps memory
+ * access contiguous, and the window stays in cache.
+ *
+ **********************************************************************************/
+
+struct Lift97
 {
-	auto bi = dwt->mem + dwt->parity;
-	auto band = winL.buf_ + dwt->win_l.x0 * winL.stride_;
-	for(uint32_t i = dwt->win_l.x0; i < dwt->win_l.x1; ++i, bi += 2)
+	typedef float T;
+	static constexpr uint32_t numSteps = 4;
+	static void scale(float* row, uint32_t len, bool isL)
 	{
-		memcpy((float*)bi, band, nb_elts_read * sizeof(float));
-		band += winL.stride_;
+		dwt97_scale_row(row, len, isL ? K : twice_invK);
 	}
-	bi = dwt->mem + 1 - dwt->parity;
-	band = winH.buf_ + dwt->win_h.x0 * winH.stride_;
-	for(uint32_t i = dwt->win_h.x0; i < dwt->win_h.x1; ++i, bi += 2)
+	static void lift(uint32_t step, float* dest, const float* a, const float* b, uint32_t len)
 	{
-		memcpy((float*)bi, band, nb_elts_read * sizeof(float));
-		band += winH.stride_;
+		static const float coeff[numSteps] = {dwt_delta, dwt_gamma, dwt_beta, dwt_alpha};
+		dwt97_lift_row(dest, a, b, len, coeff[step]);
 	}
-}
-void WaveletReverse::decompress_v_strip_97(dwt_data<vec4f>* GRK_RESTRICT vert,
-										   const uint32_t resWidth, const uint32_t resHeight,
-										   grk_buf2d_simple<float> winL,
-										   grk_buf2d_simple<float> winH,
-										   grk_buf2d_simple<float> winDest)
+	static void single([[maybe_unused]] float* row, [[maybe_unused]] uint32_t len,
+					   [[maybe_unused]] uint32_t parity)
+	{}
+};
+
+/**
+ * Lift the rows of a resolution. Rows are requested from produce just before they
+ * enter the lifting window, so that the horizontal pass can run on a strip of rows
+ * while it is still in cache.
+ *
+ * Lifting step s (even steps update L rows, odd steps H rows) reaches row n at
+ * iteration n + s, after step s - 1 has been applied to both neighbours of n.
+ */
+template<typename LIFT, typename T, typename P>
+static void liftRows(const SplitRows<T>& rows, uint32_t len, P produce)
 {
-	uint32_t j;
-	const size_t vec4f_elts = vec4f::NUM_ELTS;
-	for(j = 0; j < (resWidth & (uint32_t) ~(vec4f_elts - 1)); j += vec4f_elts)
+	const uint32_t total = rows.total();
+	if(total == 1)
+	{
+		produce(0);
+		LIFT::single(rows.row(0), len, rows.parity_);
+		return;
+	}
+	uint32_t numProduced = 0;
+	for(uint32_t t = 0; t < total + LIFT::numSteps - 1; ++t)
 	{
-		interleave_v_97(vert, winL, winH, vec4f_elts);
-		decompress_step_97(vert);
-		auto destPtr = winDest.buf_;
-		for(uint32_t k = 0; k < resHeight; ++k)
+		for(; numProduced < total && numProduced <= t + 1; ++numProduced)
 		{
-			memcpy(destPtr, vert->mem + k, sizeof(vec4f));
-			destPtr += winDest.stride_;
+			produce(numProduced);
+			LIFT::scale(rows.row(numProduced), len, rows.isL(numProduced));
+		}
+		for(uint32_t s = 0; s < LIFT::numSteps && s <= t; ++s)
+		{
+			uint32_t n = t - s;
+			if(n >= total || rows.isL(n) != ((s & 1) == 0))
+				continue;
+			// symmetric extension at the boundaries
+			auto prev = rows.row(n > 0 ? n - 1 : n + 1);
+			auto next = rows.row(n + 1 < total ? n + 1 : n - 1);
+			LIFT::lift(s, rows.row(n), prev, next, len);
 		}
-		winL.buf_ += vec4f_elts;
-		winH.buf_ += vec4f_elts;
-		winDest.buf_ += vec4f_elts;
 	}
-	if(j < resWidth)
+}
+
+/**
+ * Move lifted rows to their interleaved positions in winDest. If the split rows
+ * live in winDest, rows are moved in place along the cycles of the permutation,
+ * using tmp to hold one row.
+ */
+template<typename T>
+static void interleaveRows(const SplitRows<T>& rows, grk_buf2d_simple<T> winDest, uint32_t len,
+						   T* tmp)
+{
+	const uint32_t total = rows.total();
+	const size_t rowBytes = len * sizeof(T);
+	auto dest = [winDest](uint32_t n) { return winDest.buf_ + (size_t)n * winDest.stride_; };
+	bool inPlace = rows.winL_.buf_ == winDest.buf_ && rows.winL_.stride_ == winDest.stride_ &&
+				   rows.winH_.buf_ == dest(rows.hL_) && rows.winH_.stride_ == winDest.stride_;
+	if(!inPlace)
+	{
+		for(uint32_t n = 0; n < total; ++n)
+			memcpy(dest(n), rows.row(n), rowBytes);
+		return;
+	}
+	auto src = [&rows](uint32_t n) {
+		return rows.isL(n) ? rows.bandRow(n) : rows.hL_ + rows.bandRow(n);
+	};
+	std::vector<bool> moved(total, false);
+	for(uint32_t start = 0; start < total; ++start)
 	{
-		j = resWidth & (vec4f_elts - 1);
-		interleave_v_97(vert, winL, winH, j);
-		decompress_step_97(vert);
-		auto destPtr = winDest.buf_;
-		for(uint32_t k = 0; k < resHeight; ++k)
+		if(moved[start])
+			continue;
+		moved[start] = true;
+		if(src(start) == start)
+			continue;
+		memcpy(tmp, dest(start), rowBytes);
+		uint32_t n = start;
+		for(uint32_t s = src(n); s != start; n = s, s = src(n))
 		{
-			memcpy(destPtr, vert->mem + k, j * sizeof(float));
-			destPtr += winDest.stride_;
+			memcpy(dest(n), dest(s), rowBytes);
+			moved[s] = true;
 		}
+		memcpy(dest(n), tmp, rowBytes);
 	}
 }
-bool WaveletReverse::decompress_v_97(uint8_t res, uint32_t numThreads, size_t dataLength,
-									 dwt_data<vec4f>& GRK_RESTRICT vert, const uint32_t resWidth,
-									 const uint32_t resHeight, grk_buf2d_simple<float> winL,
-									 grk_buf2d_simple<float> winH, grk_buf2d_simple<float> winDest)
+
+template<typename LIFT, typename T, typename S>
+bool WaveletReverse::decompress_v(uint8_t res, uint32_t numThreads, size_t dataLength,
+								  SplitRows<T> rows, grk_buf2d_simple<T> winDest,
+								  uint32_t resWidth, std::vector<dwt_data<S>>& scratch)
 {
 	if(resWidth == 0)
 		return true;
-	if(numThreads == 1)
+	auto imageComponentFlow = scheduler_->getImageComponentFlow(compno_);
+	if(!imageComponentFlow)
 	{
-		decompress_v_strip_97(&vert, resWidth, resHeight, winL, winH, winDest);
+		Logger::logger_.warn("Missing image component flow");
+		return false;
 	}
-	else
+	auto resFlow = imageComponentFlow->getResFlow(res - 1);
+	if(!allocScratch(scratch, dataLength))
+		return false;
+	// each task lifts a slab of columns; slabs are a whole number of cache lines wide
+	constexpr uint32_t lineCols = 64 / sizeof(T);
+	uint32_t slabWidth = (resWidth + numThreads - 1) / numThreads;
+	slabWidth = (slabWidth + lineCols - 1) & ~(lineCols - 1);
+	for(uint32_t x = 0; x < resWidth; x += slabWidth)
 	{
-		auto numTasks = numThreads;
-		if(resWidth < numTasks)
-			numTasks = resWidth;
-		auto incrPerJob = resWidth / numTasks;
-		auto imageComponentFlow = scheduler_->getImageComponentFlow(compno_);
-		if(!imageComponentFlow)
-		{
-			Logger::logger_.warn("Missing image component flow");
-			return false;
-		}
-		auto resFlow = imageComponentFlow->getResFlow(res - 1);
-		for(uint32_t j = 0; j < numTasks; j++)
-		{
-			auto indexMin = j * incrPerJob;
-			auto indexMax = (j < (numTasks - 1U) ? (j + 1U) * incrPerJob : resWidth) - indexMin;
-			auto myvert = new dwt_data<vec4f>(vert);
-			if(!myvert->alloc(dataLength))
-			{
-				Logger::logger_.error("Out of memory");
-				delete myvert;
-				return false;
-			}
-			resFlow->waveletVert_->nextTask().work(
-				[this, myvert, resHeight, indexMax, winL, winH, winDest] {
-					decompress_v_strip_97(myvert, indexMax, resHeight, winL, winH, winDest);
-					delete myvert;
-				});
-			winL.incX_IN_PLACE(incrPerJob);
-			winH.incX_IN_PLACE(incrPerJob);
-			winDest.incX_IN_PLACE(incrPerJob);
-		}
+		uint32_t len = (std::min<uint32_t>)(slabWidth, resWidth - x);
+		resFlow->waveletVert_->nextTask().work([this, rows, winDest, len, &scratch]() {
+			liftRows<LIFT>(rows, len, []([[maybe_unused]] uint32_t n) {});
+			interleaveRows(rows, winDest, len, (T*)getScratch(scratch));
+		});
+		rows.incX_IN_PLACE(slabWidth);
+		winDest.incX_IN_PLACE(slabWidth);
 	}
 
 	return true;
@@ -668,9 +341,6 @@ bool WaveletReverse::decompress_tile_97(void)
 
 	auto tr = tilec_->resolutions_;
 	auto buf = tilec_->getWindow();
-	uint32_t resWidth = tr->width();
-	uint32_t resHeight = tr->height();
-
 	size_t dataLength = max_resolution(tr, numres_);
 	if(!horizF_.alloc(dataLength))
 	{
@@ -678,8 +348,11 @@ bool WaveletReverse::decompress_tile_97(void)
 		return false;
 	}
 	vertF_.mem = horizF_.mem;
+	tr += firstRes_ - 1;
+	uint32_t resWidth = tr->width();
+	uint32_t resHeight = tr->height();
 	uint32_t numThreads = (uint32_t)ExecSingleton::get()->num_workers();
-	for(uint8_t res = 1; res < numres_; ++res)
+	for(uint8_t res = firstRes_; res < numres_; ++res)
 	{
 		horizF_.sn_full = resWidth;
 		vertF_.sn_full = resHeight;
@@ -692,23 +365,57 @@ bool WaveletReverse::decompress_tile_97(void)
 		horizF_.parity = tr->x0 & 1;
 		horizF_.win_l = grk_line32(0, horizF_.sn_full);
 		horizF_.win_h = grk_line32(0, horizF_.dn_full);
-		auto winSplitL = buf->getResWindowBufferSplitSimpleF(res, SPLIT_L);
-		auto winSplitH = buf->getResWindowBufferSplitSimpleF(res, SPLIT_H);
-		if(!decompress_h_97(res, numThreads, dataLength, horizF_, vertF_.sn_full,
-							buf->getResWindowBufferSimpleF(res - 1U),
-							buf->getBandWindowBufferPaddedSimpleF(res, BAND_ORIENT_HL), winSplitL))
-			return false;
-		if(!decompress_h_97(res, numThreads, dataLength, horizF_, resHeight - vertF_.sn_full,
-							buf->getBandWindowBufferPaddedSimpleF(res, BAND_ORIENT_LH),
-							buf->getBandWindowBufferPaddedSimpleF(res, BAND_ORIENT_HH), winSplitH))
-			return false;
 		vertF_.dn_full = resHeight - vertF_.sn_full;
 		vertF_.parity = tr->y0 & 1;
 		vertF_.win_l = grk_line32(0, vertF_.sn_full);
 		vertF_.win_h = grk_line32(0, vertF_.dn_full);
-		if(!decompress_v_97(res, numThreads, dataLength, vertF_, resWidth, resHeight, winSplitL,
-							winSplitH, buf->getResWindowBufferSimpleF(res)))
-			return false;
+		grk_buf2d_simple<float> winSplit[2] = {buf->getResWindowBufferSplitSimpleF(res, SPLIT_L),
+											   buf->getResWindowBufferSplitSimpleF(res, SPLIT_H)};
+		grk_buf2d_simple<float> winBandL[2] = {
+			buf->getResWindowBufferSimpleF(res - 1U),
+			buf->getBandWindowBufferPaddedSimpleF(res, BAND_ORIENT_LH)};
+		grk_buf2d_simple<float> winBandH[2] = {
+			buf->getBandWindowBufferPaddedSimpleF(res, BAND_ORIENT_HL),
+			buf->getBandWindowBufferPaddedSimpleF(res, BAND_ORIENT_HH)};
+		auto winDest = buf->getResWindowBufferSimpleF(res);
+		SplitRows<float> rows(winSplit[0], winSplit[1], vertF_.sn_full, vertF_.dn_full,
+							  vertF_.parity);
+		if(numThreads == 1)
+		{
+			// fused pass: each strip of rows is transformed horizontally
+			// just before vertical lifting reaches it
+			uint32_t numDone[2] = {0, 0};
+			liftRows<Lift97>(rows, resWidth, [&](uint32_t n) {
+				uint32_t band = rows.isL(n) ? 0 : 1;
+				if(rows.bandRow(n) < numDone[band])
+					return;
+				uint32_t height = band == 0 ? rows.hL_ : rows.hH_;
+				uint32_t count =
+					(std::min<uint32_t>)(height - numDone[band], (uint32_t)vec16f::NUM_ELTS);
+				auto winL = winBandL[band];
+				auto winH = winBandH[band];
+				auto winSplitDest = winSplit[band];
+				winL.incY_IN_PLACE(numDone[band]);
+				winH.incY_IN_PLACE(numDone[band]);
+				winSplitDest.incY_IN_PLACE(numDone[band]);
+				decompress_h_strip_97(&horizF_, count, winL, winH, winSplitDest);
+				numDone[band] += count;
+			});
+			interleaveRows(rows, winDest, resWidth, (float*)horizF_.mem);
+		}
+		else
+		{
+			for(uint32_t band = 0; band < 2; ++band)
+			{
+				if(!decompress_h_97(res, numThreads, dataLength, horizF_,
+									band == 0 ? rows.hL_ : rows.hH_, winBandL[band],
+									winBandH[band], winSplit[band]))
+					return false;
+			}
+			if(!decompress_v<Lift97>(res, numThreads, dataLength, rows, winDest, resWidth,
+									 scratchF_))
+				return false;
+		}
 	}
 
 	return true;
@@ -800,104 +507,6 @@ void WaveletReverse::decompress_h_parity_odd_53(int32_t* buf, int32_t* bandL, /*
 	memcpy(dest, buf, total_width * sizeof(int32_t));
 }
 
-/** Vertical inverse 5x3 wavelet transform for one column, when top-most
- * pixel is on even coordinate */
-void WaveletReverse::decompress_v_parity_even_53(int32_t* buf, int32_t* bandL, const uint32_t hL,
-												 const uint32_t strideL, int32_t* bandH,
-												 const uint32_t hH, const uint32_t strideH,
-												 int32_t* dest, const uint32_t strideDest)
-{
-	const uint32_t total_height = hL + hH;
-	assert(total_height > 1);
-
-	/* Performs lifting in one single iteration. Saves memory */
-	/* accesses and explicit interleaving. */
-	int32_t s1n = bandL[0];
-	int32_t d1n = bandH[0];
-	int32_t s0n = s1n - ((d1n + 1) >> 1);
-
-	uint32_t i = 0;
-	if(total_height > 2)
-	{
-		auto bL = bandL + strideL;
-		auto bH = bandH + strideH;
-		for(uint32_t j = 0; i < (total_height - 3); i += 2, j++)
-		{
-			int32_t d1c = d1n;
-			int32_t s0c = s0n;
-			s1n = *bL;
-			bL += strideL;
-			d1n = *bH;
-			bH += strideH;
-			s0n = s1n - ((d1c + d1n + 2) >> 2);
-			buf[i] = s0c;
-			buf[i + 1] = d1c + ((s0c + s0n) >> 1);
-		}
-	}
-	buf[i] = s0n;
-	if(total_height & 1)
-	{
-		buf[total_height - 1] = bandL[((total_height - 1) >> 1) * strideL] - ((d1n + 1) >> 1);
-		buf[total_height - 2] = d1n + ((s0n + buf[total_height - 1]) >> 1);
-	}
-	else
-	{
-		buf[total_height - 1] = d1n + s0n;
-	}
-	for(i = 0; i < total_height; ++i)
-	{
-		*dest = buf[i];
-		dest += strideDest;
-	}
-}
-/** Vertical inverse 5x3 wavelet transform for one column, when top-most
- * pixel is on odd coordinate */
-void WaveletReverse::decompress_v_parity_odd_53(int32_t* buf, int32_t* bandL, const uint32_t hL,
-												const uint32_t strideL, int32_t* bandH,
-												const uint32_t hH, const uint32_t strideH,
-												int32_t* dest, const uint32_t strideDest)
-{
-	const uint32_t total_height = hL + hH;
-	assert(total_height > 2);
-
-	/* Performs lifting in one single iteration. Saves memory */
-	/* accesses and explicit interleaving. */
-	int32_t s1 = bandH[strideH];
-	int32_t dc = bandL[0] - ((bandH[0] + s1 + 2) >> 2);
-	buf[0] = bandH[0] + dc;
-	auto s2_ptr = bandH + (strideH << 1);
-	auto dn_ptr = bandL + strideL;
-	uint32_t i, j;
-	for(i = 1, j = 1; i < (total_height - 2 - !(total_height & 1)); i += 2, j++)
-	{
-		int32_t s2 = *s2_ptr;
-		s2_ptr += strideH;
-
-		int32_t dn = *dn_ptr - ((s1 + s2 + 2) >> 2);
-		dn_ptr += strideL;
-
-		buf[i] = dc;
-		buf[i + 1] = s1 + ((dn + dc) >> 1);
-		dc = dn;
-		s1 = s2;
-	}
-	buf[i] = dc;
-	if(!(total_height & 1))
-	{
-		int32_t dn = bandL[((total_height >> 1) - 1) * strideL] - ((s1 + 1) >> 1);
-		buf[total_height - 2] = s1 + ((dn + dc) >> 1);
-		buf[total_height - 1] = dn;
-	}
-	else
-	{
-		buf[total_height - 1] = s1 + dc;
-	}
-	for(i = 0; i < total_height; ++i)
-	{
-		*dest = buf[i];
-		dest += strideDest;
-	}
-}
 /* <summary>                            */
 /* Inverse 5-3 wavelet transform in 1-D for one row. */
 /* </summary>                           */
@@ -941,82 +550,6 @@ void WaveletReverse::decompress_h_53(const dwt_data<int32_t>* dwt, int32_t* band
 	}
 }
 
-/* <summary>                            */
-/* Inverse vertical 5-3 wavelet transform in 1-D for several columns. */
-/* </summary>                           */
-/* Performs interleave, inverse wavelet transform and copy back to buffer */
-/** Number of columns that we can process in parallel in the vertical pass */
-#define PLL_COLS_53 (2 * uint32_t(HWY_DYNAMIC_DISPATCH(hwy_num_lanes)()))
-void WaveletReverse::decompress_v_53(const dwt_data<int32_t>* dwt, grk_buf2d_simple<int32_t> winL,
-									 grk_buf2d_simple<int32_t> winH,
-									 grk_buf2d_simple<int32_t> winDest, uint32_t nb_cols)
-{
-	const uint32_t total_height = dwt->sn_full + dwt->dn_full;
-	assert(total_height != 0);
-	if(dwt->parity == 0)
-	{
-		if(total_height == 1)
-		{
-			for(uint32_t c = 0; c < nb_cols; c++, winL.buf_++, winDest.buf_++)
-				winDest.buf_[0] = winL.buf_[0];
-		}
-		else
-		{
-			if(nb_cols == PLL_COLS_53)
-			{
-				/* Same as below general case, except that thanks to SSE2/AVX2 */
-				/* we can efficiently process 8/16 columns in parallel */
-				HWY_DYNAMIC_DISPATCH(hwy_decompress_v_parity_even_mcols_53)
-				(dwt->mem, winL.buf_, dwt->sn_full, winL.stride_, winH.buf_, dwt->dn_full,
-				 winH.stride_, winDest.buf_, winDest.stride_);
-			}
-			else
-			{
-				for(uint32_t c = 0; c < nb_cols; c++, winL.buf_++, winH.buf_++, winDest.buf_++)
-					decompress_v_parity_even_53(dwt->mem, winL.buf_, dwt->sn_full, winL.stride_,
-												winH.buf_, dwt->dn_full, winL.stride_, winDest.buf_,
-												winDest.stride_);
-			}
-		}
-	}
-	else
-	{
-		if(total_height == 1)
-		{
-			for(uint32_t c = 0; c < nb_cols; c++, winL.buf_++, winDest.buf_++)
-				winDest.buf_[0] = winL.buf_[0] >> 1;
-		}
-		else if(total_height == 2)
-		{
-			auto out = dwt->mem;
-			for(uint32_t c = 0; c < nb_cols; c++, winL.buf_++, winH.buf_++, winDest.buf_++)
-			{
-				out[1] = winL.buf_[0] - ((winH.buf_[0] + 1) >> 1);
-				winDest.buf_[0] = winH.buf_[0] + out[1];
-				winDest.buf_[1] = out[1];
-			}
-		}
-		else
-		{
-			if(nb_cols == PLL_COLS_53)
-			{
-				/* Same as below general case, except that thanks to SSE2/AVX2 */
-				/* we can efficiently process 8/16 columns in parallel */
-				HWY_DYNAMIC_DISPATCH(hwy_decompress_v_parity_odd_mcols_53)
-				(dwt->mem, winL.buf_, dwt->sn_full, winL.stride_, winH.buf_, dwt->dn_full,
-				 winH.stride_, winDest.buf_, winDest.stride_);
-			}
-			else
-			{
-				for(uint32_t c = 0; c < nb_cols; c++, winL.buf_++, winH.buf_++, winDest.buf_++)
-					decompress_v_parity_odd_53(dwt->mem, winL.buf_, dwt->sn_full, winL.stride_,
-											   winH.buf_, dwt->dn_full, winH.stride_, winDest.buf_,
-											   winDest.stride_);
-			}
-		}
-	}
-}
-
 void WaveletReverse::decompress_h_strip_53(const dwt_data<int32_t>* horiz, uint32_t hMin,
 										   uint32_t hMax, grk_buf2d_simple<int32_t> winL,
 										   grk_buf2d_simple<int32_t> winH,
@@ -1082,17 +615,13 @@ bool WaveletReverse::decompress_h_53(uint8_t res, TileComponentWindow<int32_t>*
 				auto indexMin = j * incrPerJob;
 				auto indexMax =
 					j < (numTasks[orient] - 1U) ? (j + 1U) * incrPerJob : height[orient];
-				auto horiz = new dwt_data<int32_t>(horiz_);
-				if(!horiz->alloc(dataLength))
-				{
-					Logger::logger_.error("Out of memory");
-					delete horiz;
+				if(!allocScratch(scratch_, dataLength))
 					return false;
-				}
 				resFlow->waveletHoriz_->nextTask().work(
-					[this, horiz, winL, winH, winDest, indexMin, indexMax] {
-						decompress_h_strip_53(horiz, indexMin, indexMax, winL, winH, winDest);
-						delete horiz;
+					[this, horiz = dwt_data<int32_t>(horiz_), winL, winH, winDest, indexMin,
+					 indexMax]() mutable {
+						horiz.mem = getScratch(scratch_);
+						decompress_h_strip_53(&horiz, indexMin, indexMax, winL, winH, winDest);
 					});
 				winL.incY_IN_PLACE(incrPerJob);
 				winH.incY_IN_PLACE(incrPerJob);
@@ -1104,74 +633,31 @@ bool WaveletReverse::decompress_h_53(uint8_t res, TileComponentWindow<int32_t>*
 	return true;
 }
 
-void WaveletReverse::decompress_v_strip_53(const dwt_data<int32_t>* vert, uint32_t wMin,
-										   uint32_t wMax, grk_buf2d_simple<int32_t> winL,
-										   grk_buf2d_simple<int32_t> winH,
-										   grk_buf2d_simple<int32_t> winDest)
-{
-	uint32_t j;
-	for(j = wMin; j + PLL_COLS_53 <= wMax; j += PLL_COLS_53)
-	{
-		decompress_v_53(vert, winL, winH, winDest, PLL_COLS_53);
-		winL.incX_IN_PLACE(PLL_COLS_53);
-		winH.incX_IN_PLACE(PLL_COLS_53);
-		winDest.incX_IN_PLACE(PLL_COLS_53);
-	}
-	if(j < wMax)
-		decompress_v_53(vert, winL, winH, winDest, wMax - j);
-}
-
-bool WaveletReverse::decompress_v_53(uint8_t res, TileComponentWindow<int32_t>* buf,
-									 uint32_t resWidth, size_t dataLength)
+struct Lift53
 {
-	if(resWidth == 0)
-		return true;
-	uint32_t numThreads = (uint32_t)ExecSingleton::get()->num_workers();
-	auto winL = buf->getResWindowBufferSplitSimple(res, SPLIT_L);
-	auto winH = buf->getResWindowBufferSplitSimple(res, SPLIT_H);
-	auto winDest = buf->getResWindowBufferSimple(res);
-	if(numThreads == 1)
-	{
-		if(!horiz_.mem)
-		{
-			if(!horiz_.alloc(dataLength))
-			{
-				Logger::logger_.error("Out of memory");
-				return false;
-			}
-			vert_.mem = horiz_.mem;
-		}
-		decompress_v_strip_53(&vert_, 0, resWidth, winL, winH, winDest);
+	typedef int32_t T;
+	static constexpr uint32_t numSteps = 2;
+	static void scale([[maybe_unused]] int32_t* row, [[maybe_unused]] uint32_t len,
+					  [[maybe_unused]] bool isL)
+	{}
+	static void lift(uint32_t step, int32_t* dest, const int32_t* a, const int32_t* b,
+					 uint32_t len)
+	{
+		if(step == 0)
+			dwt53_lift_row_l(dest, a, b, len);
+		else
+			dwt53_lift_row_h(dest, a, b, len);
 	}
-	else
+	// a single H row is halved
+	static void single(int32_t* row, uint32_t len, uint32_t parity)
 	{
-		auto imageComponentFlow = scheduler_->getImageComponentFlow(compno_);
-		auto resFlow = imageComponentFlow->getResFlow(res - 1);
-		const uint32_t numTasks = resWidth < numThreads ? resWidth : numThreads;
-		uint32_t step = resWidth / numTasks;
-		for(uint32_t j = 0; j < numTasks; j++)
+		if(parity)
 		{
-			auto indexMin = j * step;
-			auto indexMax = j < (numTasks - 1U) ? (j + 1U) * step : resWidth;
-			auto vert = new dwt_data<int32_t>(vert_);
-			if(!vert->alloc(dataLength))
-			{
-				Logger::logger_.error("Out of memory");
-				delete vert;
-				return false;
-			}
-			resFlow->waveletVert_->nextTask().work(
-				[this, vert, indexMin, indexMax, winL, winH, winDest] {
-					decompress_v_strip_53(vert, indexMin, indexMax, winL, winH, winDest);
-					delete vert;
-				});
-			winL.incX_IN_PLACE(step);
-			winH.incX_IN_PLACE(step);
-			winDest.incX_IN_PLACE(step);
+			for(uint32_t k = 0; k < len; ++k)
+				row[k] >>= 1;
 		}
 	}
-	return true;
-}
+};
 /* <summary>                            */
 /* Inverse wavelet transform in 2-D.    */
 /* </summary>                           */
@@ -1183,17 +669,9 @@ bool WaveletReverse::decompress_tile_53(void)
 	auto tileCompRes = tilec_->resolutions_;
 	auto buf = tilec_->getWindow();
 	size_t dataLength = max_resolution(tileCompRes, numres_);
-	/* overflow check */
-	if(dataLength > (SIZE_MAX / PLL_COLS_53 / sizeof(int32_t)))
-	{
-		Logger::logger_.error("Overflow");
-		return false;
-	}
-	/* We need PLL_COLS_53 times the height of the array, */
-	/* since for the vertical pass */
-	/* we process PLL_COLS_53 columns at a time */
-	dataLength *= PLL_COLS_53 * sizeof(int32_t);
-	for(uint8_t res = 1; res < numres_; ++res)
+	uint32_t numThreads = (uint32_t)ExecSingleton::get()->num_workers();
+	tileCompRes += firstRes_ - 1;
+	for(uint8_t res = firstRes_; res < numres_; ++res)
 	{
 		horiz_.sn_full = tileCompRes->width();
 		vert_.sn_full = tileCompRes->height();
@@ -1206,10 +684,46 @@ bool WaveletReverse::decompress_tile_53(void)
 		horiz_.parity = tileCompRes->x0 & 1;
 		vert_.dn_full = resHeight - vert_.sn_full;
 		vert_.parity = tileCompRes->y0 & 1;
-		if(!decompress_h_53(res, buf, resHeight, dataLength))
-			return false;
-		if(!decompress_v_53(res, buf, resWidth, dataLength))
-			return false;
+		SplitRows<int32_t> rows(buf->getResWindowBufferSplitSimple(res, SPLIT_L),
+								buf->getResWindowBufferSplitSimple(res, SPLIT_H),
+								vert_.sn_full, vert_.dn_full, vert_.parity);
+		auto winDest = buf->getResWindowBufferSimple(res);
+		if(numThreads == 1)
+		{
+			if(!horiz_.mem)
+			{
+				if(!horiz_.alloc(dataLength))
+				{
+					Logger::logger_.error("Out of memory");
+					return false;
+				}
+				vert_.mem = horiz_.mem;
+			}
+			// fused pass: each row is transformed horizontally
+			// just before vertical lifting reaches it
+			auto winLL = buf->getResWindowBufferSimple(res - 1U);
+			auto winHL = buf->getBandWindowBufferPaddedSimple(res, BAND_ORIENT_HL);
+			auto winLH = buf->getBandWindowBufferPaddedSimple(res, BAND_ORIENT_LH);
+			auto winHH = buf->getBandWindowBufferPaddedSimple(res, BAND_ORIENT_HH);
+			liftRows<Lift53>(rows, resWidth, [&](uint32_t n) {
+				size_t y = rows.bandRow(n);
+				if(rows.isL(n))
+					decompress_h_53(&horiz_, winLL.buf_ + y * winLL.stride_,
+									winHL.buf_ + y * winHL.stride_, rows.row(n));
+				else
+					decompress_h_53(&horiz_, winLH.buf_ + y * winLH.stride_,
+									winHH.buf_ + y * winHH.stride_, rows.row(n));
+			});
+			interleaveRows(rows, winDest, resWidth, horiz_.mem);
+		}
+		else
+		{
+			if(!decompress_h_53(res, buf, resHeight, dataLength))
+				return false;
+			if(!decompress_v<Lift53>(res, numThreads, dataLength, rows, winDest, resWidth,
+									 scratch_))
+				return false;
+		}
 	}
 
 	return true;
@@ -1671,7 +1185,8 @@ class Partial97 : public PartialInterleaver<T, FILTER_WIDTH, VERT_PASS_WIDTH>
 // Notes:
 // 1. line buffer 0 offset == dwt->win_l.x0
 // 2. dwt->memL and dwt->memH are only set for partial decode
-Params97 WaveletReverse::makeParams97(dwt_data<vec4f>* dwt, bool isBandL, bool step1)
+template<typename T>
+Params97 WaveletReverse::makeParams97(dwt_data<T>* dwt, bool isBandL, bool step1)
 {
 	Params97 rc;
 	// band_0 specifies absolute start of line buffer
@@ -1686,19 +1201,21 @@ Params97 WaveletReverse::makeParams97(dwt_data<vec4f>* dwt, bool isBandL, bool s
 		lenMax = 0;
 	assert(lenMax >= band_0);
 	lenMax -= band_0;
-	rc.data = memPartial ? memPartial : dwt->mem;
+	T* data = memPartial ? memPartial : dwt->mem;
 
 	assert(!memPartial || (dwt->win_l.x1 <= dwt->sn_full && dwt->win_h.x1 <= dwt->dn_full));
 	assert(band_1 >= band_0);
 
-	rc.data += parityOffset + band_0 - dwt->win_l.x0;
+	data += parityOffset + band_0 - dwt->win_l.x0;
 	rc.len = (uint32_t)(band_1 - band_0);
+	rc.width = (uint32_t)T::NUM_ELTS;
 	if(!step1)
 	{
-		rc.data += 1;
-		rc.dataPrev = parityOffset ? rc.data - 2 : rc.data;
+		data += 1;
+		rc.dataPrev = (float*)(parityOffset ? data - 2 : data);
 		rc.lenMax = (uint32_t)lenMax;
 	}
+	rc.data = (float*)data;
 	if(memPartial)
 	{
 		assert((uint64_t)rc.data >= (uint64_t)dwt->allocatedMem);
@@ -2023,9 +1540,11 @@ bool WaveletReverse::decompress_partial_tile(ISparseCanvas* sa,
 	return true;
 }
 WaveletReverse::WaveletReverse(TileProcessor* tileProcessor, TileComponent* tilec, uint16_t compno,
-							   grk_rect32 unreducedWindow, uint8_t numres, uint8_t qmfbid)
+							   grk_rect32 unreducedWindow, uint8_t numres, uint8_t qmfbid,
+							   uint8_t firstRes)
 	: tileProcessor_(tileProcessor), scheduler_(tileProcessor->getScheduler()), tilec_(tilec),
-	  compno_(compno), unreducedWindow_(unreducedWindow), numres_(numres), qmfbid_(qmfbid)
+	  compno_(compno), unreducedWindow_(unreducedWindow), numres_(numres), qmfbid_(qmfbid),
+	  firstRes_(std::max<uint8_t>(firstRes, 1))
 {}
 WaveletReverse::~WaveletReverse(void)
 {
@@ -2034,6 +1553,32 @@ WaveletReverse::~WaveletReverse(void)
 	for(const auto& t : tasksF_)
 		delete t;
 }
+template<typename T>
+bool WaveletReverse::allocScratch(std::vector<dwt_data<T>>& scratch, size_t dataLength)
+{
+	if(!scratch.empty())
+		return true;
+	scratch.resize(ExecSingleton::get()->num_workers());
+	for(auto& s : scratch)
+	{
+		if(!s.alloc(dataLength))
+		{
+			Logger::logger_.error("Out of memory");
+			scratch.clear();
+			return false;
+		}
+	}
+
+	return true;
+}
+template<typename T>
+T* WaveletReverse::getScratch(std::vector<dwt_data<T>>& scratch)
+{
+	auto threadnum = ExecSingleton::get()->this_worker_id();
+	assert(threadnum >= 0 && (size_t)threadnum < scratch.size());
+
+	return scratch[(size_t)threadnum].mem;
+}
 bool WaveletReverse::decompress(void)
 {
 	if(qmfbid_ == 1)
@@ -2065,4 +1610,3 @@ bool WaveletReverse::decompress(void)
 }
 
 } // namespace grk
-#endif
@@ -27,6 +27,8 @@ namespace grk
 {
 
 typedef vec<float, 4> vec4f;
+// whole tile 9/7 element: one AVX-512 vector, or several narrower ones
+typedef vec<float, 16> vec16f;
 
 template<typename T, typename S>
 struct TaskInfo
@@ -129,49 +131,84 @@ struct dwt_data
 
 struct Params97
 {
-	Params97(void) : dataPrev(nullptr), data(nullptr), len(0), lenMax(0) {}
-	vec4f* dataPrev;
-	vec4f* data;
+	Params97(void) : dataPrev(nullptr), data(nullptr), len(0), lenMax(0), width(0) {}
+	float* dataPrev;
+	float* data;
 	uint32_t len;
 	uint32_t lenMax;
+	uint32_t width; // number of floats per element
+};
+
+/**
+ * Rows of a resolution split into L rows and H rows, addressed by
+ * their position n in the interleaved (reconstructed) order
+ */
+template<typename T>
+struct SplitRows
+{
+	SplitRows(grk_buf2d_simple<T> winL, grk_buf2d_simple<T> winH, uint32_t hL, uint32_t hH,
+			  uint32_t parity)
+		: winL_(winL), winH_(winH), hL_(hL), hH_(hH), parity_(parity)
+	{}
+	uint32_t total(void) const
+	{
+		return hL_ + hH_;
+	}
+	bool isL(uint32_t n) const
+	{
+		return (n & 1) == parity_;
+	}
+	// row index within its band
+	uint32_t bandRow(uint32_t n) const
+	{
+		return isL(n) ? (n - parity_) >> 1 : (n + parity_ - 1) >> 1;
+	}
+	T* row(uint32_t n) const
+	{
+		return isL(n) ? winL_.buf_ + (size_t)bandRow(n) * winL_.stride_
+					  : winH_.buf_ + (size_t)bandRow(n) * winH_.stride_;
+	}
+	void incX_IN_PLACE(size_t deltaX)
+	{
+		winL_.incX_IN_PLACE(deltaX);
+		winH_.incX_IN_PLACE(deltaX);
+	}
+	grk_buf2d_simple<T> winL_;
+	grk_buf2d_simple<T> winH_;
+	uint32_t hL_;
+	uint32_t hH_;
+	uint32_t parity_;
 };
 
 class WaveletReverse
 {
   public:
+	/**
+	 * @param firstRes first resolution to reconstruct. For whole tile decompression,
+	 * lower resolutions may already have been reconstructed in the tile component window.
+	 */
 	WaveletReverse(TileProcessor* tileProcessor, TileComponent* tilec, uint16_t compno,
-				   grk_rect32 window, uint8_t numres, uint8_t qmfbid);
+				   grk_rect32 window, uint8_t numres, uint8_t qmfbid, uint8_t firstRes);
 	~WaveletReverse(void);
 	bool decompress(void);
 
-	static void decompress_step_97(dwt_data<vec4f>* GRK_RESTRICT dwt);
+	template<typename T>
+	static void decompress_step_97(dwt_data<T>* GRK_RESTRICT dwt);
 
   private:
 	template<typename T, uint32_t FILTER_WIDTH, uint32_t VERT_PASS_WIDTH, typename D>
 	bool decompress_partial_tile(ISparseCanvas* sa, std::vector<TaskInfo<T, dwt_data<T>>*>& tasks);
-	static void decompress_step1_97(const Params97& d, const float c);
-#ifdef __SSE__
-	static void decompress_step1_sse_97(Params97 d, const __m128 c);
-#endif
-	static Params97 makeParams97(dwt_data<vec4f>* dwt, bool isBandL, bool step1);
-	void interleave_h_97(dwt_data<vec4f>* GRK_RESTRICT dwt, grk_buf2d_simple<float> winL,
+	template<typename T>
+	static Params97 makeParams97(dwt_data<T>* dwt, bool isBandL, bool step1);
+	void interleave_h_97(dwt_data<vec16f>* GRK_RESTRICT dwt, grk_buf2d_simple<float> winL,
 						 grk_buf2d_simple<float> winH, uint32_t remaining_height);
-	void decompress_h_strip_97(dwt_data<vec4f>* GRK_RESTRICT horiz, const uint32_t resHeight,
+	void decompress_h_strip_97(dwt_data<vec16f>* GRK_RESTRICT horiz, const uint32_t resHeight,
 							   grk_buf2d_simple<float> winL, grk_buf2d_simple<float> winH,
 							   grk_buf2d_simple<float> winDest);
 	bool decompress_h_97(uint8_t res, uint32_t numThreads, size_t dataLength,
-						 dwt_data<vec4f>& GRK_RESTRICT horiz, const uint32_t resHeight,
+						 dwt_data<vec16f>& GRK_RESTRICT horiz, const uint32_t resHeight,
 						 grk_buf2d_simple<float> winL, grk_buf2d_simple<float> winH,
 						 grk_buf2d_simple<float> winDest);
-	void interleave_v_97(dwt_data<vec4f>* GRK_RESTRICT dwt, grk_buf2d_simple<float> winL,
-						 grk_buf2d_simple<float> winH, uint32_t nb_elts_read);
-	void decompress_v_strip_97(dwt_data<vec4f>* GRK_RESTRICT vert, const uint32_t resWidth,
-							   const uint32_t resHeight, grk_buf2d_simple<float> winL,
-							   grk_buf2d_simple<float> winH, grk_buf2d_simple<float> winDest);
-	bool decompress_v_97(uint8_t res, uint32_t numThreads, size_t dataLength,
-						 dwt_data<vec4f>& GRK_RESTRICT vert, const uint32_t resWidth,
-						 const uint32_t resHeight, grk_buf2d_simple<float> winL,
-						 grk_buf2d_simple<float> winH, grk_buf2d_simple<float> winDest);
 	bool decompress_tile_97(void);
 	void decompress_h_parity_even_53(int32_t* buf, int32_t* bandL, /* even */
 									 const uint32_t wL, int32_t* bandH, const uint32_t wH,
@@ -179,30 +216,31 @@ class WaveletReverse
 	void decompress_h_parity_odd_53(int32_t* buf, int32_t* bandL, /* odd */
 									const uint32_t wL, int32_t* bandH, const uint32_t wH,
 									int32_t* dest);
-	void decompress_v_parity_even_53(int32_t* buf, int32_t* bandL, const uint32_t hL,
-									 const uint32_t strideL, int32_t* bandH, const uint32_t hH,
-									 const uint32_t strideH, int32_t* dest,
-									 const uint32_t strideDest);
-	void decompress_v_parity_odd_53(int32_t* buf, int32_t* bandL, const uint32_t hL,
-									const uint32_t strideL, int32_t* bandH, const uint32_t hH,
-									const uint32_t strideH, int32_t* dest,
-									const uint32_t strideDest);
 	void decompress_h_53(const dwt_data<int32_t>* dwt, int32_t* bandL, int32_t* bandH,
 						 int32_t* dest);
-	void decompress_v_53(const dwt_data<int32_t>* dwt, grk_buf2d_simple<int32_t> winL,
-						 grk_buf2d_simple<int32_t> winH, grk_buf2d_simple<int32_t> winDest,
-						 uint32_t nb_cols);
 	void decompress_h_strip_53(const dwt_data<int32_t>* horiz, uint32_t hMin, uint32_t hMax,
 							   grk_buf2d_simple<int32_t> winL, grk_buf2d_simple<int32_t> winH,
 							   grk_buf2d_simple<int32_t> winDest);
 	bool decompress_h_53(uint8_t res, TileComponentWindow<int32_t>* buf, uint32_t resHeight,
 						 size_t dataLength);
-	void decompress_v_strip_53(const dwt_data<int32_t>* vert, uint32_t wMin, uint32_t wMax,
-							   grk_buf2d_simple<int32_t> winL, grk_buf2d_simple<int32_t> winH,
-							   grk_buf2d_simple<int32_t> winDest);
-	bool decompress_v_53(uint8_t res, TileComponentWindow<int32_t>* buf, uint32_t resWidth,
-						 size_t dataLength);
 	bool decompress_tile_53(void);
+	/**
+	 * Line-based vertical pass, with one task per slab of columns
+	 */
+	template<typename LIFT, typename T, typename S>
+	bool decompress_v(uint8_t res, uint32_t numThreads, size_t dataLength, SplitRows<T> rows,
+					  grk_buf2d_simple<T> winDest, uint32_t resWidth,
+					  std::vector<dwt_data<S>>& scratch);
+	/**
+	 * Allocate one scratch buffer per worker, on first use only
+	 *
+	 * @param scratch per-worker scratch buffers
+	 * @param dataLength length of each buffer
+	 */
+	template<typename T>
+	bool allocScratch(std::vector<dwt_data<T>>& scratch, size_t dataLength);
+	template<typename T>
+	T* getScratch(std::vector<dwt_data<T>>& scratch);
 
 	TileProcessor* tileProcessor_;
 	Scheduler* scheduler_;
@@ -211,12 +249,17 @@ class WaveletReverse
 	grk_rect32 unreducedWindow_;
 	uint8_t numres_;
 	uint8_t qmfbid_;
+	uint8_t firstRes_;
 
 	dwt_data<int32_t> horiz_;
 	dwt_data<int32_t> vert_;
 
-	dwt_data<vec4f> horizF_;
-	dwt_data<vec4f> vertF_;
+	dwt_data<vec16f> horizF_;
+	dwt_data<vec16f> vertF_;
+
+	// per-worker scratch for multi-threaded horizontal and vertical passes
+	std::vector<dwt_data<int32_t>> scratch_;
+	std::vector<dwt_data<vec16f>> scratchF_;
 
 	std::vector<TaskInfo<vec4f, dwt_data<vec4f>>*> tasksF_;
 	std::vector<TaskInfo<int32_t, dwt_data<int32_t>>*> tasks_;
@@ -0,0 +1,194 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "GrkTestCodec.h"
+
+namespace grk
+{
+
+static void errorCallback(const char* msg, [[maybe_unused]] void* client_data)
+{
+	fprintf(stderr, "Error: %s\n", msg);
+}
+
+void initTestLibrary(void)
+{
+	grk_initialize(nullptr, 0, false);
+	grk_set_msg_handlers(nullptr, nullptr, nullptr, nullptr, errorCallback, nullptr);
+}
+
+grk_image* createTestImage(uint32_t width, uint32_t height, uint16_t numComps, uint8_t prec)
+{
+	auto compParams = new grk_image_comp[numComps];
+	memset(compParams, 0, numComps * sizeof(grk_image_comp));
+	for(uint16_t compno = 0; compno < numComps; ++compno)
+	{
+		auto c = compParams + compno;
+		c->w = width;
+		c->h = height;
+		c->dx = 1;
+		c->dy = 1;
+		c->prec = prec;
+		c->sgnd = false;
+	}
+	auto colourSpace = numComps == 3 ? GRK_CLRSPC_SRGB : GRK_CLRSPC_GRAY;
+	auto image = grk_image_new(numComps, compParams, colourSpace, true);
+	delete[] compParams;
+	if(!image)
+		return nullptr;
+	int32_t maxVal = (int32_t)((1U << prec) - 1);
+	for(uint16_t compno = 0; compno < numComps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		for(uint32_t j = 0; j < comp->h; ++j)
+		{
+			auto row = comp->data + (size_t)j * comp->stride;
+			for(uint32_t i = 0; i < comp->w; ++i)
+				row[i] = (int32_t)((i * 3 + j * 5 + compno * 31 + ((i * j) >> 4)) % (maxVal + 1));
+		}
+	}
+
+	return image;
+}
+
+bool compressToBuffer(grk_cparameters* parameters, grk_image* image,
+					  std::vector<uint8_t>& codeStream)
+{
+	grk_stream_params streamParams;
+	memset(&streamParams, 0, sizeof(streamParams));
+	size_t len = 1024;
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+		len += (size_t)image->comps[compno].w * image->comps[compno].h * sizeof(int32_t);
+	codeStream.resize(len);
+	streamParams.buf = codeStream.data();
+	streamParams.len = len;
+	auto codec = grk_compress_init(&streamParams, parameters, image);
+	if(!codec)
+	{
+		fprintf(stderr, "Failed to initialize compressor\n");
+		return false;
+	}
+	uint64_t compressedLength = grk_compress(codec, nullptr);
+	grk_object_unref(codec);
+	if(!compressedLength)
+	{
+		fprintf(stderr, "Failed to compress\n");
+		return false;
+	}
+	codeStream.resize(compressedLength);
+
+	return true;
+}
+
+grk_codec* initDecompressor(std::vector<uint8_t>& codeStream, grk_decompress_core_params* core,
+							grk_header_info* headerInfo)
+{
+	grk_stream_params streamParams;
+	memset(&streamParams, 0, sizeof(streamParams));
+	streamParams.buf = codeStream.data();
+	streamParams.len = codeStream.size();
+	auto codec = grk_decompress_init(&streamParams, core);
+	if(!codec)
+	{
+		fprintf(stderr, "Failed to initialize decompressor\n");
+		return nullptr;
+	}
+	memset(headerInfo, 0, sizeof(grk_header_info));
+	if(!grk_decompress_read_header(codec, headerInfo))
+	{
+		fprintf(stderr, "Failed to read header\n");
+		grk_object_unref(codec);
+		return nullptr;
+	}
+
+	return codec;
+}
+
+bool compareToReference(grk_image* reference, grk_image* image)
+{
+	if(!image || image->numcomps != reference->numcomps)
+	{
+		fprintf(stderr, "Decompressed image does not match reference components\n");
+		return false;
+	}
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		auto refComp = reference->comps + compno;
+		if(!comp->data || comp->x0 + comp->w > refComp->w || comp->y0 + comp->h > refComp->h)
+		{
+			fprintf(stderr, "Component %u has no data or invalid bounds\n", compno);
+			return false;
+		}
+		for(uint32_t j = 0; j < comp->h; ++j)
+		{
+			auto row = comp->data + (size_t)j * comp->stride;
+			auto refRow = refComp->data + (size_t)(comp->y0 + j) * refComp->stride + comp->x0;
+			if(memcmp(row, refRow, comp->w * sizeof(int32_t)) != 0)
+			{
+				fprintf(stderr, "Component %u differs from reference at row %u\n", compno,
+						comp->y0 + j);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool compareImages(grk_image* reference, grk_image* image)
+{
+	if(!reference || !image || image->numcomps != reference->numcomps)
+	{
+		fprintf(stderr, "Images have different number of components\n");
+		return false;
+	}
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		auto refComp = reference->comps + compno;
+		if(comp->x0 != refComp->x0 || comp->y0 != refComp->y0 || comp->w != refComp->w ||
+		   comp->h != refComp->h)
+		{
+			fprintf(stderr, "Component %u bounds (%u,%u,%u,%u) differ from (%u,%u,%u,%u)\n",
+					compno, comp->x0, comp->y0, comp->w, comp->h, refComp->x0, refComp->y0,
+					refComp->w, refComp->h);
+			return false;
+		}
+		if(!comp->data || !refComp->data)
+		{
+			fprintf(stderr, "Component %u has no data\n", compno);
+			return false;
+		}
+		for(uint32_t j = 0; j < comp->h; ++j)
+		{
+			auto row = comp->data + (size_t)j * comp->stride;
+			auto refRow = refComp->data + (size_t)j * refComp->stride;
+			if(memcmp(row, refRow, comp->w * sizeof(int32_t)) != 0)
+			{
+				fprintf(stderr, "Component %u differs at row %u\n", compno, j);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+} // namespace grk
@@ -0,0 +1,84 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "grok.h"
+
+namespace grk
+{
+
+/**
+ * Initialize library for a test, with error messages sent to stderr
+ */
+void initTestLibrary(void);
+/**
+ * Create unsigned image filled with a test pattern
+ *
+ * @param width image width
+ * @param height image height
+ * @param numComps number of components
+ * @param prec component precision
+ *
+ * @return new image, or nullptr on failure
+ */
+grk_image* createTestImage(uint32_t width, uint32_t height, uint16_t numComps, uint8_t prec);
+/**
+ * Compress image to J2K code stream in memory.
+ * Image data is consumed by the compressor.
+ *
+ * @param parameters compress parameters
+ * @param image image to compress
+ * @param codeStream buffer for code stream
+ *
+ * @return true if successful
+ */
+bool compressToBuffer(grk_cparameters* parameters, grk_image* image,
+					  std::vector<uint8_t>& codeStream);
+/**
+ * Initialize decompressor for code stream in memory, and read header
+ *
+ * @param codeStream code stream
+ * @param core decompress core parameters
+ * @param headerInfo header info
+ *
+ * @return decompressor, or nullptr on failure
+ */
+grk_codec* initDecompressor(std::vector<uint8_t>& codeStream, grk_decompress_core_params* core,
+							grk_header_info* headerInfo);
+/**
+ * Compare decompressed image with the region of the reference image that it covers
+ *
+ * @param reference reference image
+ * @param image decompressed image, at full resolution
+ *
+ * @return true if image matches reference
+ */
+bool compareToReference(grk_image* reference, grk_image* image);
+/**
+ * Compare two decompressed images
+ *
+ * @param reference reference image
+ * @param image image to compare with reference
+ *
+ * @return true if images have the same component bounds and data
+ */
+bool compareImages(grk_image* reference, grk_image* image);
+
+} // namespace grk
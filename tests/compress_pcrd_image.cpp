@@ -0,0 +1,274 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compare image-wide PCRD-opt rate control (GRK_RATE_CONTROL_PCRD_OPT_IMAGE) with
+ * per tile PCRD-opt (GRK_RATE_CONTROL_PCRD_OPT) :
+ *
+ * 1. for a tiled image where half of the tiles are flat, image-wide rate control must
+ *    stay within the byte budget, and give lower distortion than per tile rate control
+ * 2. for a single tile image, both must produce the same code stream
+ * 3. when rows are pushed, image-wide rate control falls back to per tile rate control,
+ *    so both must produce the same code stream
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "GrkTestCodec.h"
+
+const uint32_t imageWidth = 512;
+const uint32_t imageHeight = 384;
+const uint16_t imageComps = 3;
+const double compressionRatio = 20.0;
+
+/**
+ * Create test image where every tile in the left half of the image is flat
+ */
+static grk_image* createImage(uint32_t tileSize)
+{
+	auto image = grk::createTestImage(imageWidth, imageHeight, imageComps, 8);
+	if(!image || !tileSize)
+		return image;
+	uint32_t flatWidth = (imageWidth / tileSize / 2) * tileSize;
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		for(uint32_t j = 0; j < comp->h; ++j)
+		{
+			auto row = comp->data + (size_t)j * comp->stride;
+			for(uint32_t i = 0; i < flatWidth; ++i)
+				row[i] = 128;
+		}
+	}
+
+	return image;
+}
+
+static void setParameters(GRK_RATE_CONTROL_ALGORITHM algorithm, uint32_t tileSize,
+						  grk_cparameters* parameters)
+{
+	grk_compress_set_default_params(parameters);
+	parameters->cod_format = GRK_FMT_J2K;
+	parameters->irreversible = true;
+	parameters->numlayers = 1;
+	parameters->layer_rate[0] = compressionRatio;
+	parameters->allocationByRateDistoration = true;
+	parameters->rateControlAlgorithm = algorithm;
+	if(tileSize)
+	{
+		parameters->tile_size_on = true;
+		parameters->t_width = tileSize;
+		parameters->t_height = tileSize;
+	}
+}
+
+static bool compress(GRK_RATE_CONTROL_ALGORITHM algorithm, uint32_t tileSize,
+					 std::vector<uint8_t>& codeStream)
+{
+	grk_cparameters parameters;
+	setParameters(algorithm, tileSize, &parameters);
+	auto image = createImage(tileSize);
+	if(!image)
+		return false;
+	bool rc = grk::compressToBuffer(&parameters, image, codeStream);
+	grk_object_unref(&image->obj);
+
+	return rc;
+}
+
+/**
+ * Compress by pushing all rows of the image at once
+ */
+static bool compressPushedRows(GRK_RATE_CONTROL_ALGORITHM algorithm, uint32_t tileSize,
+							   std::vector<uint8_t>& codeStream)
+{
+	bool rc = false;
+	grk_cparameters parameters;
+	grk_stream_params streamParams;
+	grk_codec* codec = nullptr;
+	grk_image* image = nullptr;
+	uint64_t compressedLength = 0;
+	std::vector<const int32_t*> rows(imageComps);
+	auto reference = createImage(tileSize);
+	if(!reference)
+		goto cleanup;
+	image = grk_image_new(reference->numcomps, reference->comps, reference->color_space, false);
+	if(!image)
+		goto cleanup;
+	setParameters(algorithm, tileSize, &parameters);
+	memset(&streamParams, 0, sizeof(streamParams));
+	codeStream.resize((size_t)imageWidth * imageHeight * imageComps + 1024);
+	streamParams.buf = codeStream.data();
+	streamParams.len = codeStream.size();
+	codec = grk_compress_init(&streamParams, &parameters, image);
+	if(!codec)
+		goto cleanup;
+	for(uint16_t compno = 0; compno < imageComps; ++compno)
+		rows[compno] = reference->comps[compno].data;
+	if(!grk_compress_push_rows(codec, rows.data(), reference->comps->stride, imageHeight))
+		goto cleanup;
+	compressedLength = grk_compress(codec, nullptr);
+	if(!compressedLength)
+		goto cleanup;
+	codeStream.resize(compressedLength);
+	rc = true;
+cleanup:
+	grk_object_unref(codec);
+	if(image)
+		grk_object_unref(&image->obj);
+	if(reference)
+		grk_object_unref(&reference->obj);
+
+	return rc;
+}
+
+/**
+ * Decompress code stream and calculate its mean squared error over all components
+ *
+ * @return mean squared error, or a negative number on failure
+ */
+static double meanSquaredError(std::vector<uint8_t>& codeStream, uint32_t tileSize)
+{
+	double mse = -1;
+	grk_codec* codec = nullptr;
+	grk_header_info headerInfo;
+	grk_decompress_parameters parameters;
+	grk_image* image = nullptr;
+	double sum = 0;
+	auto reference = createImage(tileSize);
+	if(!reference)
+		goto cleanup;
+	grk_decompress_set_default_params(&parameters);
+	codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec || !grk_decompress(codec, nullptr))
+		goto cleanup;
+	image = grk_decompress_get_composited_image(codec);
+	for(uint16_t compno = 0; compno < reference->numcomps; ++compno)
+	{
+		auto refComp = reference->comps + compno;
+		auto comp = image->comps + compno;
+		for(uint32_t j = 0; j < refComp->h; ++j)
+		{
+			auto refRow = refComp->data + (size_t)j * refComp->stride;
+			auto row = comp->data + (size_t)j * comp->stride;
+			for(uint32_t i = 0; i < refComp->w; ++i)
+			{
+				double diff = row[i] - refRow[i];
+				sum += diff * diff;
+			}
+		}
+	}
+	mse = sum / ((double)imageWidth * imageHeight * imageComps);
+cleanup:
+	grk_object_unref(codec);
+	if(reference)
+		grk_object_unref(&reference->obj);
+
+	return mse;
+}
+
+static bool testTiles(void)
+{
+	const uint32_t tileSize = 128;
+	std::vector<uint8_t> perTile;
+	std::vector<uint8_t> imageWide;
+	if(!compress(GRK_RATE_CONTROL_PCRD_OPT, tileSize, perTile) ||
+	   !compress(GRK_RATE_CONTROL_PCRD_OPT_IMAGE, tileSize, imageWide))
+	{
+		fprintf(stderr, "tiles : failed to compress\n");
+		return false;
+	}
+	auto budget = (uint64_t)((double)imageWidth * imageHeight * imageComps / compressionRatio);
+	if(imageWide.size() > budget)
+	{
+		fprintf(stderr, "tiles : code stream length %zu exceeds budget %lu\n", imageWide.size(),
+				(unsigned long)budget);
+		return false;
+	}
+	double msePerTile = meanSquaredError(perTile, tileSize);
+	double mseImageWide = meanSquaredError(imageWide, tileSize);
+	if(msePerTile < 0 || mseImageWide < 0)
+	{
+		fprintf(stderr, "tiles : failed to decompress\n");
+		return false;
+	}
+	if(mseImageWide >= msePerTile)
+	{
+		fprintf(stderr, "tiles : image-wide MSE %f is not lower than per tile MSE %f\n",
+				mseImageWide, msePerTile);
+		return false;
+	}
+
+	return true;
+}
+
+static bool testSingleTile(void)
+{
+	std::vector<uint8_t> perTile;
+	std::vector<uint8_t> imageWide;
+	if(!compress(GRK_RATE_CONTROL_PCRD_OPT, 0, perTile) ||
+	   !compress(GRK_RATE_CONTROL_PCRD_OPT_IMAGE, 0, imageWide))
+	{
+		fprintf(stderr, "single tile : failed to compress\n");
+		return false;
+	}
+	if(perTile != imageWide)
+	{
+		fprintf(stderr, "single tile : code streams differ\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool testPushedRows(void)
+{
+	const uint32_t tileSize = 128;
+	std::vector<uint8_t> perTile;
+	std::vector<uint8_t> imageWide;
+	if(!compressPushedRows(GRK_RATE_CONTROL_PCRD_OPT, tileSize, perTile) ||
+	   !compressPushedRows(GRK_RATE_CONTROL_PCRD_OPT_IMAGE, tileSize, imageWide))
+	{
+		fprintf(stderr, "pushed rows : failed to compress\n");
+		return false;
+	}
+	if(perTile != imageWide)
+	{
+		fprintf(stderr, "pushed rows : code streams differ\n");
+		return false;
+	}
+
+	return true;
+}
+
+int main(void)
+{
+	int rc = EXIT_SUCCESS;
+
+	grk::initTestLibrary();
+	if(!testTiles())
+		rc = EXIT_FAILURE;
+	if(!testSingleTile())
+		rc = EXIT_FAILURE;
+	if(!testPushedRows())
+		rc = EXIT_FAILURE;
+	grk_deinitialize();
+
+	return rc;
+}
@@ -0,0 +1,205 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compress an image by pushing its rows with grk_compress_push_rows, and check
+ * that the code stream is identical to the one produced from the whole image,
+ * and that it decompresses to the original image.
+ * Rows are pushed in chunks that do not line up with tile or code block rows.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "GrkTestCodec.h"
+
+struct PushConfig
+{
+	const char* name;
+	uint16_t numComps;
+	uint32_t tileWidth;
+	uint32_t tileHeight;
+	bool irreversible;
+};
+
+/**
+ * Create image with the same components as reference, but without component data
+ */
+static grk_image* createHeaderImage(grk_image* reference)
+{
+	auto compParams = new grk_image_comp[reference->numcomps];
+	memset(compParams, 0, reference->numcomps * sizeof(grk_image_comp));
+	for(uint16_t compno = 0; compno < reference->numcomps; ++compno)
+	{
+		auto c = compParams + compno;
+		auto refComp = reference->comps + compno;
+		c->w = refComp->w;
+		c->h = refComp->h;
+		c->dx = refComp->dx;
+		c->dy = refComp->dy;
+		c->prec = refComp->prec;
+		c->sgnd = refComp->sgnd;
+	}
+	auto image = grk_image_new(reference->numcomps, compParams, reference->color_space, false);
+	delete[] compParams;
+
+	return image;
+}
+
+static void setParameters(const PushConfig& config, grk_cparameters* parameters)
+{
+	grk_compress_set_default_params(parameters);
+	parameters->cod_format = GRK_FMT_J2K;
+	parameters->irreversible = config.irreversible;
+	if(config.tileWidth)
+	{
+		parameters->tile_size_on = true;
+		parameters->t_width = config.tileWidth;
+		parameters->t_height = config.tileHeight;
+	}
+}
+
+static bool pushRows(const PushConfig& config, grk_image* reference,
+					 std::vector<uint8_t>& codeStream)
+{
+	bool rc = false;
+	grk_cparameters parameters;
+	grk_stream_params streamParams;
+	grk_codec* codec = nullptr;
+	uint64_t compressedLength = 0;
+	const uint32_t chunk = 37;
+	uint32_t height = reference->comps->h;
+	std::vector<const int32_t*> rows(reference->numcomps);
+	auto image = createHeaderImage(reference);
+	if(!image)
+		goto cleanup;
+	setParameters(config, &parameters);
+	memset(&streamParams, 0, sizeof(streamParams));
+	codeStream.resize((size_t)reference->comps->w * height * reference->numcomps * 4 + 1024);
+	streamParams.buf = codeStream.data();
+	streamParams.len = codeStream.size();
+	codec = grk_compress_init(&streamParams, &parameters, image);
+	if(!codec)
+	{
+		fprintf(stderr, "%s : failed to initialize compressor\n", config.name);
+		goto cleanup;
+	}
+	for(uint32_t y = 0; y < height; y += chunk)
+	{
+		for(uint16_t compno = 0; compno < reference->numcomps; ++compno)
+		{
+			auto comp = reference->comps + compno;
+			rows[compno] = comp->data + (size_t)y * comp->stride;
+		}
+		uint32_t numRows = std::min<uint32_t>(chunk, height - y);
+		if(!grk_compress_push_rows(codec, rows.data(), reference->comps->stride, numRows))
+		{
+			fprintf(stderr, "%s : failed to push rows %u to %u\n", config.name, y, y + numRows);
+			goto cleanup;
+		}
+	}
+	compressedLength = grk_compress(codec, nullptr);
+	if(!compressedLength)
+	{
+		fprintf(stderr, "%s : failed to compress pushed rows\n", config.name);
+		goto cleanup;
+	}
+	codeStream.resize(compressedLength);
+	rc = true;
+cleanup:
+	grk_object_unref(codec);
+	if(image)
+		grk_object_unref(&image->obj);
+
+	return rc;
+}
+
+static bool testPushRows(const PushConfig& config)
+{
+	bool rc = false;
+	grk_codec* codec = nullptr;
+	grk_image* image = nullptr;
+	grk_image* reference = nullptr;
+	grk_header_info headerInfo;
+	grk_decompress_parameters parameters;
+	grk_cparameters compressParameters;
+	std::vector<uint8_t> codeStream;
+	std::vector<uint8_t> pushedCodeStream;
+
+	image = grk::createTestImage(331, 257, config.numComps, 8);
+	reference = grk::createTestImage(331, 257, config.numComps, 8);
+	if(!image || !reference)
+		goto cleanup;
+	setParameters(config, &compressParameters);
+	if(!grk::compressToBuffer(&compressParameters, image, codeStream))
+		goto cleanup;
+	if(!pushRows(config, reference, pushedCodeStream))
+		goto cleanup;
+	if(pushedCodeStream != codeStream)
+	{
+		fprintf(stderr, "%s : code stream from pushed rows differs\n", config.name);
+		goto cleanup;
+	}
+	if(config.irreversible)
+	{
+		rc = true;
+		goto cleanup;
+	}
+	grk_decompress_set_default_params(&parameters);
+	codec = grk::initDecompressor(pushedCodeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		goto cleanup;
+	if(!grk_decompress(codec, nullptr))
+	{
+		fprintf(stderr, "%s : failed to decompress\n", config.name);
+		goto cleanup;
+	}
+	rc = grk::compareToReference(reference, grk_decompress_get_composited_image(codec));
+	if(!rc)
+		fprintf(stderr, "%s : decompressed image differs\n", config.name);
+cleanup:
+	grk_object_unref(codec);
+	if(image)
+		grk_object_unref(&image->obj);
+	if(reference)
+		grk_object_unref(&reference->obj);
+
+	return rc;
+}
+
+int main(void)
+{
+	const PushConfig configs[] = {
+		{"single tile", 3, 0, 0, false},
+		{"tiles", 3, 128, 96, false},
+		{"grey tiles", 1, 100, 64, false},
+		{"irreversible tiles", 3, 128, 96, true},
+	};
+	int rc = EXIT_SUCCESS;
+
+	grk::initTestLibrary();
+	for(const auto& config : configs)
+	{
+		if(!testPushRows(config))
+			rc = EXIT_FAILURE;
+	}
+	grk_deinitialize();
+
+	return rc;
+}
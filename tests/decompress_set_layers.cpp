@@ -0,0 +1,125 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Decompress an image repeatedly with the same codec, changing the number of layers
+ * between calls. Tiles retain their parsed packets, and code blocks resume T1 decoding
+ * from the coding passes of the previous decompress. Each result must match
+ * a decompress with a fresh codec.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "GrkTestCodec.h"
+
+static bool decompressWithFreshCodec(std::vector<uint8_t>& codeStream, uint16_t layers,
+									 grk_image* image)
+{
+	grk_decompress_parameters parameters;
+	grk_header_info headerInfo;
+	grk_decompress_set_default_params(&parameters);
+	parameters.core.layers_to_decompress_ = layers;
+	auto codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		return false;
+	bool rc = grk_decompress(codec, nullptr) &&
+			  grk::compareImages(grk_decompress_get_composited_image(codec), image);
+	grk_object_unref(codec);
+
+	return rc;
+}
+
+static bool testLayers(uint8_t cblkSty, bool tiled)
+{
+	bool rc = false;
+	grk_codec* codec = nullptr;
+	grk_image* image = grk::createTestImage(128, 128, 3, 8);
+	grk_header_info headerInfo;
+	grk_decompress_parameters parameters;
+	grk_cparameters compressParameters;
+	std::vector<uint8_t> codeStream;
+	const uint16_t layers[] = {1, 2, 3, 1, 3, 2};
+
+	if(!image)
+		return false;
+	grk_compress_set_default_params(&compressParameters);
+	compressParameters.cod_format = GRK_FMT_J2K;
+	compressParameters.cblk_sty = cblkSty;
+	compressParameters.tile_size_on = tiled;
+	compressParameters.t_width = 64;
+	compressParameters.t_height = 64;
+	compressParameters.numresolution = 3;
+	compressParameters.numlayers = 3;
+	compressParameters.allocationByRateDistoration = true;
+	compressParameters.layer_rate[0] = 40;
+	compressParameters.layer_rate[1] = 10;
+	compressParameters.layer_rate[2] = 0;
+	if(!grk::compressToBuffer(&compressParameters, image, codeStream))
+		goto cleanup;
+
+	grk_decompress_set_default_params(&parameters);
+	parameters.core.tileCacheStrategy = GRK_TILE_CACHE_LRU;
+	parameters.core.codeblockCacheMaxBytes = 64 * 1024 * 1024;
+	parameters.core.layers_to_decompress_ = layers[0];
+	codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		goto cleanup;
+	for(size_t i = 0; i < sizeof(layers) / sizeof(layers[0]); ++i)
+	{
+		if((i > 0 && !grk_decompress_set_layers(codec, layers[i])) ||
+		   !grk_decompress(codec, nullptr))
+		{
+			fprintf(stderr, "Failed to decompress %u layers\n", layers[i]);
+			goto cleanup;
+		}
+		if(!decompressWithFreshCodec(codeStream, layers[i],
+									 grk_decompress_get_composited_image(codec)))
+		{
+			fprintf(stderr, "Code block style 0x%x, %s: %u layers differ from fresh codec\n",
+					cblkSty, tiled ? "tiled" : "single tile", layers[i]);
+			goto cleanup;
+		}
+	}
+	rc = true;
+cleanup:
+	grk_object_unref(codec);
+	grk_object_unref(&image->obj);
+
+	return rc;
+}
+
+int main(void)
+{
+	const uint8_t styles[] = {0, GRK_CBLKSTY_TERMALL, GRK_CBLKSTY_LAZY,
+							  GRK_CBLKSTY_LAZY | GRK_CBLKSTY_RESET | GRK_CBLKSTY_SEGSYM,
+							  GRK_CBLKSTY_HT};
+	int rc = EXIT_SUCCESS;
+
+	grk::initTestLibrary();
+	for(auto style : styles)
+	{
+		for(auto tiled : {false, true})
+		{
+			if(!testLayers(style, tiled))
+				rc = EXIT_FAILURE;
+		}
+	}
+	grk_deinitialize();
+
+	return rc;
+}
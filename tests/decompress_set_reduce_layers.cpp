@@ -0,0 +1,163 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Decompress a multi-tile image repeatedly with the same codec, changing window, reduce
+ * and layers between calls. Each result must match a decompress with a fresh codec,
+ * and the tile cache must re-use only those tile images that were decompressed
+ * with the same parameters.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "GrkTestCodec.h"
+
+static bool checkStats(grk_codec* codec, uint64_t hits, uint64_t misses)
+{
+	grk_tile_cache_stats stats;
+	if(!grk_decompress_get_tile_cache_stats(codec, &stats))
+	{
+		fprintf(stderr, "Failed to get tile cache stats\n");
+		return false;
+	}
+	if(stats.hits != hits || stats.misses != misses)
+	{
+		fprintf(stderr, "Tile cache stats: hits=%llu misses=%llu; expected hits=%llu misses=%llu\n",
+				(unsigned long long)stats.hits, (unsigned long long)stats.misses,
+				(unsigned long long)hits, (unsigned long long)misses);
+		return false;
+	}
+
+	return true;
+}
+
+static bool decompress(grk_codec* codec)
+{
+	if(!grk_decompress(codec, nullptr))
+	{
+		fprintf(stderr, "Failed to decompress\n");
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Decompress with a fresh codec, and compare with image decompressed by re-used codec
+ */
+static bool compareWithFreshCodec(std::vector<uint8_t>& codeStream, uint8_t reduce,
+								  uint16_t layers, grk_image* image)
+{
+	grk_decompress_parameters parameters;
+	grk_header_info headerInfo;
+	grk_decompress_set_default_params(&parameters);
+	parameters.core.reduce = reduce;
+	parameters.core.layers_to_decompress_ = layers;
+	auto codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		return false;
+	bool rc = decompress(codec) &&
+			  grk::compareImages(grk_decompress_get_composited_image(codec), image);
+	grk_object_unref(codec);
+
+	return rc;
+}
+
+int main(void)
+{
+	int rc = EXIT_FAILURE;
+	grk_codec* codec = nullptr;
+	grk_image* image = nullptr;
+	grk_header_info headerInfo;
+	grk_decompress_parameters parameters;
+	grk_cparameters compressParameters;
+	std::vector<uint8_t> codeStream;
+
+	grk::initTestLibrary();
+	image = grk::createTestImage(256, 192, 3, 8);
+	if(!image)
+		goto cleanup;
+	grk_compress_set_default_params(&compressParameters);
+	compressParameters.cod_format = GRK_FMT_J2K;
+	compressParameters.tile_size_on = true;
+	compressParameters.t_width = 64;
+	compressParameters.t_height = 64;
+	compressParameters.numresolution = 4;
+	compressParameters.numlayers = 3;
+	compressParameters.allocationByRateDistoration = true;
+	compressParameters.layer_rate[0] = 40;
+	compressParameters.layer_rate[1] = 10;
+	compressParameters.layer_rate[2] = 0;
+	if(!grk::compressToBuffer(&compressParameters, image, codeStream))
+		goto cleanup;
+	grk_object_unref(&image->obj);
+	image = grk::createTestImage(256, 192, 3, 8);
+	if(!image)
+		goto cleanup;
+
+	grk_decompress_set_default_params(&parameters);
+	parameters.core.tileCacheStrategy = GRK_TILE_CACHE_LRU;
+	codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		goto cleanup;
+
+	// 1. whole image : all 12 tiles are decompressed
+	if(!decompress(codec) ||
+	   !grk::compareToReference(image, grk_decompress_get_composited_image(codec)) ||
+	   !checkStats(codec, 0, 12))
+		goto cleanup;
+
+	// 2. window covering two whole tiles : both are served from the cache
+	if(!grk_decompress_set_window(codec, 64, 64, 192, 128) || !decompress(codec) ||
+	   !grk::compareToReference(image, grk_decompress_get_composited_image(codec)) ||
+	   !checkStats(codec, 2, 12))
+		goto cleanup;
+
+	// 3. window covering parts of six tiles : none are served from the cache
+	if(!grk_decompress_set_window(codec, 32, 32, 160, 96) || !decompress(codec) ||
+	   !grk::compareToReference(image, grk_decompress_get_composited_image(codec)) ||
+	   !checkStats(codec, 2, 18))
+		goto cleanup;
+
+	// 4. reduce : cached tile images at full resolution are discarded
+	if(!grk_decompress_set_reduce(codec, 1) || !decompress(codec) ||
+	   !compareWithFreshCodec(codeStream, 1, 0, grk_decompress_get_composited_image(codec)) ||
+	   !checkStats(codec, 2, 30))
+		goto cleanup;
+
+	// 5. fewer layers at full resolution
+	if(!grk_decompress_set_reduce(codec, 0) || !grk_decompress_set_layers(codec, 1) ||
+	   !decompress(codec) ||
+	   !compareWithFreshCodec(codeStream, 0, 1, grk_decompress_get_composited_image(codec)) ||
+	   !checkStats(codec, 2, 42))
+		goto cleanup;
+
+	// 6. window over same layers : tiles decompressed in step 5 are re-used
+	if(!grk_decompress_set_window(codec, 0, 0, 128, 64) || !decompress(codec) ||
+	   !checkStats(codec, 4, 42))
+		goto cleanup;
+
+	rc = EXIT_SUCCESS;
+cleanup:
+	grk_object_unref(codec);
+	if(image)
+		grk_object_unref(&image->obj);
+	grk_deinitialize();
+
+	return rc;
+}
@@ -0,0 +1,130 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compare the vectorized interleavers for 8, 10, 12 and 16 bit output with the
+ * scalar packers, for one to four planes, odd widths and strides, and each
+ * Highway target supported by this CPU.
+ * The vectorized interleavers are internal to the core library, so this test
+ * is only built when linking against the static library.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <hwy/targets.h>
+
+#include "packer.h"
+#include "util/Interleaver.h"
+
+static bool compare(uint8_t packer, uint32_t numPlanes, uint32_t width, std::mt19937& gen)
+{
+	const uint32_t h = 3;
+	// odd stride, so that rows are not aligned
+	const uint32_t srcStride = width + 5;
+	const uint8_t prec = packer == grk::packer16BitBE ? 16 : packer;
+	const int32_t adjust = 1 << (prec - 1);
+	uint64_t packedBytes =
+		grk::PlanarToInterleaved<int32_t>::getPackedBytes((uint16_t)numPlanes, width, prec);
+	// padding after each row catches writes past the end of the row
+	const uint64_t destStride = packedBytes + 7;
+	// signed samples, which are shifted to unsigned by adjust
+	std::uniform_int_distribution<int32_t> dist(-adjust, adjust - 1);
+	std::vector<int32_t> planes[4];
+	for(uint32_t k = 0; k < numPlanes; ++k)
+	{
+		planes[k].resize((size_t)srcStride * h);
+		for(auto& v : planes[k])
+			v = dist(gen);
+	}
+	std::vector<uint8_t> expected(destStride * h, 0xA5);
+	std::vector<uint8_t> actual(destStride * h, 0xA5);
+
+	// interleavers advance the plane pointers
+	int32_t* src[4];
+	for(uint32_t k = 0; k < numPlanes; ++k)
+		src[k] = planes[k].data();
+	std::unique_ptr<grk::PlanarToInterleaved<int32_t>> scalar(
+		grk::InterleaverFactory<int32_t>::makeInterleaver(packer));
+	scalar->interleave(src, numPlanes, expected.data(), width, srcStride, destStride, h, adjust);
+
+	for(uint32_t k = 0; k < numPlanes; ++k)
+		src[k] = planes[k].data();
+	grk::InterleaverHwy vectorized(packer);
+	vectorized.interleave(src, numPlanes, actual.data(), width, srcStride, destStride, h, adjust);
+
+	for(uint64_t i = 0; i < expected.size(); ++i)
+	{
+		if(expected[i] != actual[i])
+		{
+			fprintf(stderr,
+					"Mismatch : packer %u, %u planes, width %u, row %u, byte %u : "
+					"expected 0x%02x, actual 0x%02x\n",
+					packer, numPlanes, width, (uint32_t)(i / destStride),
+					(uint32_t)(i % destStride), expected[i], actual[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main(void)
+{
+	const uint8_t packers[] = {8, 10, 12, 16, grk::packer16BitBE};
+	// widths around vector and packing block sizes, with tails
+	const uint32_t widths[] = {1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 31, 33, 63, 65, 127, 257, 1001};
+	std::mt19937 gen(42);
+	int rc = EXIT_SUCCESS;
+	uint32_t numTargets = 0;
+
+	auto targets = hwy::SupportedTargets();
+	for(int64_t target = 1; target != 0 && target <= targets; target <<= 1)
+	{
+		if(!(targets & target))
+			continue;
+		hwy::SetSupportedTargetsForTest(target);
+		numTargets++;
+		for(auto packer : packers)
+		{
+			if(!grk::InterleaverHwy::isSupported(packer, 1))
+			{
+				fprintf(stderr, "No vectorized interleaver for packer %u\n", packer);
+				rc = EXIT_FAILURE;
+				continue;
+			}
+			for(uint32_t numPlanes = 1; numPlanes <= 4; ++numPlanes)
+			{
+				for(auto width : widths)
+				{
+					if(!compare(packer, numPlanes, width, gen))
+					{
+						fprintf(stderr, "Highway target %s\n", hwy::TargetName(target));
+						rc = EXIT_FAILURE;
+					}
+				}
+			}
+		}
+	}
+	hwy::SetSupportedTargetsForTest(0);
+	if(rc == EXIT_SUCCESS)
+		printf("Interleavers match for %u Highway targets\n", numTargets);
+
+	return rc;
+}
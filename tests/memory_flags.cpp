@@ -0,0 +1,90 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compress and decompress an image whose buffers are large enough to use
+ * huge pages and NUMA interleaving, and check that the image round trips losslessly.
+ * Memory flags are hints : on systems without support, allocation falls back
+ * to default policies.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "GrkTestCodec.h"
+
+static bool roundTrip(uint32_t flags)
+{
+	bool rc = false;
+	grk_codec* codec = nullptr;
+	grk_image* image = nullptr;
+	grk_image* reference = nullptr;
+	grk_header_info headerInfo;
+	grk_decompress_parameters parameters;
+	grk_cparameters compressParameters;
+	std::vector<uint8_t> codeStream;
+
+	grk_set_memory_flags(flags);
+	// each component buffer exceeds the 2 MiB huge page size
+	image = grk::createTestImage(1024, 768, 3, 8);
+	reference = grk::createTestImage(1024, 768, 3, 8);
+	if(!image || !reference)
+		goto cleanup;
+	grk_compress_set_default_params(&compressParameters);
+	compressParameters.cod_format = GRK_FMT_J2K;
+	if(!grk::compressToBuffer(&compressParameters, image, codeStream))
+		goto cleanup;
+
+	grk_decompress_set_default_params(&parameters);
+	codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		goto cleanup;
+	if(!grk_decompress(codec, nullptr))
+	{
+		fprintf(stderr, "Failed to decompress with memory flags 0x%x\n", flags);
+		goto cleanup;
+	}
+	rc = grk::compareToReference(reference, grk_decompress_get_composited_image(codec));
+	if(!rc)
+		fprintf(stderr, "Image differs with memory flags 0x%x\n", flags);
+cleanup:
+	grk_object_unref(codec);
+	if(image)
+		grk_object_unref(&image->obj);
+	if(reference)
+		grk_object_unref(&reference->obj);
+	grk_set_memory_flags(0);
+
+	return rc;
+}
+
+int main(void)
+{
+	const uint32_t flags[] = {GRK_MEMORY_HUGE_PAGES, GRK_MEMORY_NUMA_INTERLEAVE,
+							  GRK_MEMORY_HUGE_PAGES | GRK_MEMORY_NUMA_INTERLEAVE};
+	int rc = EXIT_SUCCESS;
+
+	grk::initTestLibrary();
+	for(auto f : flags)
+	{
+		if(!roundTrip(f))
+			rc = EXIT_FAILURE;
+	}
+	grk_deinitialize();
+
+	return rc;
+}
@@ -0,0 +1,127 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Decompress tiles with the LRU tile cache, and check that repeated tile requests
+ * are served from the cache, and that the cache respects its byte budget.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "GrkTestCodec.h"
+
+static bool checkStats(grk_codec* codec, uint64_t hits, uint64_t misses, uint64_t minEvictions)
+{
+	grk_tile_cache_stats stats;
+	if(!grk_decompress_get_tile_cache_stats(codec, &stats))
+	{
+		fprintf(stderr, "Failed to get tile cache stats\n");
+		return false;
+	}
+	if(stats.hits != hits || stats.misses != misses || stats.evictions < minEvictions)
+	{
+		fprintf(stderr,
+				"Tile cache stats: hits=%llu misses=%llu evictions=%llu; "
+				"expected hits=%llu misses=%llu evictions>=%llu\n",
+				(unsigned long long)stats.hits, (unsigned long long)stats.misses,
+				(unsigned long long)stats.evictions, (unsigned long long)hits,
+				(unsigned long long)misses, (unsigned long long)minEvictions);
+		return false;
+	}
+
+	return true;
+}
+
+static bool decompressTile(grk_codec* codec, uint16_t tileIndex, grk_image* reference)
+{
+	if(!grk_decompress_tile(codec, tileIndex))
+	{
+		fprintf(stderr, "Failed to decompress tile %u\n", tileIndex);
+		return false;
+	}
+
+	return grk::compareToReference(reference, grk_decompress_get_composited_image(codec));
+}
+
+int main(void)
+{
+	int rc = EXIT_FAILURE;
+	grk_codec* codec = nullptr;
+	grk_image* image = nullptr;
+	grk_header_info headerInfo;
+	grk_decompress_parameters parameters;
+	grk_cparameters compressParameters;
+	std::vector<uint8_t> codeStream;
+
+	grk::initTestLibrary();
+	image = grk::createTestImage(256, 192, 3, 8);
+	if(!image)
+		goto cleanup;
+	grk_compress_set_default_params(&compressParameters);
+	compressParameters.cod_format = GRK_FMT_J2K;
+	compressParameters.tile_size_on = true;
+	compressParameters.t_width = 64;
+	compressParameters.t_height = 64;
+	compressParameters.numresolution = 4;
+	if(!grk::compressToBuffer(&compressParameters, image, codeStream))
+		goto cleanup;
+	grk_object_unref(&image->obj);
+	image = grk::createTestImage(256, 192, 3, 8);
+	if(!image)
+		goto cleanup;
+
+	// unbounded cache : second request for a tile is a hit
+	grk_decompress_set_default_params(&parameters);
+	parameters.core.tileCacheStrategy = GRK_TILE_CACHE_LRU;
+	codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		goto cleanup;
+	if(!decompressTile(codec, 5, image) || !checkStats(codec, 0, 1, 0))
+		goto cleanup;
+	if(!decompressTile(codec, 5, image) || !checkStats(codec, 1, 1, 0))
+		goto cleanup;
+	if(!decompressTile(codec, 6, image) || !checkStats(codec, 1, 2, 0))
+		goto cleanup;
+	if(!decompressTile(codec, 5, image) || !checkStats(codec, 2, 2, 0))
+		goto cleanup;
+	if(!decompressTile(codec, 6, image) || !checkStats(codec, 3, 2, 0))
+		goto cleanup;
+	grk_object_unref(codec);
+
+	// one byte budget : only the most recently decompressed tile is retained
+	parameters.core.tileCacheMaxBytes = 1;
+	codec = grk::initDecompressor(codeStream, &parameters.core, &headerInfo);
+	if(!codec)
+		goto cleanup;
+	if(!decompressTile(codec, 0, image) || !decompressTile(codec, 1, image) ||
+	   !checkStats(codec, 0, 2, 1))
+		goto cleanup;
+	if(!decompressTile(codec, 1, image) || !checkStats(codec, 1, 2, 1))
+		goto cleanup;
+	if(!decompressTile(codec, 0, image) || !checkStats(codec, 1, 3, 2))
+		goto cleanup;
+
+	rc = EXIT_SUCCESS;
+cleanup:
+	grk_object_unref(codec);
+	if(image)
+		grk_object_unref(&image->obj);
+	grk_deinitialize();
+
+	return rc;
+}